@@ -17,6 +17,7 @@
 #include <iostream>
 #include <functional>
 #include <string>
+#include "sv_ui_shadercache.h"
 
 std::string loadShaderSource(const std::string& filePath) {
 	std::ifstream shaderFile;
@@ -57,28 +58,29 @@ GLuint compileShader(GLenum type, const std::string& source) {
 }
 
 
+// Reuses a linked binary from SV_UI's shader cache when the sources and driver match
 GLuint createShaderProgram(const std::string& vertexShaderSource, const std::string& fragmentShaderSource) {
-    GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexShaderSource);
-    GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentShaderSource);
+    return SV_UI::linkCachedProgram({ vertexShaderSource.c_str(), fragmentShaderSource.c_str() }, [&](GLuint shaderProgram) {
+        GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexShaderSource);
+        GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentShaderSource);
 
-    // Link shaders
-    GLuint shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
+        // Link shaders
+        glAttachShader(shaderProgram, vertexShader);
+        glAttachShader(shaderProgram, fragmentShader);
+        glLinkProgram(shaderProgram);
 
-    // Check for linking errors
-    GLint success;
-    GLchar infoLog[512];
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(shaderProgram, 512, nullptr, infoLog);
-        std::cerr << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-    }
-
-    // Delete the shaders as they're linked into our program now and no longer necessary
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+        // Check for linking errors
+        GLint success;
+        GLchar infoLog[512];
+        glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+        if (!success) {
+            glGetProgramInfoLog(shaderProgram, 512, nullptr, infoLog);
+            std::cerr << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+        }
 
-    return shaderProgram;
+        // Delete the shaders as they're linked into our program now and no longer necessary
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        return success == GL_TRUE;
+    });
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include <iostream>
 #include "sv_ui3.0.h"
+#include "sv_ui_immediate.h"
 
 const int SCREEN_WIDTH = 1800;
 const int SCREEN_HEIGHT = 900;
@@ -68,43 +69,13 @@ void debugOpenGL() {
 }
 
 GLuint loadTexture(const char* path) {
-    SDL_Surface* surface = IMG_Load(path); // Use IMG_Load instead of SDL_LoadBMP
-    if (!surface) {
-        std::cerr << "Failed to load texture: " << IMG_GetError() << std::endl; // Use IMG_GetError for error reporting
+    // Decoded once into the cooked texture cache, then mapped and uploaded with its mipmaps
+    SV_UI::TextureInfo loaded = SV_UI::loadUITexture(path);
+    if (!loaded.texture) {
         return 0;
     }
-
-    GLuint texture;
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-
-    // Determine the format of the image
-    GLenum format;
-    if (surface->format->BytesPerPixel == 4) {
-        format = surface->format->Rmask == 0x000000ff ? GL_RGBA : GL_BGRA;
-    }
-    else {
-        format = surface->format->Rmask == 0x000000ff ? GL_RGB : GL_BGR;
-    }
-
-    glTexImage2D(GL_TEXTURE_2D, 0, format == GL_RGBA ? GL_RGBA : GL_RGB, surface->w, surface->h, 0, format, GL_UNSIGNED_BYTE, surface->pixels);
-
-    // Generate mipmaps
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    // Set texture filtering parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR); // Use mipmaps for minification
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // Set texture wrapping parameters (optional, but good to check)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); // Changed to GL_CLAMP_TO_EDGE for better edge handling
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-    glBindTexture(GL_TEXTURE_2D, 0);
-
-    SDL_FreeSurface(surface);
     std::cout << "Texture loaded successfully from " << path << std::endl;
-    return texture;
+    return loaded.texture;
 }
 
 
@@ -137,6 +108,7 @@ int main(int argc, char* argv[]) {
         };
     // Create some widgets
     SV_UI::createWidget(1, 0, 0, 400, 400, SV_UI::WidgetOptions::WIDGET_DRAGGABLE, "metalPanel_green.png");
+    SV_UI::setLayout(SV_UI::LayoutDirection::Vertical, 10.0f, 8.0f);
     SV_UI::Text("Hello World",2.0f);
    // SV_UI::Button("Click me", 1.0f, "", buttonClickCallback, 75, 30, SV_UI::Alignment::BottomCenter);
     
@@ -150,25 +122,46 @@ int main(int argc, char* argv[]) {
     SV_UI::endWidget();
     SV_UI::createWidget(2, 400, 100, 200, 150, SV_UI::WidgetOptions::WIDGET_DRAGGABLE, "metalPane3l_green.png");
     SV_UI::endWidget();
-    bool quit = false;
-    SDL_Event event;
-
-    while (!quit) {
-        while (SDL_PollEvent(&event) != 0) {
-            if (event.type == SDL_QUIT) {
-                quit = true;
+    bool showListBox = true;
+    const char* debugItems[] = { "Widgets", "Textures", "Shaders" };
+    int debugSelection = 0;
+
+    // Only renders after input or a state change; sleeps while the UI is idle
+    SV_UI::runUI(window,
+        [](SDL_Event& event) {
+            SV_UI::IM::handleEvent(&event);
+            return true;
+        },
+        [&]() {
+            glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            SV_UI::renderUI();
+
+            // Immediate-mode debug window, rebuilt every frame
+            SV_UI::IM::beginFrame();
+            if (SV_UI::IM::Begin("Debug", 700, 100, 300, 220, SV_UI::WidgetOptions::WIDGET_DRAGGABLE)) {
+                SV_UI::IM::Text("Immediate mode");
+                const SV_UI::FrameStats& stats = SV_UI::frameStats;
+                std::string statsLine = std::to_string(stats.widgets) + " widgets, " + std::to_string(stats.widgetsOccluded + stats.componentsOccluded) +
+                    " occluded, " + std::to_string(stats.culled) + " culled";
+                SV_UI::IM::Text(statsLine.c_str());
+                if (SV_UI::IM::Button("Click me")) {
+                    std::cout << "Button Clicked!" << std::endl;
+                }
+                SV_UI::IM::SameLine();
+                SV_UI::IM::Checkbox("Show list", &showListBox);
+                if (showListBox) {
+                    SV_UI::IM::ListBox("Inspect", debugItems, 3, &debugSelection, 200.0f, 4);
+                }
+                SV_UI::IM::End();
             }
-            SV_UI::handleEvents(&event);
-        }
-
-        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-
-        SV_UI::renderUI();
-
-        SDL_GL_SwapWindow(window);
-    }
+            SV_UI::IM::endFrame();
+        });
    
+    SV_UI::IM::shutdown();
+    SV_UI::releaseUITexture(texture);
+    SV_UI::shutdownUI(); // Frees the widgets and prints anything that leaked
     closeSDL(window, context);
     return 0;
 }
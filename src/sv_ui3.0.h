@@ -14,35 +14,217 @@
 #include <iostream>
 #include <functional>
 #include <string>
+#include <string_view>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 #define GLT_IMPLEMENTATION
 #include "gltext.h"
 #include "sv_ui_styles.h"
+#include "sv_ui_shadercache.h"
 #include "sv_ui_utilities.h"
+#include "sv_ui_parallel.h"
+#include "sv_ui_animation.h"
+#include "sv_ui_memory.h"
+#include "sv_ui_texturecache.h"
 
 namespace SV_UI {
    
     
-    GLuint shaderProgram;
-    GLuint VAO, VBO, EBO;
-    glm::mat4 projection; // Declaration without initialization
+    // Per-window state lives in a UIContext and is reached through accessors such as currentUIManager(),
+    // which resolve the context current on the calling thread. The former global names (uiManager,
+    // frameStats, ...) still exist and refer to the default context. See UI CONTEXTS at the end of this file.
+    struct UIContext;
+    thread_local UIContext* currentUIContext = nullptr; // nullptr selects the process's default context
+
+    // Make a context current on this thread until the end of the scope
+    struct ContextScope {
+        UIContext* previous;
+        explicit ContextScope(UIContext* context) : previous(currentUIContext) {
+            currentUIContext = context;
+        }
+        ~ContextScope() {
+            currentUIContext = previous;
+        }
+    };
+
+    UIContext& ui(); // The context current on this thread
+
+    GLuint& currentShaderProgram();
+    GLuint& currentVAO();
+    GLuint& currentVBO();
+    GLuint& currentEBO();
+    glm::mat4& currentProjection();
+    int& currentViewportWidth(); // Anything outside is culled; 0 until setProjectionMatrix()
+    int& currentViewportHeight();
+
+    // glText keeps one program, font texture and vertex scratch buffer per process, so its calls
+    // are serialized across contexts and it is initialized by the first context only
+    std::mutex glTextMutex;
+    int glTextUsers = 0;
+
+    // gltSetText() rebuilds glyphs in glText's shared scratch buffer
+    void setGLText(GLTtext* text, const char* string) {
+        std::lock_guard<std::mutex> lock(glTextMutex);
+        gltSetText(text, string);
+    }
+
+    // glText lays a text out as its glyphs side by side, so widths are sums of per-byte advances.
+    // initOpenGL() measures the table on the GL thread; after that widths need no GL, so layout
+    // and update() can measure text on the pipeline's worker.
+    uint32_t glyphAdvanceTable[256] = {};
+    std::atomic<bool> glyphAdvancesMeasured{ false };
+
+    const uint32_t* glyphAdvances() {
+        if (!glyphAdvancesMeasured.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(glTextMutex);
+            if (!glyphAdvancesMeasured.load(std::memory_order_relaxed)) {
+                GLTtext* measure = gltCreateText();
+                char glyph[2] = {};
+                for (int c = 1; c < 256; ++c) {
+                    glyph[0] = static_cast<char>(c);
+                    gltSetText(measure, glyph);
+                    glyphAdvanceTable[c] = static_cast<uint32_t>(std::lround(gltGetTextWidth(measure, 1.0f)));
+                }
+                gltDeleteText(measure);
+                glyphAdvanceTable[static_cast<unsigned char>('\n')] = 0;
+                glyphAdvancesMeasured.store(true, std::memory_order_release);
+            }
+        }
+        return glyphAdvanceTable;
+    }
+
+    // Width of the widest line of text, as gltGetTextWidth() would give once the glyphs are set
+    float textWidth(std::string_view text, float scale) {
+        const uint32_t* advance = glyphAdvances();
+        uint32_t line = 0, widest = 0;
+        for (char c : text) {
+            if (c == '\n') {
+                widest = std::max(widest, line);
+                line = 0;
+            }
+            else {
+                line += advance[static_cast<unsigned char>(c)];
+            }
+        }
+        return std::max(widest, line) * scale;
+    }
 
     void setProjectionMatrix(int screenWidth, int screenHeight) {
-        projection = glm::ortho(0.0f, static_cast<float>(screenWidth), static_cast<float>(screenHeight), 0.0f, -1.0f, 1.0f);
+        currentProjection() = glm::ortho(0.0f, static_cast<float>(screenWidth), static_cast<float>(screenHeight), 0.0f, -1.0f, 1.0f);
+        currentViewportWidth() = screenWidth;
+        currentViewportHeight() = screenHeight;
     }
    
 
     struct Widget; // Forward declaration
     struct TextRenderer; // Ensure this is forward-declared if its full definition comes later
     struct TextComponent;
+    struct UIComponent;
+    struct DrawList;
+    void cancelAnimations(const void* object); // Defined in the ANIMATION section
+    void releaseHandleSlot(uint32_t slot); // Defined in the HANDLES section
+    void unbindComponent(UIComponent* component); // Defined in the BINDINGS section
+    void cancelGLSync(UIComponent* component); // Defined after UIManager
+
     struct UIComponent {
         float x = 0.0f, y = 0.0f; // Initialized
         int width = 0, height = 0; // Initialized
         Widget* parent = nullptr;
+        UIComponent* parentComponent = nullptr; // Enclosing stack, nullptr when placed directly in the widget
+        Alignment alignment = Alignment::TopLeft; // Placement inside the slot the parent's layout assigns
+        float flex = 0.0f; // Share of leftover space along a stack's direction, 0 keeps the measured size
+        StyleComponent styleType = StyleComponent::Text; // Row of the theme table this component draws with
+        uint16_t styleClass = 0; // Interned by setStyleClass(), 0 is the default class
+        bool visible = true; // Hidden components keep their layout slot but are not drawn or hit
+        uint32_t handleSlot = 0; // Entry in the handle table once handleOf() was called, 0 before
+        bool glSyncQueued = false; // Waiting for syncGL(), see requestGLSync()
+
+        // Cached layout results, only recomputed when invalidated
+        bool measureDirty = true; // Intrinsic size changed (text, fixed size, children)
+        bool layoutDirty = true;  // This component or something below it must be placed again
+        float measuredWidth = 0.0f, measuredHeight = 0.0f;
+        float slotX = 0.0f, slotY = 0.0f, slotWidth = -1.0f, slotHeight = -1.0f; // Last rect assigned by the parent
+
+        virtual ~UIComponent() {
+            cancelAnimations(this);
+            releaseHandleSlot(handleSlot);
+            unbindComponent(this);
+            cancelGLSync(this);
+        }
         virtual void Draw() = 0;
         virtual void handleEvents(SDL_Event* event) = 0;
+
+        // Per-frame logic (scrolling, what to show, cached measurements), run before recording:
+        // by renderUI() on the GL thread, or on PipelinedRenderer's worker. Must not call GL;
+        // what the GL side has to do for it goes in syncGL(), queued with requestGLSync().
+        virtual void update(float dt) {}
+
+        // GL side of update(): create glText objects, set glyph strings, upload textures. Runs on
+        // the GL thread after update() and before the frame recorded after it is submitted.
+        virtual void syncGL() {}
+
+        // Append this component's draw commands. Must only read component state, since it may
+        // run on a worker thread (see PipelinedRenderer). The default defers to Draw() at submit.
+        virtual void record(DrawList& list);
         virtual void updatePosition(float deltaX, float deltaY) {
             x += deltaX;
             y += deltaY;
+            slotX += deltaX;
+            slotY += deltaY;
+        }
+
+        // Preferred size of the component; called only when measureDirty is set
+        virtual void measure(float& outWidth, float& outHeight) {
+            outWidth = static_cast<float>(width);
+            outHeight = static_cast<float>(height);
+        }
+
+        // The field measure() reports as the preferred width or height, which animateSizeTo()
+        // drives; nullptr when the size follows the content
+        virtual int* sizeField(bool horizontal) {
+            return horizontal ? &width : &height;
+        }
+
+        // Called after x, y, width and height were assigned, to place anything the component owns
+        virtual void arrange() {}
+
+        // True to be handed every press, even where it cannot be seen; a focused text box needs
+        // the press that takes its focus away
+        virtual bool wantsEveryPress() const {
+            return false;
+        }
+
+        void invalidateMeasure();
+        void invalidateLayout();
+
+        void setVisible(bool show) {
+            if (show != visible) {
+                visible = show;
+                requestRedraw();
+            }
+        }
+
+        // Draw with the rules of a named class ("danger", "toolbar") in addition to the defaults
+        void setStyleClass(const std::string& name) {
+            styleClass = internStyleClass(name);
+            requestRedraw();
+        }
+
+        const ResolvedStyle& style(StyleState state = StyleState::Normal) const {
+            return currentActiveTheme()->lookup(styleClass, styleType, state);
+        }
+
+        // Parts drawn with another table row, e.g. a list's rows and scrollbar
+        const ResolvedStyle& style(StyleComponent part, StyleState state) const {
+            return currentActiveTheme()->lookup(styleClass, part, state);
         }
     };
 
@@ -60,25 +242,231 @@ namespace SV_UI {
         bool resizingLeft = false, resizingRight = false, resizingTop = false, resizingBottom = false;
         std::vector<UIComponent*> components;
         DraggableComponent* draggableComponent = nullptr;
-        TextComponent* textComponent = nullptr;
+        LayoutParams layout;
+        bool layoutDirty = true;
+        uint16_t styleClass = 0;
+        bool textureOpaque = false; // The texture has no transparent pixels, so it hides what is below
+        bool visible = true; // Hidden widgets are skipped by drawing, occlusion and pointer events
+        uint32_t handleSlot = 0;
+
+        Widget() {
+            countObject("Widget", 1);
+        }
 
         ~Widget() {
-            delete textComponent;
+            cancelAnimations(this);
             // Remember to delete components in the vector to avoid memory leaks
             for (auto& component : components) {
                 delete component;
             }
+            delete draggableComponent;
+            releaseUITexture(texture);
+            releaseHandleSlot(handleSlot);
+            countObject("Widget", -1);
         }
     };
 
+    struct StackComponent;
+
     struct UIManager {
         std::vector<Widget*> widgets;
         Widget* currentWidget = nullptr; // Track the current widget context
+        std::vector<StackComponent*> stackStack; // Open beginStack() calls inside the current widget
         bool isCreatingWidget = false;
+        Uint32 lastUpdateTicks = 0; // SDL_GetTicks() of the previous prepareFrame()
+        std::vector<UIComponent*> glSyncQueue; // Components whose syncGL() runs next, in request order
     };
 
-    // Global UIManager instance
-    UIManager uiManager;
+    UIManager& currentUIManager();
+
+    // Run component.syncGL() on the GL thread before the next submit; safe to call from update()
+    void requestGLSync(UIComponent& component) {
+        if (!component.glSyncQueued) {
+            component.glSyncQueued = true;
+            currentUIManager().glSyncQueue.push_back(&component);
+        }
+    }
+
+    void cancelGLSync(UIComponent* component) {
+        if (component->glSyncQueued) {
+            std::vector<UIComponent*>& queue = currentUIManager().glSyncQueue;
+            queue.erase(std::remove(queue.begin(), queue.end(), component), queue.end());
+        }
+    }
+
+    // GL thread: run the queued syncGL() calls. Called between prepareFrame() and the submit.
+    void syncComponentsGL() {
+        std::vector<UIComponent*>& queue = currentUIManager().glSyncQueue;
+        for (size_t i = 0; i < queue.size(); ++i) {
+            queue[i]->glSyncQueued = false;
+            queue[i]->syncGL();
+        }
+        queue.clear();
+    }
+
+    // Set whenever something visible changed; runUI() clears it before rendering a frame
+    // and sleeps in SDL_WaitEventTimeout while it stays clear.
+    std::atomic<bool>& currentRedrawRequested();
+
+    // Call from the UI thread after changing anything that is drawn
+    void requestRedraw() {
+        currentRedrawRequested().store(true, std::memory_order_relaxed);
+    }
+
+    bool wakeRoutedContext(UIContext& context); // Defined in the UI CONTEXTS section
+
+    // Thread-safe variant for background work (e.g. a finished texture load); also wakes runUI(),
+    // or runRoutedUI() for a context whose events are routed. The wake event carries the context
+    // in user.data1.
+    void requestRedrawAsync() {
+        static const Uint32 wakeEventType = SDL_RegisterEvents(1);
+        if (!currentRedrawRequested().exchange(true) && !wakeRoutedContext(ui()) && wakeEventType != static_cast<Uint32>(-1)) {
+            SDL_Event wake{};
+            wake.type = wakeEventType;
+            wake.user.data1 = &ui();
+            SDL_PushEvent(&wake);
+        }
+    }
+
+    // For threads that have no context current, e.g. a producer feeding a component of context
+    void requestRedrawAsync(UIContext& context) {
+        ContextScope scope(&context);
+        requestRedrawAsync();
+    }
+
+    // Mark the component's size as changed. Propagates up, since every enclosing
+    // stack measures itself from its children; stops at the first ancestor already dirty.
+    void UIComponent::invalidateMeasure() {
+        requestRedraw();
+        if (measureDirty) {
+            return;
+        }
+        measureDirty = true;
+        layoutDirty = true;
+        if (parentComponent) {
+            parentComponent->invalidateMeasure();
+        }
+        else if (parent) {
+            parent->layoutDirty = true;
+        }
+    }
+
+    // Mark the component for re-placement without changing its size. Ancestors are
+    // only flagged so the layout pass walks down to it; their own slots are kept.
+    void UIComponent::invalidateLayout() {
+        requestRedraw();
+        layoutDirty = true;
+        for (UIComponent* c = parentComponent; c && !c->layoutDirty; c = c->parentComponent) {
+            c->layoutDirty = true;
+        }
+        if (parent) {
+            parent->layoutDirty = true;
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////LAYOUT/////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////////
+    // Layout runs once before drawing (layoutUI) and is cached per component.
+    // A widget whose layoutDirty flag is clear costs a single branch. Inside a
+    // dirty widget, children whose slot did not move and that are not dirty
+    // themselves are skipped, so a change only re-places the affected subtree.
+
+    void measureComponent(UIComponent& component) {
+        if (component.measureDirty) {
+            component.measure(component.measuredWidth, component.measuredHeight);
+            component.measureDirty = false;
+        }
+    }
+
+    // Assign a slot to the component and place it inside according to its alignment.
+    // stretchX/stretchY make the component fill the slot along that axis (flex children).
+    void placeComponent(UIComponent& component, float slotX, float slotY, float slotWidth, float slotHeight, bool stretchX, bool stretchY) {
+        bool slotChanged = slotX != component.slotX || slotY != component.slotY ||
+            slotWidth != component.slotWidth || slotHeight != component.slotHeight;
+        if (!slotChanged && !component.layoutDirty) {
+            return;
+        }
+        component.slotX = slotX;
+        component.slotY = slotY;
+        component.slotWidth = slotWidth;
+        component.slotHeight = slotHeight;
+
+        component.width = static_cast<int>(stretchX ? slotWidth : component.measuredWidth);
+        component.height = static_cast<int>(stretchY ? slotHeight : component.measuredHeight);
+        float offsetX = 0.0f, offsetY = 0.0f;
+        calculatePositionForAlignment(offsetX, offsetY, component.width, component.height,
+            static_cast<int>(slotWidth), static_cast<int>(slotHeight), component.alignment);
+        component.x = slotX + offsetX;
+        component.y = slotY + offsetY;
+
+        component.arrange();
+        component.layoutDirty = false;
+    }
+
+    // Preferred size of a set of children laid out with params, padding included
+    void measureChildren(const std::vector<UIComponent*>& children, const LayoutParams& params, float& outWidth, float& outHeight) {
+        float mainSize = 0.0f, crossSize = 0.0f;
+        bool vertical = params.direction == LayoutDirection::Vertical;
+        for (UIComponent* child : children) {
+            measureComponent(*child);
+            float childMain = vertical ? child->measuredHeight : child->measuredWidth;
+            float childCross = vertical ? child->measuredWidth : child->measuredHeight;
+            if (params.direction == LayoutDirection::Overlay) {
+                mainSize = child->measuredWidth > mainSize ? child->measuredWidth : mainSize;
+                crossSize = child->measuredHeight > crossSize ? child->measuredHeight : crossSize;
+            }
+            else {
+                mainSize += childMain;
+                crossSize = childCross > crossSize ? childCross : crossSize;
+            }
+        }
+        if (params.direction != LayoutDirection::Overlay && children.size() > 1) {
+            mainSize += params.spacing * (children.size() - 1);
+        }
+        outWidth = (vertical ? crossSize : mainSize) + 2.0f * params.padding;
+        outHeight = (vertical ? mainSize : crossSize) + 2.0f * params.padding;
+    }
+
+    // Place children inside the given rect
+    void arrangeChildren(const std::vector<UIComponent*>& children, const LayoutParams& params, float x, float y, float width, float height) {
+        float innerX = x + params.padding, innerY = y + params.padding;
+        float innerWidth = width - 2.0f * params.padding, innerHeight = height - 2.0f * params.padding;
+
+        if (params.direction == LayoutDirection::Overlay) {
+            for (UIComponent* child : children) {
+                measureComponent(*child);
+                placeComponent(*child, innerX, innerY, innerWidth, innerHeight, false, false);
+            }
+            return;
+        }
+
+        bool vertical = params.direction == LayoutDirection::Vertical;
+        float used = 0.0f, flexTotal = 0.0f;
+        for (UIComponent* child : children) {
+            measureComponent(*child);
+            used += vertical ? child->measuredHeight : child->measuredWidth;
+            flexTotal += child->flex > 0.0f ? child->flex : 0.0f;
+        }
+        if (children.size() > 1) {
+            used += params.spacing * (children.size() - 1);
+        }
+        float leftover = (vertical ? innerHeight : innerWidth) - used;
+        if (leftover < 0.0f) leftover = 0.0f;
+
+        float cursor = vertical ? innerY : innerX;
+        for (UIComponent* child : children) {
+            bool flexible = child->flex > 0.0f && flexTotal > 0.0f;
+            float mainSize = (vertical ? child->measuredHeight : child->measuredWidth) + (flexible ? leftover * child->flex / flexTotal : 0.0f);
+            if (vertical) {
+                placeComponent(*child, innerX, cursor, innerWidth, mainSize, false, flexible);
+            }
+            else {
+                placeComponent(*child, cursor, innerY, mainSize, innerHeight, flexible, false);
+            }
+            cursor += mainSize + params.spacing;
+        }
+    }
 
     // Flags for widget options
     enum WidgetOptions {
@@ -106,6 +494,22 @@ namespace SV_UI {
     }
 
     // Functions for DraggableComponent
+    // Move a widget and translate its laid-out components with it; no relayout is needed
+    void moveWidget(Widget& widget, int newX, int newY) {
+        int deltaX = newX - widget.x;
+        int deltaY = newY - widget.y;
+        if (!deltaX && !deltaY) {
+            return;
+        }
+        widget.x = newX;
+        widget.y = newY;
+        // Update positions of all components relative to the new widget position
+        for (auto component : widget.components) {
+            component->updatePosition(static_cast<float>(deltaX), static_cast<float>(deltaY));
+        }
+        requestRedraw();
+    }
+
     void handleDrag(DraggableComponent& draggable, SDL_Event* event) {
         Widget& parent = *draggable.parent;
 
@@ -125,16 +529,7 @@ namespace SV_UI {
         else if (event->type == SDL_MOUSEMOTION && draggable.isDragging) {
             int mouseX = event->motion.x;
             int mouseY = event->motion.y;
-            // Calculate the delta movement
-            int deltaX = mouseX - draggable.offsetX - parent.x;
-            int deltaY = mouseY - draggable.offsetY - parent.y;
-            // Update widget position
-            parent.x = mouseX - draggable.offsetX;
-            parent.y = mouseY - draggable.offsetY;
-            // Update positions of all components relative to the new widget position
-            for (auto component : parent.components) {
-                component->updatePosition(deltaX, deltaY);
-            }
+            moveWidget(parent, mouseX - draggable.offsetX, mouseY - draggable.offsetY);
         }
     }
 
@@ -157,28 +552,31 @@ namespace SV_UI {
         return shader;
     }
 
+    // Linked programs are reused from the on-disk cache when possible (sv_ui_shadercache.h)
     GLuint createShaderProgram(const char* vertexSource, const char* fragmentSource) {
-        GLuint vertexShader = compileShader(vertexSource, GL_VERTEX_SHADER);
-        GLuint fragmentShader = compileShader(fragmentSource, GL_FRAGMENT_SHADER);
-
-        GLuint shaderProgram = glCreateProgram();
-        glAttachShader(shaderProgram, vertexShader);
-        glAttachShader(shaderProgram, fragmentShader);
-        glLinkProgram(shaderProgram);
+        GLuint program = linkCachedProgram({ vertexSource, fragmentSource }, [&](GLuint program) {
+            GLuint vertexShader = compileShader(vertexSource, GL_VERTEX_SHADER);
+            GLuint fragmentShader = compileShader(fragmentSource, GL_FRAGMENT_SHADER);
+            glAttachShader(program, vertexShader);
+            glAttachShader(program, fragmentShader);
+            glLinkProgram(program);
+            glDeleteShader(vertexShader);
+            glDeleteShader(fragmentShader);
+            GLint linked;
+            glGetProgramiv(program, GL_LINK_STATUS, &linked);
+            return linked == GL_TRUE;
+        });
 
         GLint success;
-        glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
         if (!success) {
             char infoLog[512];
-            glGetProgramInfoLog(shaderProgram, 512, nullptr, infoLog);
+            glGetProgramInfoLog(program, 512, nullptr, infoLog);
             std::cerr << "Shader linking failed: " << infoLog << std::endl;
+            glDeleteProgram(program);
             return 0;
         }
-
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
-
-        return shaderProgram;
+        return program;
     }
 
     // Vertex and Fragment shader sources
@@ -216,532 +614,3323 @@ namespace SV_UI {
     }
 )";
 
-    // Initialize shader program and VAO, VBO
-   
+    ///////////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////DRAW LISTS//////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////////
+    // A draw list is a flat, reusable buffer of batched geometry plus an ordered list
+    // of commands. Recording never touches GL; submitDrawList() uploads and draws it.
+    // clear() keeps the capacity of every buffer, so once a frame has been recorded
+    // once, recording the same frame again does not allocate.
+
+    // Plain textured or colored quads (rects, lines, images): 20 bytes
+    struct DrawVertex {
+        float x, y;
+        float u, v;
+        uint32_t color;
+    };
 
-    void initOpenGL() {
-        glewInit();
+    // Vertices of SDF shapes (addRoundedRect, addShadow) also carry the shape, which the
+    // fragment shader evaluates per pixel. They are kept apart from DrawVertex so plain
+    // quads, most of any frame, do not pay for these fields.
+    struct ShapeVertex {
+        float x, y;
+        uint32_t color;       // Fill color
+        float localX, localY; // Position relative to the shape's center
+        float halfWidth, halfHeight;
+        float radius;         // Corner radius
+        float borderWidth;    // Drawn inside the shape's edge
+        uint32_t borderColor;
+        float softness;       // Width of the edge falloff: 1 is anti-aliasing, more blurs (shadows)
+    };
 
-        shaderProgram = createShaderProgram(vertexShaderSource, fragmentShaderSource);
-        gltInit();
-        float vertices[] = {
-            // positions    // texture coords
-            0.0f,  1.0f,    0.0f, 1.0f,
-            1.0f,  1.0f,    1.0f, 1.0f,
-            1.0f,  0.0f,    1.0f, 0.0f,
-            0.0f,  0.0f,    0.0f, 0.0f
-        };
-        unsigned int indices[] = {
-            0, 1, 2,
-            2, 3, 0
-        };
+    enum class DrawCmdType : uint8_t {
+        Triangles,
+        Shapes,   // Indexes shapeVertices through shapeIndices, always untextured
+        Text,
+        Callback // Calls UIComponent::Draw() on the GL thread, for components that do not record()
+    };
 
-        glGenVertexArrays(1, &VAO);
-        glGenBuffers(1, &VBO);
-        glGenBuffers(1, &EBO);
+    const uint32_t NO_TEXT = 0xffffffffu; // Text command that draws its GLTtext as it is
 
-        glBindVertexArray(VAO);
+    // Scissor rectangle in window coordinates (top-left origin)
+    struct ClipRect {
+        float x = 0.0f, y = 0.0f, width = 0.0f, height = 0.0f;
+        bool enabled = false;
 
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        bool operator==(const ClipRect& other) const {
+            return enabled == other.enabled && (!enabled ||
+                (x == other.x && y == other.y && width == other.width && height == other.height));
+        }
+        bool operator!=(const ClipRect& other) const {
+            return !(*this == other);
+        }
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+        // A disabled clip is unbounded
+        bool intersects(float rx, float ry, float rw, float rh) const {
+            return !enabled || (rx < x + width && rx + rw > x && ry < y + height && ry + rh > y);
+        }
 
-        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-        glEnableVertexAttribArray(0);
+        bool contains(float rx, float ry, float rw, float rh) const {
+            return !enabled || (rx >= x && ry >= y && rx + rw <= x + width && ry + rh <= y + height);
+        }
 
-        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-        glEnableVertexAttribArray(1);
-       
-       
-    
+        ClipRect intersection(float rx, float ry, float rw, float rh) const {
+            ClipRect result;
+            result.enabled = true;
+            result.x = enabled ? std::max(x, rx) : rx;
+            result.y = enabled ? std::max(y, ry) : ry;
+            float right = enabled ? std::min(x + width, rx + rw) : rx + rw;
+            float bottom = enabled ? std::min(y + height, ry + rh) : ry + rh;
+            result.width = std::max(0.0f, right - result.x);
+            result.height = std::max(0.0f, bottom - result.y);
+            return result;
+        }
+    };
+
+    // The window, as a clip; disabled (unbounded) until setProjectionMatrix() was called
+    ClipRect viewportClip() {
+        ClipRect view;
+        view.enabled = currentViewportWidth() > 0 && currentViewportHeight() > 0;
+        view.width = static_cast<float>(currentViewportWidth());
+        view.height = static_cast<float>(currentViewportHeight());
+        return view;
     }
 
+    struct DrawCmd {
+        DrawCmdType type = DrawCmdType::Triangles;
+        GLuint texture = 0; // 0 draws with the white texture
+        uint32_t firstIndex = 0, indexCount = 0;
+        ClipRect clip;
+        UIComponent* component = nullptr; // Callback commands only
+        // Text commands only
+        GLTtext* text = nullptr;
+        uint32_t textOffset = NO_TEXT; // Offset of the null-terminated string in DrawList::textArena
+        float textX = 0.0f, textY = 0.0f, textScale = 1.0f;
+        uint32_t textColor = 0xffffffff;
+        int textAlignX = GLT_LEFT, textAlignY = GLT_TOP;
+    };
+
+    struct DrawList {
+        std::vector<DrawVertex> vertices;
+        std::vector<uint32_t> indices;
+        std::vector<ShapeVertex> shapeVertices;
+        std::vector<uint32_t> shapeIndices;
+        std::vector<DrawCmd> commands;
+        std::vector<char> textArena;
+        ClipRect clip; // Applied to commands recorded from now on
+        std::vector<ClipRect> clipStack; // Clips saved by pushClip()
+        ClipRect view; // Culling bounds (the window); unlike clip it never becomes a scissor
+        uint32_t culled = 0;   // Items skipped while recording because they were off screen or clipped
+        uint32_t occluded = 0; // Items skipped because an opaque widget above hides them
+
+        void clear() {
+            vertices.clear();
+            indices.clear();
+            shapeVertices.clear();
+            shapeIndices.clear();
+            commands.clear();
+            textArena.clear();
+            clip = ClipRect();
+            clipStack.clear();
+            view = ClipRect();
+            culled = 0;
+            occluded = 0;
+        }
 
-    ///////////////////////////////////////////////////////////////////////////////
- /////////////// TEXT RENDERING STRUCTS////////////////////////////////////////
- //////////////////////////////////////////////////////////////////////////////
-    struct TextComponent : public UIComponent {
-        std::string text;
-        float fontSize;
-        GLTtext* gltText;
-        
-        TextComponent(const std::string& text, float fontSize)
-            : text(text), fontSize(fontSize){
-            gltText = gltCreateText();
-            if (gltText == nullptr) {
-               throw std::runtime_error("Failed to create text");
+        // Restrict drawing to the part of the rect inside the current clip, until popClip()
+        void pushClip(float x, float y, float w, float h) {
+            clipStack.push_back(clip);
+            clip = clip.intersection(x, y, w, h);
+        }
+
+        void popClip() {
+            if (clipStack.empty()) {
+                std::cerr << "DrawList::popClip without pushClip" << std::endl;
+                return;
             }
-            
+            clip = clipStack.back();
+            clipStack.pop_back();
         }
 
-        
+        // Replace the clip regardless of the stack; prefer pushClip()/popClip() for nested content
+        void setClip(float x, float y, float w, float h) {
+            clip.x = x;
+            clip.y = y;
+            clip.width = w;
+            clip.height = h;
+            clip.enabled = true;
+        }
 
-        virtual void Draw() override {
-            gltSetText(gltText, text.c_str());
-            gltBeginDraw();
+        void clearClip() {
+            clip = ClipRect();
+        }
 
-           
-            // Determine text position within widget for centered alignment
-            float textX = x + width / 2.0f; // Centered horizontally
-            float textY = y + height / 2.0f; // Centered vertically
+        // False when a rect would be scissored away or off screen entirely, so recording it can be skipped
+        bool visible(float x, float y, float w, float h) const {
+            return clip.intersects(x, y, w, h) && view.intersects(x, y, w, h) && (!clip.enabled || (clip.width > 0.0f && clip.height > 0.0f));
+        }
 
-            gltColor(1.0f, 1.0f, 1.0f, 1.0f); // Example: White color
-            gltDrawText2DAligned(gltText, textX, textY, fontSize, GLT_CENTER, GLT_CENTER);
+        bool empty() const {
+            return commands.empty();
+        }
 
-            gltEndDraw();
+        // Extend the previous command when the texture matches, so runs of quads become one draw call
+        void beginTriangles(GLuint texture) {
+            if (commands.empty() || commands.back().type != DrawCmdType::Triangles || commands.back().texture != texture || commands.back().clip != clip) {
+                DrawCmd cmd;
+                cmd.type = DrawCmdType::Triangles;
+                cmd.texture = texture;
+                cmd.clip = clip;
+                cmd.firstIndex = static_cast<uint32_t>(indices.size());
+                commands.push_back(cmd);
+            }
         }
 
-        virtual void handleEvents(SDL_Event* event) override {
-            // Handle events for text component if needed
+        // Shapes batch with each other the same way, but not with triangles, which use the other vertex format
+        void beginShapes() {
+            if (commands.empty() || commands.back().type != DrawCmdType::Shapes || commands.back().clip != clip) {
+                DrawCmd cmd;
+                cmd.type = DrawCmdType::Shapes;
+                cmd.clip = clip;
+                cmd.firstIndex = static_cast<uint32_t>(shapeIndices.size());
+                commands.push_back(cmd);
+            }
         }
 
-        void setText(const std::string& newText) {
-            text = newText;
-            gltSetText(gltText, text.c_str()); // Update the GLText instance
+        // Indices for the last four vertices, in order around the quad
+        void closeQuad() {
+            uint32_t base = static_cast<uint32_t>(vertices.size()) - 4;
+            const uint32_t quad[6] = { base, base + 1, base + 2, base + 2, base + 3, base };
+            indices.insert(indices.end(), quad, quad + 6);
+            commands.back().indexCount += 6;
         }
-        ~TextComponent() {
-            gltDeleteText(gltText);
-            gltTerminate();
 
+        void addQuad(float x, float y, float w, float h, float u0, float v0, float u1, float v1, uint32_t color, GLuint texture) {
+            beginTriangles(texture);
+            vertices.push_back({ x,     y,     u0, v0, color });
+            vertices.push_back({ x + w, y,     u1, v0, color });
+            vertices.push_back({ x + w, y + h, u1, v1, color });
+            vertices.push_back({ x,     y + h, u0, v1, color });
+            closeQuad();
         }
-    };
 
-    //////////////////////////////////////////////////////////////////////////////////////////
-    // /////////////////////////////BUTTON COMPONENT OF WIDGETS///////////////////////////////
-    // //////////////////////////////////////////////////////////////////////////////////////
-    struct ButtonComponent : public UIComponent {
-        TextComponent* textComponent = nullptr;
-        GLuint texture = 0;
-        std::function<void()> onClick;
-        bool hasTexture = false; // New flag to indicate if the button has a texture
-        int width;
-        int height;
-        Alignment alignment;
-        ButtonComponent(const std::string text, float fontSize, const std::string& texturePath = "", std::function<void()> onClick = nullptr, int width = 100, int height = 50,Alignment alignment = Alignment::BottomCenter)
-            : onClick(onClick), alignment(alignment) {
-            this->width = width; // Set button width
-            this->height = height; // Set button height
+        // A segment as one quad, thickness pixels across; batches with rects, but has no anti-aliasing
+        void addLine(float x0, float y0, float x1, float y1, float thickness, uint32_t color) {
+            float dx = x1 - x0, dy = y1 - y0;
+            float length = std::sqrt(dx * dx + dy * dy);
+            if (length <= 0.0f) {
+                addRect(x0 - 0.5f * thickness, y0 - 0.5f * thickness, thickness, thickness, color);
+                return;
+            }
+            float nx = -dy / length * 0.5f * thickness, ny = dx / length * 0.5f * thickness;
+            beginTriangles(0);
+            vertices.push_back({ x0 + nx, y0 + ny, 0.0f, 0.0f, color });
+            vertices.push_back({ x1 + nx, y1 + ny, 1.0f, 0.0f, color });
+            vertices.push_back({ x1 - nx, y1 - ny, 1.0f, 1.0f, color });
+            vertices.push_back({ x0 - nx, y0 - ny, 0.0f, 1.0f, color });
+            closeQuad();
+        }
 
-            if (!text.empty()) {
-                textComponent = new TextComponent(text, fontSize);
+        void addRect(float x, float y, float w, float h, uint32_t color) {
+            addQuad(x, y, w, h, 0.0f, 0.0f, 1.0f, 1.0f, color, 0);
+        }
+
+        // One quad whose fill, border, rounded corners and anti-aliased edge are all computed in
+        // the fragment shader, so a bordered box costs no overdraw. The border lies inside w x h.
+        void addRoundedRect(float x, float y, float w, float h, uint32_t fill, float radius = 0.0f,
+            float borderWidth = 0.0f, uint32_t borderColor = 0, float softness = 1.0f) {
+            if (w <= 0.0f || h <= 0.0f) {
+                return;
+            }
+            float halfW = 0.5f * w, halfH = 0.5f * h;
+            radius = std::max(0.0f, std::min(radius, std::min(halfW, halfH)));
+            float pad = 0.5f * softness + 1.0f; // Room for the edge falloff outside the shape
+            beginShapes();
+            uint32_t base = static_cast<uint32_t>(shapeVertices.size());
+            const float corners[4][2] = { { -1.0f, -1.0f }, { 1.0f, -1.0f }, { 1.0f, 1.0f }, { -1.0f, 1.0f } };
+            for (const auto& corner : corners) {
+                float localX = corner[0] * (halfW + pad), localY = corner[1] * (halfH + pad);
+                shapeVertices.push_back({ x + halfW + localX, y + halfH + localY, fill, localX, localY,
+                    halfW, halfH, radius, borderWidth, borderColor, softness });
             }
+            const uint32_t quad[6] = { base, base + 1, base + 2, base + 2, base + 3, base };
+            shapeIndices.insert(shapeIndices.end(), quad, quad + 6);
+            commands.back().indexCount += 6;
+        }
 
-            // Load the texture if a path is provided and it's not empty
-            if (!texturePath.empty()) {
-                SDL_Surface* surface = IMG_Load(texturePath.c_str());
-                if (surface) {
-                    glGenTextures(1, &texture);
-                    glBindTexture(GL_TEXTURE_2D, texture);
+        // Soft drop shadow behind a w x h box, spread over blur pixels and shifted by offset
+        void addShadow(float x, float y, float w, float h, uint32_t color, float blur, float radius = 0.0f, float offsetX = 0.0f, float offsetY = 0.0f) {
+            addRoundedRect(x + offsetX, y + offsetY, w, h, color, radius + 0.5f * blur, 0.0f, 0, std::max(blur, 1.0f));
+        }
 
-                    GLenum format = surface->format->BytesPerPixel == 4 ? GL_RGBA : GL_RGB;
-                    glTexImage2D(GL_TEXTURE_2D, 0, format, surface->w, surface->h, 0, format, GL_UNSIGNED_BYTE, surface->pixels);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        void addImage(GLuint texture, float x, float y, float w, float h, uint32_t color = 0xffffffff) {
+            addQuad(x, y, w, h, 0.0f, 0.0f, 1.0f, 1.0f, color, texture);
+        }
 
-                    SDL_FreeSurface(surface);
-                    hasTexture = true; // Texture successfully loaded
-                }
-                else {
-                    std::cerr << "Failed to load texture " << IMG_GetError() << std::endl;
-                }
-            }
+        // Draw a GLTtext whose string was already set on the GL thread. The GLTtext must outlive the list.
+        void addText(GLTtext* text, float x, float y, float scale, uint32_t color, int alignX = GLT_LEFT, int alignY = GLT_TOP) {
+            DrawCmd cmd;
+            cmd.type = DrawCmdType::Text;
+            cmd.clip = clip;
+            cmd.text = text;
+            cmd.textX = x;
+            cmd.textY = y;
+            cmd.textScale = scale;
+            cmd.textColor = color;
+            cmd.textAlignX = alignX;
+            cmd.textAlignY = alignY;
+            commands.push_back(cmd);
         }
 
-        virtual void Draw() override {
-            //draw the button texture if it exists
-            if (hasTexture) {
-                glUseProgram(shaderProgram);
-                glBindVertexArray(VAO);
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, texture);
-                glUniform1i(glGetUniformLocation(shaderProgram, "texture1"), 0);
-                glUniform1i(glGetUniformLocation(shaderProgram, "useTexture"), 1);
-
-                glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(x, y, 0.0f));
-                model = glm::scale(model, glm::vec3(width, height, 1.0f)); // Use button's width and height
-                GLuint modelLoc = glGetUniformLocation(shaderProgram, "model");
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-
-                GLuint projLoc = glGetUniformLocation(shaderProgram, "projection");
-                glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-
-                glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-                glBindVertexArray(0);
-                glUseProgram(0);
-                calculatePositionForAlignment(x, y, width, height, parent->width, parent->height, alignment);
-            }
-            else {
-                // Draw a basic colored square
-                glUseProgram(shaderProgram);
-                glBindVertexArray(VAO);
-                glUniform1i(glGetUniformLocation(shaderProgram, "useTexture"), 0); // Indicate not using texture
-                glUniform4f(glGetUniformLocation(shaderProgram, "fallbackColor"), 0.5f, 0.5f, 0.5f, 1.0f); // Example: Gray color
+        // Same, but the string is copied into the arena and set on the GLTtext at submit time,
+        // so text objects can be shared between rows (set is a no-op when unchanged)
+        void addText(GLTtext* text, const char* str, size_t length, float x, float y, float scale, uint32_t color, int alignX = GLT_LEFT, int alignY = GLT_TOP) {
+            addText(text, x, y, scale, color, alignX, alignY);
+            commands.back().textOffset = static_cast<uint32_t>(textArena.size());
+            textArena.insert(textArena.end(), str, str + length);
+            textArena.push_back('\0');
+        }
 
-                glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(x, y, 0.0f));
-                model = glm::scale(model, glm::vec3(width, height, 1.0f));
-                GLuint modelLoc = glGetUniformLocation(shaderProgram, "model");
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+        void addCallback(UIComponent* component) {
+            DrawCmd cmd;
+            cmd.type = DrawCmdType::Callback;
+            cmd.clip = clip;
+            cmd.component = component;
+            commands.push_back(cmd);
+        }
 
-                GLuint projLoc = glGetUniformLocation(shaderProgram, "projection");
-                glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
+        // CPU memory held by the list's buffers, which clear() keeps for the next frame
+        size_t capacityBytes() const {
+            return vertices.capacity() * sizeof(DrawVertex) + indices.capacity() * sizeof(uint32_t) +
+                shapeVertices.capacity() * sizeof(ShapeVertex) + shapeIndices.capacity() * sizeof(uint32_t) +
+                commands.capacity() * sizeof(DrawCmd) + textArena.capacity() + clipStack.capacity() * sizeof(ClipRect);
+        }
 
-                glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-                glBindVertexArray(0);
-                glUseProgram(0);
-                calculatePositionForAlignment(x, y, width, height, parent->width, parent->height, alignment);
+        // Append another list, e.g. one recorded on a different thread
+        void append(const DrawList& other) {
+            uint32_t vertexBase = static_cast<uint32_t>(vertices.size());
+            uint32_t indexBase = static_cast<uint32_t>(indices.size());
+            uint32_t shapeVertexBase = static_cast<uint32_t>(shapeVertices.size());
+            uint32_t shapeIndexBase = static_cast<uint32_t>(shapeIndices.size());
+            uint32_t textBase = static_cast<uint32_t>(textArena.size());
+            vertices.insert(vertices.end(), other.vertices.begin(), other.vertices.end());
+            indices.reserve(indices.size() + other.indices.size());
+            for (uint32_t index : other.indices) {
+                indices.push_back(index + vertexBase);
             }
-
-            //draw text component if it exists
-            if (textComponent) {
-                textComponent->Draw();
+            shapeVertices.insert(shapeVertices.end(), other.shapeVertices.begin(), other.shapeVertices.end());
+            shapeIndices.reserve(shapeIndices.size() + other.shapeIndices.size());
+            for (uint32_t index : other.shapeIndices) {
+                shapeIndices.push_back(index + shapeVertexBase);
             }
-        }
-        virtual void handleEvents(SDL_Event* event) override {
-            // Handle click events
-            if (event->type == SDL_MOUSEBUTTONDOWN && event->button.button == SDL_BUTTON_LEFT) {
-                int mouseX = event->button.x;
-                int mouseY = event->button.y;
-                // Check if the click is within the button's bounds
-                if (mouseX > x && mouseX < x + width && mouseY > y && mouseY < y + height) {
-                    if (onClick) {
-                        onClick(); // Call the callback function
+            textArena.insert(textArena.end(), other.textArena.begin(), other.textArena.end());
+            culled += other.culled;
+            occluded += other.occluded;
+            for (DrawCmd cmd : other.commands) {
+                if (cmd.type == DrawCmdType::Triangles) {
+                    cmd.firstIndex += indexBase;
+                }
+                else if (cmd.type == DrawCmdType::Shapes) {
+                    cmd.firstIndex += shapeIndexBase;
+                }
+                if (cmd.textOffset != NO_TEXT) {
+                    cmd.textOffset += textBase;
+                }
+                // Join with the previous list's last batch when state matches, as addQuad() would have
+                if ((cmd.type == DrawCmdType::Triangles || cmd.type == DrawCmdType::Shapes) && !commands.empty()) {
+                    DrawCmd& last = commands.back();
+                    if (last.type == cmd.type && last.texture == cmd.texture && last.clip == cmd.clip &&
+                        last.firstIndex + last.indexCount == cmd.firstIndex) {
+                        last.indexCount += cmd.indexCount;
+                        continue;
                     }
                 }
+                commands.push_back(cmd);
             }
         }
 
+        const char* textFor(const DrawCmd& cmd) const {
+            return cmd.textOffset == NO_TEXT ? nullptr : textArena.data() + cmd.textOffset;
+        }
+    };
 
-        //Override the updatepos method
-        virtual void updatePosition(float deltaX, float deltaY) override {
-            // First, call the base class method to update the button's position
-            UIComponent::updatePosition(deltaX, deltaY);
+    void UIComponent::record(DrawList& list) {
+        list.addCallback(this);
+    }
 
-            // Then, update the position of the text component relative to the new button position
-            if (textComponent) {
-                textComponent->x = this->x;
-                textComponent->y = this->y;
-            }
+    // Visible part of the widget whose events are being dispatched
+    ClipRect& currentEventClip();
+
+    // Pointer presses, moves and wheel turns are not delivered to components that lie entirely
+    // outside eventClip; releases and keyboard events always are, so no press or focus gets stuck.
+    // Components that want every press get them wherever they land.
+    bool receivesEvent(const UIComponent& component, const SDL_Event* event) {
+        if (event->type != SDL_MOUSEMOTION && event->type != SDL_MOUSEBUTTONDOWN && event->type != SDL_MOUSEWHEEL) {
+            return true;
         }
-        ~ButtonComponent() {
-            delete textComponent; // Clean up the text component
-            if (texture) {
-                glDeleteTextures(1, &texture); // Clean up the texture
+        if (event->type == SDL_MOUSEBUTTONDOWN && component.wantsEveryPress()) {
+            return true;
+        }
+        const ClipRect& clip = currentEventClip();
+        return component.visible && clip.intersects(component.x, component.y, static_cast<float>(component.width), static_cast<float>(component.height)) &&
+            clip.width > 0.0f && clip.height > 0.0f;
+    }
+
+    // The point is on the component where it can be seen: inside its rect and the visible part
+    // of its widget, with the component and every enclosing stack shown
+    bool pointerOver(const UIComponent& component, int pointerX, int pointerY) {
+        for (const UIComponent* shown = &component; shown; shown = shown->parentComponent) {
+            if (!shown->visible) {
+                return false;
             }
         }
+        const ClipRect& clip = currentEventClip();
+        float px = static_cast<float>(pointerX), py = static_cast<float>(pointerY);
+        return px >= component.x && px < component.x + component.width && py >= component.y && py < component.y + component.height &&
+            clip.width > 0.0f && clip.height > 0.0f && clip.contains(px, py, 0.0f, 0.0f);
+    }
 
+    const char* drawListVertexShaderSource = R"(
+    #version 330 core
+    layout(location = 0) in vec2 aPos;
+    layout(location = 1) in vec2 aTexCoord;
+    layout(location = 2) in vec4 aColor;
+    layout(location = 3) in vec2 aLocal;
+    layout(location = 4) in vec4 aShape;       // halfWidth, halfHeight, radius, borderWidth
+    layout(location = 5) in vec4 aBorderColor;
+    layout(location = 6) in float aSoftness;
+
+    out vec2 TexCoord;
+    out vec4 Color;
+    out vec2 Local;
+    flat out vec4 Shape;
+    flat out vec4 BorderColor;
+    flat out float Softness;
+
+    uniform mat4 projection;
+
+    void main() {
+        gl_Position = projection * vec4(aPos, 0.0, 1.0);
+        TexCoord = aTexCoord;
+        Color = aColor;
+        Local = aLocal;
+        Shape = aShape;
+        BorderColor = aBorderColor;
+        Softness = aSoftness;
+    }
+)";
+
+    const char* drawListFragmentShaderSource = R"(
+    #version 330 core
+    out vec4 FragColor;
+    in vec2 TexCoord;
+    in vec4 Color;
+    in vec2 Local;
+    flat in vec4 Shape;
+    flat in vec4 BorderColor;
+    flat in float Softness;
+
+    uniform sampler2D texture1;
+
+    void main() {
+        vec4 color = texture(texture1, TexCoord) * Color;
+        if (Shape.x > 0.0) {
+            // Signed distance to the rounded box, negative inside
+            float radius = Shape.z;
+            vec2 q = abs(Local) - Shape.xy + vec2(radius);
+            float d = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - radius;
+            if (Shape.w > 0.0) {
+                float inBorder = smoothstep(-Shape.w - 0.5, -Shape.w + 0.5, d);
+                color = mix(color, BorderColor, inBorder);
+            }
+            color.a *= 1.0 - smoothstep(-0.5 * Softness, 0.5 * Softness, d);
+        }
+        FragColor = color;
+    }
+)";
+
+    // One program draws both vertex formats: the plain VAO leaves the shape attributes
+    // disabled, so they read as constant zero and the shader skips the SDF
+    struct DrawListRenderer {
+        GLuint program = 0;
+        GLuint vao = 0, vbo = 0, ebo = 0;
+        GLuint shapeVao = 0, shapeVbo = 0, shapeEbo = 0;
+        GLuint whiteTexture = 0;
+        GLint projectionLoc = -1;
+        size_t vertexCapacity = 0, indexCapacity = 0;
+        size_t shapeVertexCapacity = 0, shapeIndexCapacity = 0;
+    };
+
+    DrawListRenderer& currentDrawListRenderer();
+
+    void initDrawListRenderer() {
+        DrawListRenderer& r = currentDrawListRenderer();
+        r.program = createShaderProgram(drawListVertexShaderSource, drawListFragmentShaderSource);
+        r.projectionLoc = glGetUniformLocation(r.program, "projection");
+        glUseProgram(r.program);
+        glUniform1i(glGetUniformLocation(r.program, "texture1"), 0);
+        glUseProgram(0);
+
+        const uint32_t white = 0xffffffff;
+        glGenTextures(1, &r.whiteTexture);
+        glBindTexture(GL_TEXTURE_2D, r.whiteTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, &white);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        trackResource(ResourceKind::Texture, r.whiteTexture, sizeof(white), "DrawList");
+
+        glGenVertexArrays(1, &r.vao);
+        glGenBuffers(1, &r.vbo);
+        glGenBuffers(1, &r.ebo);
+        glBindVertexArray(r.vao);
+        glBindBuffer(GL_ARRAY_BUFFER, r.vbo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, r.ebo);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(DrawVertex), (void*)offsetof(DrawVertex, x));
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(DrawVertex), (void*)offsetof(DrawVertex, u));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(DrawVertex), (void*)offsetof(DrawVertex, color));
+        glEnableVertexAttribArray(2);
+
+        // Shapes are untextured, so the texture coordinate stays disabled too
+        glGenVertexArrays(1, &r.shapeVao);
+        glGenBuffers(1, &r.shapeVbo);
+        glGenBuffers(1, &r.shapeEbo);
+        glBindVertexArray(r.shapeVao);
+        glBindBuffer(GL_ARRAY_BUFFER, r.shapeVbo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, r.shapeEbo);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(ShapeVertex), (void*)offsetof(ShapeVertex, x));
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ShapeVertex), (void*)offsetof(ShapeVertex, color));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(ShapeVertex), (void*)offsetof(ShapeVertex, localX));
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(ShapeVertex), (void*)offsetof(ShapeVertex, halfWidth)); // Through borderWidth
+        glEnableVertexAttribArray(4);
+        glVertexAttribPointer(5, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ShapeVertex), (void*)offsetof(ShapeVertex, borderColor));
+        glEnableVertexAttribArray(5);
+        glVertexAttribPointer(6, 1, GL_FLOAT, GL_FALSE, sizeof(ShapeVertex), (void*)offsetof(ShapeVertex, softness));
+        glEnableVertexAttribArray(6);
+        glBindVertexArray(0);
+    }
+
+    void releaseDrawListRenderer() {
+        DrawListRenderer& r = currentDrawListRenderer();
+        untrackResource(ResourceKind::Texture, r.whiteTexture);
+        untrackResource(ResourceKind::Buffer, r.vbo);
+        untrackResource(ResourceKind::Buffer, r.ebo);
+        untrackResource(ResourceKind::Buffer, r.shapeVbo);
+        untrackResource(ResourceKind::Buffer, r.shapeEbo);
+        glDeleteTextures(1, &r.whiteTexture);
+        const GLuint buffers[4] = { r.vbo, r.ebo, r.shapeVbo, r.shapeEbo };
+        glDeleteBuffers(4, buffers);
+        const GLuint arrays[2] = { r.vao, r.shapeVao };
+        glDeleteVertexArrays(2, arrays);
+        glDeleteProgram(r.program);
+        r = DrawListRenderer();
+    }
+
+    void bindDrawListRenderer() {
+        DrawListRenderer& r = currentDrawListRenderer();
+        glUseProgram(r.program);
+        glUniformMatrix4fv(r.projectionLoc, 1, GL_FALSE, glm::value_ptr(currentProjection()));
+        glBindVertexArray(r.vao);
+        glVertexAttrib4f(4, 0.0f, 0.0f, 0.0f, 0.0f); // No shape: the plain VAO reads this constant
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    // Orphan buffer and grow it geometrically so steady-state frames only re-upload
+    void uploadStreamBuffer(GLenum target, GLuint buffer, size_t& capacity, size_t count, size_t stride, const void* data, size_t slack) {
+        glBindBuffer(target, buffer);
+        if (count > capacity) {
+            capacity = count * 3 / 2 + slack;
+            trackResource(ResourceKind::Buffer, buffer, capacity * stride, "DrawList");
+        }
+        glBufferData(target, capacity * stride, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(target, 0, count * stride, data);
+    }
+
+    // Expects the plain VAO bound (bindDrawListRenderer()) and leaves it bound; element
+    // array bindings belong to the VAO, so the shape buffers are filled with its VAO bound
+    void uploadDrawList(const DrawList& list) {
+        DrawListRenderer& r = currentDrawListRenderer();
+        uploadStreamBuffer(GL_ARRAY_BUFFER, r.vbo, r.vertexCapacity, list.vertices.size(), sizeof(DrawVertex), list.vertices.data(), 64);
+        uploadStreamBuffer(GL_ELEMENT_ARRAY_BUFFER, r.ebo, r.indexCapacity, list.indices.size(), sizeof(uint32_t), list.indices.data(), 96);
+        if (!list.shapeVertices.empty()) {
+            glBindVertexArray(r.shapeVao);
+            uploadStreamBuffer(GL_ARRAY_BUFFER, r.shapeVbo, r.shapeVertexCapacity, list.shapeVertices.size(), sizeof(ShapeVertex), list.shapeVertices.data(), 16);
+            uploadStreamBuffer(GL_ELEMENT_ARRAY_BUFFER, r.shapeEbo, r.shapeIndexCapacity, list.shapeIndices.size(), sizeof(uint32_t), list.shapeIndices.data(), 24);
+            glBindVertexArray(r.vao);
+        }
+    }
+
+    void submitDrawList(const DrawList& list) {
+        if (list.empty()) {
+            return;
+        }
+        DrawListRenderer& r = currentDrawListRenderer();
+        bindDrawListRenderer();
+        uploadDrawList(list);
+        bool shapesBound = false; // Which VAO is bound: bindDrawListRenderer() binds the plain one
+
+        // Consecutive text commands share one gltBeginDraw()/gltEndDraw() pair
+        bool inText = false;
+        std::unique_lock<std::mutex> textLock(glTextMutex, std::defer_lock);
+        ClipRect currentClip;
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        for (const DrawCmd& cmd : list.commands) {
+            if (cmd.clip != currentClip) {
+                if (cmd.clip.enabled) {
+                    glEnable(GL_SCISSOR_TEST);
+                    glScissor(static_cast<GLint>(cmd.clip.x), viewport[3] - static_cast<GLint>(cmd.clip.y + cmd.clip.height),
+                        static_cast<GLsizei>(cmd.clip.width), static_cast<GLsizei>(cmd.clip.height));
+                }
+                else {
+                    glDisable(GL_SCISSOR_TEST);
+                }
+                currentClip = cmd.clip;
+            }
+            if (cmd.type == DrawCmdType::Text) {
+                if (!inText) {
+                    textLock.lock(); // Held for the run: glText's program and uniforms are shared by all contexts
+                    gltBeginDraw(); // glText owns its own program and buffers
+                    inText = true;
+                }
+                const char* str = list.textFor(cmd);
+                if (str) {
+                    gltSetText(cmd.text, str); // No-op when the string is unchanged
+                }
+                gltColor((cmd.textColor & 0xff) / 255.0f, ((cmd.textColor >> 8) & 0xff) / 255.0f,
+                    ((cmd.textColor >> 16) & 0xff) / 255.0f, ((cmd.textColor >> 24) & 0xff) / 255.0f);
+                gltDrawText2DAligned(cmd.text, cmd.textX, cmd.textY, cmd.textScale, cmd.textAlignX, cmd.textAlignY);
+                continue;
+            }
+            if (inText) {
+                gltEndDraw();
+                textLock.unlock();
+                inText = false;
+                bindDrawListRenderer();
+                shapesBound = false;
+            }
+            if (cmd.type == DrawCmdType::Triangles || cmd.type == DrawCmdType::Shapes) {
+                bool shapes = cmd.type == DrawCmdType::Shapes;
+                if (shapes != shapesBound) {
+                    glBindVertexArray(shapes ? r.shapeVao : r.vao);
+                    shapesBound = shapes;
+                }
+                glBindTexture(GL_TEXTURE_2D, cmd.texture ? cmd.texture : r.whiteTexture);
+                glDrawElements(GL_TRIANGLES, cmd.indexCount, GL_UNSIGNED_INT, (void*)(cmd.firstIndex * sizeof(uint32_t)));
+            }
+            else {
+                // Draw() may itself submit a draw list, which would orphan our buffers
+                cmd.component->Draw();
+                bindDrawListRenderer();
+                uploadDrawList(list);
+                shapesBound = false;
+                glDisable(GL_SCISSOR_TEST);
+                currentClip = ClipRect();
+            }
+        }
+        if (inText) {
+            gltEndDraw();
+            textLock.unlock();
+        }
+        if (currentClip.enabled) {
+            glDisable(GL_SCISSOR_TEST);
+        }
+
+        glBindVertexArray(0);
+        glUseProgram(0);
+    }
+
+    // Draw a single component immediately by recording and submitting it; used by the built-in
+    // components' Draw(). Lists are pooled per nesting depth since submit can call back into Draw().
+    void drawRecorded(UIComponent& component) {
+        thread_local std::vector<std::unique_ptr<DrawList>> scratch;
+        thread_local size_t depth = 0;
+        if (scratch.size() <= depth) {
+            scratch.emplace_back(new DrawList());
+        }
+        DrawList& list = *scratch[depth];
+        list.clear();
+        component.record(list);
+        ++depth;
+        submitDrawList(list);
+        --depth;
+    }
+
+    // Initialize shader program and VAO, VBO
+   
+
+    void initOpenGL() {
+        glewInit();
+
+        currentShaderProgram() = createShaderProgram(vertexShaderSource, fragmentShaderSource);
+        {
+            std::lock_guard<std::mutex> lock(glTextMutex);
+            if (glTextUsers++ == 0) {
+                gltInit(); // Later contexts must share objects with this one, see UI CONTEXTS
+            }
+        }
+        glyphAdvances(); // Measured here so the worker never has to
+        float vertices[] = {
+            // positions    // texture coords
+            0.0f,  1.0f,    0.0f, 1.0f,
+            1.0f,  1.0f,    1.0f, 1.0f,
+            1.0f,  0.0f,    1.0f, 0.0f,
+            0.0f,  0.0f,    0.0f, 0.0f
+        };
+        unsigned int indices[] = {
+            0, 1, 2,
+            2, 3, 0
+        };
+
+        glGenVertexArrays(1, &currentVAO());
+        glGenBuffers(1, &currentVBO());
+        glGenBuffers(1, &currentEBO());
+
+        glBindVertexArray(currentVAO());
+
+        glBindBuffer(GL_ARRAY_BUFFER, currentVBO());
+        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, currentEBO());
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+       
+        initDrawListRenderer();
+    
+    }
+
+
+    ///////////////////////////////////////////////////////////////////////////////
+ /////////////// TEXT RENDERING STRUCTS////////////////////////////////////////
+ //////////////////////////////////////////////////////////////////////////////
+    struct TextComponent : public UIComponent {
+        std::string text;
+        float fontSize;
+        GLTtext* gltText;
+        uint32_t color = 0; // Packed RGBA drawn instead of the style's text color, 0 uses the style
+        
+        TextComponent(const std::string& text, float fontSize)
+            : text(text), fontSize(fontSize){
+            gltText = gltCreateText();
+            if (gltText == nullptr) {
+               throw std::runtime_error("Failed to create text");
+            }
+            setGLText(gltText, text.c_str());
+            alignment = Alignment::Center;
+            countObject("TextComponent", 1);
+        }
 
-    };
-    ///////////////////////////////////////////////////////////////////////////////////////
-    ///////////////////////////////LIST BOX COMPONENT//////////////////////////////////////
-    ////////////////////////////////////////////////////////////////////////////////////////
-   
-    struct ListBoxComponent : public UIComponent {
-        std::vector<std::string> items; // List of items to display
-        std::function<void(const std::string&)> onItemSelected; // Callback function for item selection
-        TextComponent* textComponent = nullptr;
-        int selectedItemIndex = -1; // Index of the currently selected item, -1 if none
-        int hoveredItemIndex = -1; // Index of the item under the mouse cursor
         
 
-        // Modified constructor to include width and height parameters
-        ListBoxComponent(const std::vector<std::string>& items, std::function<void(const std::string&)> onItemSelected = nullptr, int width = 100, int height = 150)
-            : items(items), onItemSelected(onItemSelected) {
-            this->width = width;
-            this->height = height;
-            // Instantiate textComponent here, assuming a default font size (adjust as needed)
-            textComponent = new TextComponent("", 2.0f); // Empty text initially
+        virtual void Draw() override {
+            drawRecorded(*this);
+        }
+
+        // Position comes from the layout pass, so drawing is just a submit. syncGL() sets the
+        // glyphs of a new string before this list is submitted, so the command refers to the
+        // GLTtext as is.
+        virtual void record(DrawList& list) override {
+            list.addText(gltText, x, y, fontSize, color ? color : style().text);
+        }
+
+        virtual void handleEvents(SDL_Event* event) override {
+            // Handle events for text component if needed
+        }
+
+        // From the string, not the GLTtext, whose glyphs may not be set yet
+        virtual void measure(float& outWidth, float& outHeight) override {
+            outWidth = textWidth(text, fontSize);
+            outHeight = gltGetLineHeight(fontSize) * (1 + std::count(text.begin(), text.end(), '\n'));
+        }
+
+        // Sized by its text and font size
+        virtual int* sizeField(bool horizontal) override {
+            return nullptr;
+        }
+
+        void setText(const std::string& newText) {
+            if (newText == text) {
+                return;
+            }
+            text = newText;
+            requestGLSync(*this); // Glyphs are set on the GL thread
+            invalidateMeasure();
+        }
+
+        virtual void syncGL() override {
+            setGLText(gltText, text.c_str());
+        }
+
+        void setFontSize(float newFontSize) {
+            if (newFontSize == fontSize) {
+                return;
+            }
+            fontSize = newFontSize;
+            invalidateMeasure();
+        }
+
+        void setColor(uint32_t newColor) {
+            if (newColor != color) {
+                color = newColor;
+                requestRedraw();
+            }
+        }
+        // glText itself is shut down once, in shutdownUI()
+        ~TextComponent() {
+            gltDeleteText(gltText);
+            countObject("TextComponent", -1);
+        }
+    };
+
+    //////////////////////////////////////////////////////////////////////////////////////////
+    // /////////////////////////////BUTTON COMPONENT OF WIDGETS///////////////////////////////
+    // //////////////////////////////////////////////////////////////////////////////////////
+    struct ButtonComponent : public UIComponent {
+        TextComponent* textComponent = nullptr;
+        GLuint texture = 0;
+        std::function<void()> onClick;
+        bool hasTexture = false; // New flag to indicate if the button has a texture
+        bool isHovered = false, isPressed = false; // Select the style state
+        ButtonComponent(const std::string text, float fontSize, const std::string& texturePath = "", std::function<void()> onClick = nullptr, int width = 100, int height = 50,Alignment alignment = Alignment::BottomCenter)
+            : onClick(onClick) {
+            this->width = width; // Set button width
+            this->height = height; // Set button height
+            this->alignment = alignment;
+            styleType = StyleComponent::Button;
+
+            if (!text.empty()) {
+                textComponent = new TextComponent(text, fontSize);
+                textComponent->parentComponent = this;
+            }
+
+            // Load the texture if a path is provided and it's not empty
+            if (!texturePath.empty()) {
+                texture = loadUITexture(texturePath).texture; // Reports failures itself
+                hasTexture = texture != 0;
+            }
+            countObject("ButtonComponent", 1);
+        }
+
+        virtual void Draw() override {
+            drawRecorded(*this);
+        }
+
+        StyleState currentState() const {
+            return isPressed ? StyleState::Pressed : (isHovered ? StyleState::Hover : StyleState::Normal);
+        }
+
+        virtual void record(DrawList& list) override {
+            const ResolvedStyle& look = style(currentState());
+            float w = static_cast<float>(width), h = static_cast<float>(height);
+            float b = look.borderWidth;
+            if (look.shadow) {
+                list.addShadow(x - b, y - b, w + 2.0f * b, h + 2.0f * b, look.shadow, look.shadowSize, look.cornerRadius, 0.0f, 0.5f * look.shadowSize);
+            }
+            //draw the button texture if it exists, otherwise one SDF quad with the theme's fill, border and corners
+            if (hasTexture) {
+                if (b > 0.0f) {
+                    list.addRoundedRect(x - b, y - b, w + 2.0f * b, h + 2.0f * b, 0, look.cornerRadius, b, look.border);
+                }
+                list.addImage(texture, x, y, w, h);
+            }
+            else {
+                list.addRoundedRect(x - b, y - b, w + 2.0f * b, h + 2.0f * b, look.background, look.cornerRadius, b, look.border);
+            }
+
+            //draw the label in the button's text color for its state
+            if (textComponent) {
+                list.addText(textComponent->gltText, textComponent->x, textComponent->y, textComponent->fontSize, look.text);
+            }
+        }
+
+        bool contains(int mouseX, int mouseY) const {
+            return mouseX > x && mouseX < x + width && mouseY > y && mouseY < y + height;
+        }
+
+        virtual void handleEvents(SDL_Event* event) override {
+            StyleState before = currentState();
+            // Handle click events
+            if (event->type == SDL_MOUSEBUTTONDOWN && event->button.button == SDL_BUTTON_LEFT) {
+                // Check if the click is within the button's bounds
+                if (contains(event->button.x, event->button.y)) {
+                    isPressed = true;
+                    requestRedraw(); // The callback usually changes what is shown
+                    if (onClick) {
+                        onClick(); // Call the callback function
+                    }
+                }
+            }
+            else if (event->type == SDL_MOUSEBUTTONUP && event->button.button == SDL_BUTTON_LEFT) {
+                isPressed = false;
+            }
+            else if (event->type == SDL_MOUSEMOTION) {
+                isHovered = contains(event->motion.x, event->motion.y);
+            }
+            if (currentState() != before) {
+                requestRedraw();
+            }
+        }
+
+
+        // The label is centered on the button once per layout, not per draw
+        virtual void arrange() override {
+            if (textComponent) {
+                measureComponent(*textComponent);
+                placeComponent(*textComponent, x, y, static_cast<float>(width), static_cast<float>(height), false, false);
+            }
+        }
+
+        //Override the updatepos method
+        virtual void updatePosition(float deltaX, float deltaY) override {
+            // First, call the base class method to update the button's position
+            UIComponent::updatePosition(deltaX, deltaY);
+
+            // Then, move the text component along with the button
+            if (textComponent) {
+                textComponent->updatePosition(deltaX, deltaY);
+            }
+        }
+        ~ButtonComponent() {
+            delete textComponent; // Clean up the text component
+            releaseUITexture(texture);
+            countObject("ButtonComponent", -1);
+        }
+
+
+    };
+    ///////////////////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////LIST BOX COMPONENT//////////////////////////////////////
+    ////////////////////////////////////////////////////////////////////////////////////////
+   
+    // Receives change notifications from a ListDataSource
+    struct ListDataObserver {
+        virtual ~ListDataObserver() {}
+        virtual void onRowsInserted(int first, int count) = 0;
+        virtual void onRowsRemoved(int first, int count) = 0;
+        virtual void onRowsUpdated(int first, int count) = 0;
+        virtual void onRowMoved(int from, int to) = 0;
+        virtual void onRowsReset() = 0;
+        virtual void onSourceDestroyed() {} // The source is going away; drop any pointer to it
+    };
+
+    // Model behind a ListBox. The list never copies rows: it asks for the count and for
+    // the text of the rows it is about to draw. Implementations change their data and
+    // then call the matching notify function so views can update incrementally.
+    // Rows returned by rowText() must stay valid until the next change notification.
+    struct ListDataSource {
+        std::vector<ListDataObserver*> observers;
+
+        virtual ~ListDataSource() {
+            std::vector<ListDataObserver*> detached;
+            detached.swap(observers);
+            for (auto observer : detached) observer->onSourceDestroyed();
+        }
+        virtual int rowCount() const = 0;
+        virtual std::string_view rowText(int row) const = 0;
+
+        // Optional hooks for sources that filter or reorder other data (see sv_ui_listindex.h)
+        virtual int rowKey(int row) const { return row; } // Identity of a row that survives a reset
+        virtual int rowForKey(int key) const { return key < rowCount() ? key : -1; }
+        virtual bool rowMatch(int row, int& start, int& length) const { return false; } // Text range to highlight
+        virtual bool setFilterQuery(std::string_view query) { return false; } // False when filtering is unsupported
+
+        void addObserver(ListDataObserver* observer) {
+            observers.push_back(observer);
+        }
+
+        void removeObserver(ListDataObserver* observer) {
+            observers.erase(std::remove(observers.begin(), observers.end(), observer), observers.end());
+        }
+
+        void notifyInserted(int first, int count) {
+            for (auto observer : observers) observer->onRowsInserted(first, count);
+        }
+
+        void notifyRemoved(int first, int count) {
+            for (auto observer : observers) observer->onRowsRemoved(first, count);
+        }
+
+        void notifyUpdated(int first, int count) {
+            for (auto observer : observers) observer->onRowsUpdated(first, count);
+        }
+
+        void notifyMoved(int from, int to) {
+            for (auto observer : observers) observer->onRowMoved(from, to);
+        }
+
+        void notifyReset() {
+            for (auto observer : observers) observer->onRowsReset();
+        }
+    };
+
+    // Simple data source over a vector of strings that notifies on every edit
+    struct VectorListSource : public ListDataSource {
+        std::vector<std::string> items;
+
+        VectorListSource() {}
+        explicit VectorListSource(const std::vector<std::string>& items) : items(items) {}
+
+        virtual int rowCount() const override {
+            return static_cast<int>(items.size());
+        }
+
+        virtual std::string_view rowText(int row) const override {
+            return items[row];
+        }
+
+        void insert(int row, const std::string& text) {
+            items.insert(items.begin() + row, text);
+            notifyInserted(row, 1);
+        }
+
+        void append(const std::string& text) {
+            insert(rowCount(), text);
+        }
+
+        void remove(int row, int count = 1) {
+            items.erase(items.begin() + row, items.begin() + row + count);
+            notifyRemoved(row, count);
+        }
+
+        void set(int row, const std::string& text) {
+            if (items[row] == text) {
+                return;
+            }
+            items[row] = text;
+            notifyUpdated(row, 1);
+        }
+
+        void move(int from, int to) {
+            std::string text = std::move(items[from]);
+            items.erase(items.begin() + from);
+            items.insert(items.begin() + to, std::move(text));
+            notifyMoved(from, to);
+        }
+
+        void assign(const std::vector<std::string>& newItems) {
+            items = newItems;
+            notifyReset();
+        }
+    };
+
+    struct ListBoxComponent : public UIComponent, public ListDataObserver {
+        ListDataSource* source = nullptr; // Rows are fetched from here on demand
+        std::unique_ptr<VectorListSource> ownedSource; // Backs the vector constructor and setItems()
+        std::function<void(const std::string&)> onItemSelected; // Callback function for item selection
+        int selectedItemIndex = -1; // Index of the currently selected item, -1 if none
+        int hoveredItemIndex = -1; // Index of the item under the mouse cursor
+        int selectedKey = -1; // source->rowKey() of the selection, to find it again after a reset
+        int firstVisibleRow = -1; // Top row of the last drawn frame, used to anchor the view across edits
+        std::string typeAhead; // Filter typed while the mouse is over the list
+        float fontSize = 2.0f;
+
+        // Rows have a constant height unless setRowHeights()/setRowHeight() switched to per-row heights
+        float itemHeight = 20.0f;
+        bool variableRowHeights = false;
+        RowHeightIndex rowIndex;
+
+        // Scrolling. Input moves scrollTarget; scrollOffset eases towards it in update().
+        float scrollOffset = 0.0f;
+        float scrollTarget = 0.0f;
+        float scrollStep = 60.0f; // Pixels per mouse wheel notch
+        float scrollbarWidth = 10.0f;
+        bool isMouseOver = false;
+        bool isDraggingScrollbar = false;
+        float scrollbarGrabOffset = 0.0f;
+
+        // Ring of text objects, row i uses slot i % size. Rows keep their slot while scrolling and
+        // gltSetText() skips unchanged strings, so only rows coming into view rebuild glyphs.
+        // rowForSlot remembers which row each slot's match highlight was measured for. update()
+        // sizes the ring in rowSlots; syncGL() creates the text objects to match.
+        std::vector<GLTtext*> rowTexts;
+        int rowSlots = 0;
+        std::vector<int> rowForSlot;
+        std::vector<float> matchXForSlot, matchWidthForSlot; // Highlighted match of each slot's row, width 0 if none
+        
+
+        // Modified constructor to include width and height parameters
+        ListBoxComponent(const std::vector<std::string>& items, std::function<void(const std::string&)> onItemSelected = nullptr, int width = 100, int height = 150)
+            : onItemSelected(onItemSelected) {
+            this->width = width;
+            this->height = height;
+            styleType = StyleComponent::ListBox;
+            ownedSource.reset(new VectorListSource(items));
+            setDataSource(ownedSource.get());
+            countObject("ListBoxComponent", 1);
+        }
+
+        // The source is not owned and must outlive the list, or be detached with setDataSource(nullptr)
+        ListBoxComponent(ListDataSource* dataSource, std::function<void(const std::string&)> onItemSelected = nullptr, int width = 100, int height = 150)
+            : onItemSelected(onItemSelected) {
+            this->width = width;
+            this->height = height;
+            styleType = StyleComponent::ListBox;
+            setDataSource(dataSource);
+            countObject("ListBoxComponent", 1);
+        }
+
+        void setDataSource(ListDataSource* dataSource) {
+            if (source) {
+                source->removeObserver(this);
+            }
+            source = dataSource;
+            if (source) {
+                source->addObserver(this);
+            }
+            onRowsReset();
+        }
+
+        int itemCount() const {
+            return source ? source->rowCount() : 0;
+        }
+
+        std::string_view itemText(int row) const {
+            return source->rowText(row);
+        }
+
+        double rowOffset(int row) const {
+            return variableRowHeights ? rowIndex.offsetOf(row) : static_cast<double>(row) * itemHeight;
+        }
+
+        float rowHeight(int row) const {
+            return variableRowHeights ? rowIndex.heights[row] : itemHeight;
+        }
+
+        double contentHeight() const {
+            return variableRowHeights ? rowIndex.totalHeight() : static_cast<double>(itemCount()) * itemHeight;
+        }
+
+        // Row under a content-space offset, or -1 past the last row
+        int rowAtOffset(double offset) const {
+            if (offset < 0.0 || offset >= contentHeight()) {
+                return -1;
+            }
+            return variableRowHeights ? static_cast<int>(rowIndex.rowAt(offset)) : static_cast<int>(offset / itemHeight);
+        }
+
+        bool needsScrollbar() const {
+            return contentHeight() > height;
+        }
+
+        float rowsWidth() const {
+            return needsScrollbar() ? width - scrollbarWidth : static_cast<float>(width);
+        }
+
+        float maxScroll() const {
+            double excess = contentHeight() - height;
+            return excess > 0.0 ? static_cast<float>(excess) : 0.0f;
+        }
+
+        void scrollTo(float offset, bool smooth = true) {
+            float limit = maxScroll();
+            float target = offset < 0.0f ? 0.0f : (offset > limit ? limit : offset);
+            if (target != scrollTarget || (!smooth && scrollOffset != target)) {
+                requestRedraw();
+            }
+            scrollTarget = target;
+            if (!smooth) {
+                scrollOffset = scrollTarget;
+            }
+        }
+
+        // Scroll the minimum distance that makes the row fully visible
+        void scrollToItem(int row, bool smooth = true) {
+            if (row < 0 || row >= itemCount()) {
+                return;
+            }
+            float top = static_cast<float>(rowOffset(row));
+            float bottom = top + rowHeight(row);
+            if (top < scrollTarget) {
+                scrollTo(top, smooth);
+            }
+            else if (bottom > scrollTarget + height) {
+                scrollTo(bottom - height, smooth);
+            }
+        }
+
+        // Replace the contents with a copy of newItems; prefer a ListDataSource for lists that change often
+        void setItems(const std::vector<std::string>& newItems) {
+            if (!ownedSource) {
+                ownedSource.reset(new VectorListSource());
+            }
+            if (source != ownedSource.get()) {
+                setDataSource(ownedSource.get());
+            }
+            ownedSource->assign(newItems);
+        }
+
+        // Adjust a stored index for rows inserted at first
+        static void shiftForInsert(int& index, int first, int count) {
+            if (index >= first) index += count;
+        }
+
+        // Adjust a stored index for rows removed at first; the index is dropped if its row went away
+        static void shiftForRemove(int& index, int first, int count) {
+            if (index >= first + count) index -= count;
+            else if (index >= first) index = -1;
+        }
+
+        // Same for the view anchor, which moves to the first surviving row instead of being dropped
+        static void shiftAnchorForRemove(int& index, int first, int count) {
+            if (index >= first + count) index -= count;
+            else if (index >= first) index = first;
+        }
+
+        // Keep the anchor on an existing row after the row count shrank
+        void clampAnchor() {
+            if (firstVisibleRow >= itemCount()) {
+                firstVisibleRow = itemCount() - 1;
+            }
+        }
+
+        // Drop cached glyphs for rows at or after first (count < 0 means "to the end")
+        void invalidateRowTexts(int first, int count = -1) {
+            for (int& row : rowForSlot) {
+                if (row >= first && (count < 0 || row < first + count)) {
+                    row = -1;
+                }
+            }
+        }
+
+        void refreshSelectedKey() {
+            selectedKey = selectedItemIndex >= 0 ? source->rowKey(selectedItemIndex) : -1;
+        }
+
+        virtual void onRowsInserted(int first, int count) override {
+            requestRedraw();
+            // Keep the rows on screen still when something is inserted above them
+            int topRow = firstVisibleRow;
+            if (variableRowHeights) {
+                rowIndex.insertRows(first, count, itemHeight);
+            }
+            if (topRow >= 0 && first <= topRow) {
+                float inserted = count * itemHeight;
+                scrollOffset += inserted;
+                scrollTarget += inserted;
+            }
+            shiftForInsert(selectedItemIndex, first, count);
+            shiftForInsert(hoveredItemIndex, first, count);
+            shiftForInsert(firstVisibleRow, first, count);
+            refreshSelectedKey();
+            invalidateRowTexts(first);
+        }
+
+        virtual void onRowsRemoved(int first, int count) override {
+            requestRedraw();
+            int topRow = firstVisibleRow;
+            float removedTop = static_cast<float>(rowOffset(first));
+            float removedHeight = 0.0f;
+            if (variableRowHeights) {
+                for (int row = first; row < first + count; ++row) {
+                    removedHeight += rowIndex.heights[row];
+                }
+                rowIndex.eraseRows(first, count);
+            }
+            else {
+                removedHeight = count * itemHeight;
+            }
+            // Keep the rows on screen still: the view moves up by the part of the removed rows above its
+            // top edge, so when the top row itself went away the next surviving row takes its place
+            if (topRow >= first) {
+                scrollOffset -= std::min(removedHeight, std::max(0.0f, scrollOffset - removedTop));
+                scrollTarget -= std::min(removedHeight, std::max(0.0f, scrollTarget - removedTop));
+            }
+            shiftForRemove(selectedItemIndex, first, count);
+            shiftForRemove(hoveredItemIndex, first, count);
+            shiftAnchorForRemove(firstVisibleRow, first, count);
+            clampAnchor();
+            refreshSelectedKey();
+            invalidateRowTexts(first);
+        }
+
+        virtual void onRowsUpdated(int first, int count) override {
+            requestRedraw();
+            invalidateRowTexts(first, count);
+        }
+
+        virtual void onRowMoved(int from, int to) override {
+            requestRedraw();
+            int topRow = firstVisibleRow;
+            float movedHeight = variableRowHeights ? rowIndex.heights[from] : itemHeight;
+            if (variableRowHeights) {
+                rowIndex.moveRow(from, to);
+            }
+            // Keep the rows on screen still when the row crosses the top of the view
+            if (topRow >= 0 && from < topRow && to >= topRow) {
+                scrollOffset -= movedHeight;
+                scrollTarget -= movedHeight;
+            }
+            else if (topRow >= 0 && from > topRow && to <= topRow) {
+                scrollOffset += movedHeight;
+                scrollTarget += movedHeight;
+            }
+            // Indices between the two positions shift by one towards from
+            auto remap = [from, to](int& index) {
+                if (index == from) index = to;
+                else if (from < to && index > from && index <= to) --index;
+                else if (to < from && index >= to && index < from) ++index;
+            };
+            remap(selectedItemIndex);
+            remap(hoveredItemIndex);
+            if (firstVisibleRow != from) {
+                remap(firstVisibleRow);
+            } // Else, as when it is removed, the row now at from takes the moved top row's place
+            refreshSelectedKey();
+            invalidateRowTexts(from < to ? from : to, (from < to ? to - from : from - to) + 1);
+        }
+
+        virtual void onSourceDestroyed() override {
+            source = nullptr;
+            onRowsReset();
+        }
+
+        virtual void onRowsReset() override {
+            requestRedraw();
+            if (variableRowHeights) {
+                rowIndex.build(std::vector<float>(itemCount(), itemHeight));
+            }
+            // Filtering and re-sorting reset the rows; follow the selected row to its new index
+            selectedItemIndex = (source && selectedKey >= 0) ? source->rowForKey(selectedKey) : -1;
+            if (selectedItemIndex >= itemCount()) selectedItemIndex = -1;
+            hoveredItemIndex = -1;
+            clampAnchor(); // The scroll offset is kept, so the anchor stays on the row at the top
+            std::fill(rowForSlot.begin(), rowForSlot.end(), -1);
+            scrollTo(scrollTarget, false);
+        }
+
+        // Switch to constant-height rows
+        void setUniformRowHeight(float height) {
+            itemHeight = height;
+            variableRowHeights = false;
+            rowIndex = RowHeightIndex();
+            scrollTo(scrollTarget, false);
+            requestRedraw();
+        }
+
+        // Switch to per-row heights; heights must have one entry per item
+        void setRowHeights(const std::vector<float>& heights) {
+            if (static_cast<int>(heights.size()) != itemCount()) {
+                std::cerr << "ListBox: expected " << itemCount() << " row heights, got " << heights.size() << std::endl;
+                return;
+            }
+            variableRowHeights = true;
+            rowIndex.build(heights);
+            scrollTo(scrollTarget, false);
+            requestRedraw();
+        }
+
+        void setRowHeight(int row, float height) {
+            if (row < 0 || row >= itemCount()) {
+                return;
+            }
+            if (!variableRowHeights) {
+                setRowHeights(std::vector<float>(itemCount(), itemHeight));
+            }
+            rowIndex.setHeight(row, height);
+            scrollTo(scrollTarget, false);
+            requestRedraw();
+        }
+
+        // Scrollbar thumb in screen space
+        void scrollbarThumb(float& thumbY, float& thumbHeight) const {
+            float total = static_cast<float>(contentHeight());
+            thumbHeight = total > 0.0f ? height * (height / total) : static_cast<float>(height);
+            if (thumbHeight < 16.0f) thumbHeight = 16.0f;
+            float limit = maxScroll();
+            thumbY = y + (limit > 0.0f ? (height - thumbHeight) * (scrollOffset / limit) : 0.0f);
+        }
+
+        // Rows intersecting the box, first = -1 when nothing is visible
+        void visibleRange(int& first, int& last) const {
+            first = rowAtOffset(scrollOffset);
+            last = first;
+            if (first >= 0) {
+                while (last + 1 < itemCount() && rowOffset(last + 1) - scrollOffset < height) {
+                    ++last;
+                }
+            }
+        }
+
+        // Grow the text ring to hold visibleRows and measure the matches of rows new to their slot
+        void prepareRows(int first, int last) {
+            int visibleRows = last - first + 1;
+            if (rowSlots < visibleRows) {
+                rowSlots = visibleRows;
+                rowForSlot.assign(rowSlots, -1); // The modulus changed, so every slot is stale
+                requestGLSync(*this);
+                requestRedraw(); // A pipelined frame is recorded before syncGL() adds the texts
+            }
+            for (int row = first; row <= last; ++row) {
+                int slot = row % rowSlots;
+                if (rowForSlot[slot] != row) {
+                    rowForSlot[slot] = row;
+                    measureMatch(slot, row, itemText(row));
+                }
+            }
+        }
+
+        // Measure where the source's match lies in the row, once per slot refresh
+        void measureMatch(int slot, int row, std::string_view text) {
+            if (static_cast<int>(matchXForSlot.size()) < rowSlots) {
+                matchXForSlot.resize(rowSlots);
+                matchWidthForSlot.resize(rowSlots);
+            }
+            matchWidthForSlot[slot] = 0.0f;
+            int start = 0, length = 0;
+            if (!source->rowMatch(row, start, length) || length <= 0) {
+                return;
+            }
+            float before = textWidth(text.substr(0, start), fontSize);
+            matchXForSlot[slot] = before;
+            matchWidthForSlot[slot] = textWidth(text.substr(0, start + length), fontSize) - before;
+        }
+
+        // Row strings are set at submit from the draw list, so only the ring grows here
+        virtual void syncGL() override {
+            while (static_cast<int>(rowTexts.size()) < rowSlots) {
+                rowTexts.push_back(gltCreateText());
+            }
+        }
+
+
+        virtual void Draw() override {
+            drawRecorded(*this);
+        }
+
+        virtual void update(float dt) override {
+            // Edits since the last frame may have changed the content height
+            rowIndex.rebuildIfStale();
+            float limit = maxScroll();
+            scrollTarget = scrollTarget > limit ? limit : (scrollTarget < 0.0f ? 0.0f : scrollTarget);
+            scrollOffset = scrollOffset > limit ? limit : (scrollOffset < 0.0f ? 0.0f : scrollOffset);
+
+            // Ease the scroll position towards its target, framerate independent
+            if (scrollOffset != scrollTarget) {
+                float t = 1.0f - std::exp(-dt * 18.0f);
+                scrollOffset += (scrollTarget - scrollOffset) * t;
+                if (std::fabs(scrollTarget - scrollOffset) < 0.5f) {
+                    scrollOffset = scrollTarget;
+                }
+                requestRedraw(); // Keep frames coming until the scroll settles
+            }
+
+            int first, last;
+            visibleRange(first, last);
+            firstVisibleRow = first;
+            if (first >= 0) {
+                prepareRows(first, last);
+            }
+        }
+
+        StyleState rowState(int row) const {
+            return row == selectedItemIndex ? StyleState::Selected : (row == hoveredItemIndex ? StyleState::Hover : StyleState::Normal);
+        }
+
+        virtual void record(DrawList& list) override {
+            const ResolvedStyle& box = style();
+            float b = box.borderWidth;
+            float outerW = width + 2.0f * b, outerH = height + 2.0f * b;
+            if (box.shadow) {
+                list.addShadow(x - b, y - b, outerW, outerH, box.shadow, box.shadowSize, box.cornerRadius, 0.0f, 0.5f * box.shadowSize);
+            }
+            // Border and fill in one quad, instead of a border-colored quad under the box
+            list.addRoundedRect(x - b, y - b, outerW, outerH, box.background, box.cornerRadius, b, box.border);
+
+            // Rows can be partially visible at the edges, so clip them to the box
+            list.pushClip(x, y, static_cast<float>(width), static_cast<float>(height));
+
+            // Only the rows intersecting the box are visited, so cost depends on height, not item count
+            float listWidth = rowsWidth();
+            int first, last;
+            visibleRange(first, last);
+            if (first >= 0 && static_cast<int>(rowTexts.size()) == rowSlots && rowSlots >= last - first + 1) {
+                int slots = rowSlots;
+                for (int row = first; row <= last; ++row) {
+                    float rowY = y + static_cast<float>(rowOffset(row) - scrollOffset);
+                    const ResolvedStyle& rowLook = style(StyleComponent::ListRow, rowState(row));
+                    if (rowLook.background >> 24) { // Skip fully transparent rows
+                        list.addRect(x, rowY, listWidth, rowHeight(row), rowLook.background);
+                    }
+                    int slot = row % slots;
+                    if (rowForSlot[slot] == row && slot < static_cast<int>(matchWidthForSlot.size()) && matchWidthForSlot[slot] > 0.0f) {
+                        list.addRect(x + 5.0f + matchXForSlot[slot], rowY + 2.0f, matchWidthForSlot[slot], rowHeight(row) - 4.0f, rowLook.accent);
+                    }
+                }
+
+                // Texts after all quads, so the submit enters glText's state once
+                float lineHeight = gltGetLineHeight(fontSize);
+                for (int row = first; row <= last; ++row) {
+                    std::string_view text = itemText(row);
+                    float rowY = y + static_cast<float>(rowOffset(row) - scrollOffset);
+                    uint32_t color = style(StyleComponent::ListRow, rowState(row)).text;
+                    list.addText(rowTexts[row % slots], text.data(), text.size(), x + 5.0f, rowY + (rowHeight(row) - lineHeight) / 2.0f, fontSize, color); // Start a bit inside from the left
+                }
+            }
+
+            list.popClip();
+
+            if (needsScrollbar()) {
+                float thumbY, thumbHeight;
+                scrollbarThumb(thumbY, thumbHeight);
+                float trackX = x + width - scrollbarWidth;
+                const ResolvedStyle& bar = style(StyleComponent::Scrollbar, isDraggingScrollbar ? StyleState::Pressed : StyleState::Normal);
+                list.addRect(trackX, y, scrollbarWidth, static_cast<float>(height), bar.background);
+                list.addRect(trackX + 1.0f, thumbY, scrollbarWidth - 2.0f, thumbHeight, bar.accent);
+            }
+        }
+
+        void updateHover(int mouseX, int mouseY) {
+            isMouseOver = mouseX > x && mouseX < x + width && mouseY > y && mouseY < y + height;
+            int hovered = -1;
+            if (isMouseOver && mouseX < x + rowsWidth()) {
+                hovered = rowAtOffset(mouseY - y + scrollOffset);
+            }
+            if (hovered != hoveredItemIndex) {
+                hoveredItemIndex = hovered;
+                requestRedraw();
+            }
+        }
+
+        virtual void handleEvents(SDL_Event* event) override {
+            rowIndex.rebuildIfStale();
+            // Handle item selection, e.g., on mouse click
+            if (event->type == SDL_MOUSEBUTTONDOWN && event->button.button == SDL_BUTTON_LEFT) {
+                int mouseX = event->button.x;
+                int mouseY = event->button.y;
+                updateHover(mouseX, mouseY);
+                if (!isMouseOver) {
+                    return;
+                }
+                if (needsScrollbar() && mouseX >= x + rowsWidth()) {
+                    float thumbY, thumbHeight;
+                    scrollbarThumb(thumbY, thumbHeight);
+                    if (mouseY >= thumbY && mouseY < thumbY + thumbHeight) {
+                        isDraggingScrollbar = true;
+                        scrollbarGrabOffset = mouseY - thumbY;
+                        requestRedraw();
+                    }
+                    else {
+                        // Clicking the track pages towards the click
+                        scrollTo(scrollTarget + (mouseY < thumbY ? -height : height));
+                    }
+                }
+                else if (hoveredItemIndex >= 0) {
+                    selectedItemIndex = hoveredItemIndex;
+                    refreshSelectedKey();
+                    requestRedraw();
+                    if (onItemSelected) {
+                        onItemSelected(std::string(itemText(selectedItemIndex))); // Call the callback function with the selected item
+                    }
+                }
+            }
+            else if (event->type == SDL_MOUSEBUTTONUP && event->button.button == SDL_BUTTON_LEFT) {
+                if (isDraggingScrollbar) {
+                    isDraggingScrollbar = false;
+                    requestRedraw();
+                }
+            }
+            else if (event->type == SDL_MOUSEMOTION) {
+                int mouseX = event->motion.x;
+                int mouseY = event->motion.y;
+                if (isDraggingScrollbar) {
+                    float thumbY, thumbHeight;
+                    scrollbarThumb(thumbY, thumbHeight);
+                    float travel = height - thumbHeight;
+                    float fraction = travel > 0.0f ? (mouseY - scrollbarGrabOffset - y) / travel : 0.0f;
+                    scrollTo(fraction * maxScroll(), false);
+                }
+                updateHover(mouseX, mouseY);
+            }
+            else if (event->type == SDL_MOUSEWHEEL && isMouseOver) {
+                scrollTo(scrollTarget - event->wheel.y * scrollStep);
+            }
+            else if (event->type == SDL_TEXTINPUT && isMouseOver && source) {
+                std::string query = typeAhead + event->text.text;
+                if (source->setFilterQuery(query)) {
+                    typeAhead = query;
+                }
+            }
+            else if (event->type == SDL_KEYDOWN && isMouseOver && source && !typeAhead.empty()) {
+                if (event->key.keysym.sym == SDLK_BACKSPACE) {
+                    // Drop the last UTF-8 code point
+                    size_t cut = typeAhead.size() - 1;
+                    while (cut > 0 && (static_cast<unsigned char>(typeAhead[cut]) & 0xC0) == 0x80) --cut;
+                    typeAhead.erase(cut);
+                    source->setFilterQuery(typeAhead);
+                }
+                else if (event->key.keysym.sym == SDLK_ESCAPE) {
+                    typeAhead.clear();
+                    source->setFilterQuery(typeAhead);
+                }
+            }
+        }
+
+        ~ListBoxComponent() {
+            if (source) {
+                source->removeObserver(this);
+            }
+            for (auto text : rowTexts) {
+                gltDeleteText(text);
+            }
+            countObject("ListBoxComponent", -1);
+        }
+    };
+
+
+
+    ///////////////////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////STACK COMPONENT/////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////////////////
+    // Container that lays out its children in a row, a column or on top of each other.
+    // Created with beginStack()/endStack(); a width or height of 0 means "fit the children".
+
+    struct StackComponent : public UIComponent {
+        std::vector<UIComponent*> children;
+        LayoutParams layout;
+        int fixedWidth = 0, fixedHeight = 0;
+
+        StackComponent(const LayoutParams& layout, int fixedWidth = 0, int fixedHeight = 0)
+            : layout(layout), fixedWidth(fixedWidth), fixedHeight(fixedHeight) {
+            countObject("StackComponent", 1);
+        }
+
+        virtual void Draw() override {
+            drawRecorded(*this);
+        }
+
+        virtual void update(float dt) override {
+            for (auto child : children) {
+                child->update(dt);
+            }
+        }
+
+        virtual void record(DrawList& list) override {
+            for (auto child : children) {
+                if (!child->visible) {
+                    continue;
+                }
+                if (list.visible(child->x, child->y, static_cast<float>(child->width), static_cast<float>(child->height))) {
+                    child->record(list);
+                }
+                else {
+                    ++list.culled;
+                }
+            }
+        }
+
+        virtual void handleEvents(SDL_Event* event) override {
+            for (auto child : children) {
+                if (receivesEvent(*child, event)) {
+                    child->handleEvents(event);
+                }
+            }
+        }
+
+        virtual bool wantsEveryPress() const override {
+            for (auto child : children) {
+                if (child->wantsEveryPress()) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        virtual void updatePosition(float deltaX, float deltaY) override {
+            UIComponent::updatePosition(deltaX, deltaY);
+            for (auto child : children) {
+                child->updatePosition(deltaX, deltaY);
+            }
+        }
+
+        virtual void measure(float& outWidth, float& outHeight) override {
+            measureChildren(children, layout, outWidth, outHeight);
+            if (fixedWidth > 0) outWidth = static_cast<float>(fixedWidth);
+            if (fixedHeight > 0) outHeight = static_cast<float>(fixedHeight);
+        }
+
+        virtual int* sizeField(bool horizontal) override {
+            return horizontal ? &fixedWidth : &fixedHeight;
+        }
+
+        virtual void arrange() override {
+            arrangeChildren(children, layout, x, y, static_cast<float>(width), static_cast<float>(height));
+        }
+
+        ~StackComponent() {
+            for (auto child : children) {
+                delete child;
+            }
+            countObject("StackComponent", -1);
+        }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////ANIMATION/////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////////////////
+    // Tweens numeric properties. Values are computed in bulk by the TrackPools of
+    // sv_ui_animation.h, then written back through the same paths a user edit takes:
+    // moveWidget() for widget position, invalidateMeasure() for component size,
+    // scrollTo() for list scrolling, or a plain float plus requestRedraw().
+    // Starting an animation on a property that is already animating replaces it.
+    // Every track has an owner, a Widget or UIComponent whose destructor cancels it;
+    // a float track's owner is the object that holds the float.
+
+    enum class AnimProperty : uint8_t {
+        WidgetX,
+        WidgetY,
+        ComponentWidth,
+        ComponentHeight,
+        ScrollOffset, // ListBoxComponent
+        Float         // Any float the caller owns, e.g. a color channel or an alpha
+    };
+
+    struct AnimationHandle {
+        uint32_t slot = 0xffffffffu;
+        uint32_t generation = 0;
+    };
+
+    struct AnimationTarget {
+        const void* object = nullptr; // Widget*, UIComponent* or float*
+        const void* owner = nullptr;  // The object itself, or for a float the object holding it
+        AnimProperty property = AnimProperty::Float;
+        Easing easing = Easing::Linear;
+        uint32_t index = 0; // Position in animator.pools[easing]
+        uint32_t generation = 0;
+        bool active = false;
+        std::function<void()> onComplete;
+    };
+
+    struct Animator {
+        TrackPool pools[static_cast<size_t>(Easing::Count)];
+        std::vector<AnimationTarget> targets; // Indexed by AnimationHandle::slot
+        std::vector<uint32_t> freeSlots;
+        std::unordered_map<const void*, std::vector<uint32_t>> slotsForOwner; // Active slots, a handful per owner
+        std::vector<uint32_t> finished; // Scratch for advance()
+        std::vector<AnimationHandle> completed;
+        size_t activeCount = 0;
+    };
+
+    Animator& currentAnimator();
+
+    void applyAnimatedValue(const AnimationTarget& target, float value) {
+        switch (target.property) {
+        case AnimProperty::WidgetX: {
+            Widget* widget = const_cast<Widget*>(static_cast<const Widget*>(target.object));
+            moveWidget(*widget, static_cast<int>(std::lround(value)), widget->y);
+            break;
+        }
+        case AnimProperty::WidgetY: {
+            Widget* widget = const_cast<Widget*>(static_cast<const Widget*>(target.object));
+            moveWidget(*widget, widget->x, static_cast<int>(std::lround(value)));
+            break;
+        }
+        case AnimProperty::ComponentWidth:
+        case AnimProperty::ComponentHeight: {
+            UIComponent* component = const_cast<UIComponent*>(static_cast<const UIComponent*>(target.object));
+            int* size = component->sizeField(target.property == AnimProperty::ComponentWidth);
+            int rounded = static_cast<int>(std::lround(value));
+            if (size && *size != rounded) {
+                *size = rounded;
+                component->invalidateMeasure();
+            }
+            break;
+        }
+        case AnimProperty::ScrollOffset: {
+            UIComponent* component = const_cast<UIComponent*>(static_cast<const UIComponent*>(target.object));
+            static_cast<ListBoxComponent*>(component)->scrollTo(value, false);
+            break;
+        }
+        case AnimProperty::Float:
+            *const_cast<float*>(static_cast<const float*>(target.object)) = value;
+            requestRedraw();
+            break;
+        }
+    }
+
+    void removeAnimationSlot(uint32_t slot) {
+        Animator& animator = currentAnimator();
+        AnimationTarget& target = animator.targets[slot];
+        TrackPool& pool = animator.pools[static_cast<size_t>(target.easing)];
+        uint32_t moved = pool.removeAt(target.index);
+        if (moved != slot) {
+            animator.targets[moved].index = target.index;
+        }
+        auto owned = animator.slotsForOwner.find(target.owner);
+        std::vector<uint32_t>& slots = owned->second;
+        slots.erase(std::find(slots.begin(), slots.end(), slot));
+        if (slots.empty()) {
+            animator.slotsForOwner.erase(owned);
+        }
+        target.active = false;
+        target.onComplete = nullptr;
+        ++target.generation;
+        animator.freeSlots.push_back(slot);
+        --animator.activeCount;
+    }
+
+    // owner is required for AnimProperty::Float and ignored otherwise
+    AnimationHandle animate(const void* object, AnimProperty property, float from, float to, float duration,
+        Easing easing = Easing::OutCubic, float delay = 0.0f, std::function<void()> onComplete = nullptr, const void* owner = nullptr) {
+        Animator& animator = currentAnimator();
+        if (property != AnimProperty::Float) {
+            owner = object;
+        }
+        else if (!owner) {
+            std::cerr << "animate: a float animation needs the widget or component that owns the float" << std::endl;
+            return AnimationHandle();
+        }
+        if ((property == AnimProperty::ComponentWidth || property == AnimProperty::ComponentHeight) &&
+            !const_cast<UIComponent*>(static_cast<const UIComponent*>(object))->sizeField(property == AnimProperty::ComponentWidth)) {
+            std::cerr << "animate: this component's size follows its content and cannot be animated" << std::endl;
+            return AnimationHandle();
+        }
+        auto owned = animator.slotsForOwner.find(owner);
+        if (owned != animator.slotsForOwner.end()) {
+            for (uint32_t slot : owned->second) {
+                if (animator.targets[slot].object == object && animator.targets[slot].property == property) {
+                    removeAnimationSlot(slot);
+                    break;
+                }
+            }
+        }
+        uint32_t slot;
+        if (!animator.freeSlots.empty()) {
+            slot = animator.freeSlots.back();
+            animator.freeSlots.pop_back();
+        }
+        else {
+            slot = static_cast<uint32_t>(animator.targets.size());
+            animator.targets.emplace_back();
+        }
+        AnimationTarget& target = animator.targets[slot];
+        target.object = object;
+        target.owner = owner;
+        target.property = property;
+        target.easing = easing;
+        target.index = static_cast<uint32_t>(animator.pools[static_cast<size_t>(easing)].add(slot, from, to, duration, delay));
+        target.active = true;
+        target.onComplete = std::move(onComplete);
+        animator.slotsForOwner[owner].push_back(slot);
+        ++animator.activeCount;
+        requestRedraw();
+
+        AnimationHandle handle;
+        handle.slot = slot;
+        handle.generation = target.generation;
+        return handle;
+    }
+
+    // Convenience overloads that start from the property's current value
+    AnimationHandle animateWidgetTo(Widget& widget, float toX, float toY, float duration, Easing easing = Easing::OutCubic, float delay = 0.0f) {
+        animate(&widget, AnimProperty::WidgetX, static_cast<float>(widget.x), toX, duration, easing, delay);
+        return animate(&widget, AnimProperty::WidgetY, static_cast<float>(widget.y), toY, duration, easing, delay);
+    }
+
+    // Drives the size measure() reports (a stack's fixed size); text components are sized by
+    // their text and are rejected. An unset (0) fixed size starts from the measured one.
+    AnimationHandle animateSizeTo(UIComponent& component, float toWidth, float toHeight, float duration, Easing easing = Easing::OutCubic, float delay = 0.0f) {
+        int* width = component.sizeField(true);
+        int* height = component.sizeField(false);
+        if (!width || !height) {
+            std::cerr << "animateSizeTo: this component's size follows its content and cannot be animated" << std::endl;
+            return AnimationHandle();
+        }
+        float fromWidth = *width > 0 ? static_cast<float>(*width) : component.measuredWidth;
+        float fromHeight = *height > 0 ? static_cast<float>(*height) : component.measuredHeight;
+        animate(&component, AnimProperty::ComponentWidth, fromWidth, toWidth, duration, easing, delay);
+        return animate(&component, AnimProperty::ComponentHeight, fromHeight, toHeight, duration, easing, delay);
+    }
+
+    AnimationHandle animateScrollTo(ListBoxComponent& listBox, float offset, float duration, Easing easing = Easing::OutCubic) {
+        return animate(static_cast<UIComponent*>(&listBox), AnimProperty::ScrollOffset, listBox.scrollOffset, offset, duration, easing);
+    }
+
+    // owner is the Widget or UIComponent holding value; the track ends when it is destroyed
+    AnimationHandle animateFloat(const void* owner, float& value, float to, float duration, Easing easing = Easing::Linear, float delay = 0.0f) {
+        return animate(&value, AnimProperty::Float, value, to, duration, easing, delay, nullptr, owner);
+    }
+
+    // rgba points at four floats held by owner
+    void animateColor(const void* owner, float* rgba, float r, float g, float b, float a, float duration, Easing easing = Easing::Linear) {
+        const float to[4] = { r, g, b, a };
+        for (int channel = 0; channel < 4; ++channel) {
+            animate(rgba + channel, AnimProperty::Float, rgba[channel], to[channel], duration, easing, 0.0f, nullptr, owner);
+        }
+    }
+
+    bool isAnimating(AnimationHandle handle) {
+        Animator& animator = currentAnimator();
+        return handle.slot < animator.targets.size() && animator.targets[handle.slot].active &&
+            animator.targets[handle.slot].generation == handle.generation;
+    }
+
+    // Stop where it is; the property keeps its current value
+    void cancelAnimation(AnimationHandle handle) {
+        if (isAnimating(handle)) {
+            removeAnimationSlot(handle.slot);
+        }
+    }
+
+    // Called by the Widget and UIComponent destructors so no track outlives its target,
+    // including float tracks on the object's members
+    void cancelAnimations(const void* owner) {
+        Animator& animator = currentAnimator();
+        if (animator.activeCount == 0) {
+            return;
+        }
+        auto owned = animator.slotsForOwner.find(owner);
+        if (owned == animator.slotsForOwner.end()) {
+            return;
+        }
+        std::vector<uint32_t> slots = owned->second; // removeAnimationSlot() edits the list
+        for (uint32_t slot : slots) {
+            removeAnimationSlot(slot);
+        }
+    }
+
+    // Advance every track by dt seconds and write the values back; run once per frame before layout
+    void updateAnimations(float dt) {
+        Animator& animator = currentAnimator();
+        if (animator.activeCount == 0) {
+            return;
+        }
+        animator.completed.clear();
+        for (size_t e = 0; e < static_cast<size_t>(Easing::Count); ++e) {
+            TrackPool& pool = animator.pools[e];
+            animator.finished.clear();
+            pool.advance(dt, static_cast<Easing>(e), animator.finished);
+            for (size_t i = 0; i < pool.size(); ++i) {
+                applyAnimatedValue(animator.targets[pool.ids[i]], pool.value[i]);
+            }
+            for (uint32_t index : animator.finished) {
+                AnimationHandle handle;
+                handle.slot = pool.ids[index];
+                handle.generation = animator.targets[handle.slot].generation;
+                animator.completed.push_back(handle);
+            }
+        }
+        // Callbacks run last, since they may start or cancel animations
+        for (const AnimationHandle& handle : animator.completed) {
+            if (!isAnimating(handle)) {
+                continue; // Replaced or cancelled by an earlier callback
+            }
+            std::function<void()> onComplete = std::move(animator.targets[handle.slot].onComplete);
+            removeAnimationSlot(handle.slot);
+            if (onComplete) {
+                onComplete();
+            }
+        }
+        requestRedraw(); // Applying may not have changed anything visible, but the next step will
+    }
+
+    // Functions for Widget
+
+    // True when nothing below the widget shows through it. Untextured widgets are opaque when
+    // their theme fill is, with square corners; textured ones when the image had no transparency.
+    bool isOpaque(const Widget& widget) {
+        if (widget.texture) {
+            return widget.textureOpaque;
+        }
+        const ResolvedStyle& panel = currentActiveTheme()->lookup(widget.styleClass, StyleComponent::Widget, StyleState::Normal);
+        return (panel.background >> 24) == 0xff && panel.cornerRadius <= 0.0f &&
+            (panel.borderWidth <= 0.0f || (panel.border >> 24) == 0xff);
+    }
+
+    // occluders are the rects of opaque widgets drawn above this one; components entirely
+    // behind one of them are skipped
+    void recordWidget(const Widget& widget, DrawList& list, const ClipRect* occluders = nullptr, size_t occluderCount = 0) {
+        float widgetX = static_cast<float>(widget.x), widgetY = static_cast<float>(widget.y);
+        float widgetWidth = static_cast<float>(widget.width), widgetHeight = static_cast<float>(widget.height);
+        if (!widget.visible) {
+            return;
+        }
+        if (!list.visible(widgetX, widgetY, widgetWidth, widgetHeight)) {
+            ++list.culled;
+            return; // Off screen or clipped away, with everything in it
+        }
+        const ResolvedStyle& panel = currentActiveTheme()->lookup(widget.styleClass, StyleComponent::Widget, StyleState::Normal);
+        if (panel.shadow) {
+            list.addShadow(widgetX, widgetY, widgetWidth, widgetHeight, panel.shadow, panel.shadowSize, panel.cornerRadius, 0.0f, 0.5f * panel.shadowSize);
+        }
+        if (widget.texture) {
+            list.addImage(widget.texture, widgetX, widgetY, widgetWidth, widgetHeight);
+        }
+        else {
+            list.addRoundedRect(widgetX, widgetY, widgetWidth, widgetHeight, panel.background, panel.cornerRadius, panel.borderWidth, panel.border);
+        }
+
+        // Components are clipped to the widget, but the scissor is only set when one actually
+        // sticks out, so widgets whose content fits keep batching with their neighbours
+        ClipRect widgetRect = ClipRect().intersection(widgetX, widgetY, widgetWidth, widgetHeight);
+        bool overflows = false;
+        for (auto component : widget.components) {
+            if (!widgetRect.contains(component->x, component->y, static_cast<float>(component->width), static_cast<float>(component->height))) {
+                overflows = true;
+                break;
+            }
+        }
+        if (overflows) {
+            list.pushClip(widgetX, widgetY, widgetWidth, widgetHeight);
+        }
+
+      //draw each component after the widget
+        for (auto component : widget.components) {
+            if (!component->visible) {
+                continue;
+            }
+            float componentWidth = static_cast<float>(component->width), componentHeight = static_cast<float>(component->height);
+            if (!list.visible(component->x, component->y, componentWidth, componentHeight)) {
+                ++list.culled;
+                continue;
+            }
+            bool hidden = false;
+            for (size_t i = 0; i < occluderCount && !hidden; ++i) {
+                hidden = occluders[i].contains(component->x, component->y, componentWidth, componentHeight);
+            }
+            if (hidden) {
+                ++list.occluded;
+                continue;
+            }
+            component->record(list);
+        }
+        if (overflows) {
+            list.popClip();
+        }
+    }
+
+    void updateWidget(Widget& widget, float dt) {
+        for (auto component : widget.components) {
+            component->update(dt);
+        }
+    }
+
+    void drawWidget(const Widget& widget) {
+        DrawList list;
+        recordWidget(widget, list);
+        submitDrawList(list);
+    }
+
+        void handleWidgetEvents(Widget& widget, SDL_Event* event) {
+        // Pointer events skip components in parts of the widget nobody can see; a hidden widget has
+        // an empty area, so its components still get releases and keys but no presses
+        currentEventClip() = widget.visible ? viewportClip().intersection(static_cast<float>(widget.x), static_cast<float>(widget.y),
+            static_cast<float>(widget.width), static_cast<float>(widget.height)) : ClipRect();
+        for (auto component : widget.components) {
+            if (receivesEvent(*component, event)) {
+                component->handleEvents(event);
+            }
+        }
+        if (widget.draggableComponent && widget.visible) {
+            handleDrag(*widget.draggableComponent, event);
+        }
+    }
+
+    // Public API functions
+    void createWidget(int id, int x, int y, int width, int height, int options, const std::string& texturePath) {
+        if (currentUIManager().isCreatingWidget) {
+            throw std::runtime_error("EndWidget must be called before calling a new widget");
+            return;
+       }
+        currentUIManager().isCreatingWidget = true;
+        auto widget = new Widget();
+        widget->ID = id;
+        widget->x = x;
+        widget->y = y;
+        widget->width = width;
+        widget->height = height;
+        widget->texture = 0;
+
+        if (!texturePath.empty()) {
+            TextureInfo loaded = loadUITexture(texturePath); // Cooked cache, see sv_ui_texturecache.h
+            widget->texture = loaded.texture;
+            widget->textureOpaque = loaded.opaque;
+            assignResource(ResourceKind::Texture, widget->texture, "Widget", id);
+        }
+
+        if (hasFlag(options, WIDGET_DRAGGABLE)) {
+            widget->draggableComponent = new DraggableComponent();
+            widget->draggableComponent->parent = widget;
+        }
+
+        currentUIManager().widgets.push_back(widget);
+        currentUIManager().currentWidget = widget;
+        requestRedraw();
+    }
+
+   
+
+    void beginWidget(int id) {
+        for (auto widget : currentUIManager().widgets) {
+            if (widget->ID == id) {
+                currentUIManager().currentWidget = widget;
+                return;
+            }
+        }
+       
+    }
+
+    // Attach a component to the innermost open stack, or to the current widget
+    void addComponent(UIComponent* component) {
+        Widget* widget = currentUIManager().currentWidget;
+        component->parent = widget;
+        component->x = static_cast<float>(widget->x);
+        component->y = static_cast<float>(widget->y);
+        if (!currentUIManager().stackStack.empty()) {
+            StackComponent* stack = currentUIManager().stackStack.back();
+            component->parentComponent = stack;
+            stack->children.push_back(component);
+            stack->invalidateMeasure();
+        }
+        else {
+            widget->components.push_back(component);
+        }
+        widget->layoutDirty = true;
+        requestRedraw();
+    }
+
+    TextComponent* Text(const std::string& text, float fontSize) {
+		if (!currentUIManager().currentWidget) {
+			std::cerr << "No widget selected" << std::endl;
+			return nullptr;
+		}
+		auto textComponent = new TextComponent(text, fontSize);
+		addComponent(textComponent);
+		return textComponent;
+	}
+
+    ButtonComponent* Button(const std::string& text, float fontSize, const std::string& texturePath, std::function<void()> onClick, int buttonWidth = 100, int buttonHeight = 50, Alignment alignment = Alignment::BottomCenter) {
+        if (!currentUIManager().currentWidget) {
+            std::cerr << "No widget selected" << std::endl;
+            return nullptr;
+        }
+        auto buttonComponent = new ButtonComponent(text, fontSize, texturePath, onClick, buttonWidth, buttonHeight, alignment);
+        addComponent(buttonComponent);
+        assignResource(ResourceKind::Texture, buttonComponent->texture, "ButtonComponent", currentUIManager().currentWidget->ID);
+        if (buttonComponent->textComponent) {
+            buttonComponent->textComponent->parent = currentUIManager().currentWidget;
+        }
+        return buttonComponent;
+    }
+
+   // Rows are read from source on demand; the source must outlive the list box.
+   // Type-ahead filtering needs a source that implements setFilterQuery(), such as
+   // ListIndexView. Its default prefix filter is indexed; FilterMode::Substring is
+   // a linear scan of every row on each new query (see sv_ui_listindex.h).
+   ListBoxComponent* ListBox(ListDataSource* source, std::function<void(const std::string&)> onItemSelected, int ListBoxwidth = 100, int ListBoxheight = 100) {
+       if (!currentUIManager().currentWidget) {
+           std::cerr << "No widget selected" << std::endl;
+           return nullptr;
+       }
+       auto listBoxComponent = new ListBoxComponent(source, onItemSelected, ListBoxwidth, ListBoxheight);
+       addComponent(listBoxComponent);
+       return listBoxComponent;
+   }
+
+   ListBoxComponent* ListBox(const std::vector<std::string>& items, std::function<void(const std::string&)> onItemSelected,int ListBoxwidth = 100, int ListBoxheight = 100) {
+		if (!currentUIManager().currentWidget) {
+			std::cerr << "No widget selected" << std::endl;
+			return nullptr;
+		}
+		auto listBoxComponent = new ListBoxComponent(items, onItemSelected, ListBoxwidth,ListBoxheight);
+		addComponent(listBoxComponent);
+		return listBoxComponent;
+	}
+
+    // Set how the current widget arranges its top-level components
+    void setLayout(LayoutDirection direction, float padding = 0.0f, float spacing = 0.0f) {
+        if (!currentUIManager().currentWidget) {
+            std::cerr << "No widget selected" << std::endl;
+            return;
+        }
+        currentUIManager().currentWidget->layout.direction = direction;
+        currentUIManager().currentWidget->layout.padding = padding;
+        currentUIManager().currentWidget->layout.spacing = spacing;
+        currentUIManager().currentWidget->layoutDirty = true;
+        requestRedraw();
+    }
+
+    // Components added until the matching endStack() go into a new stack
+    StackComponent* beginStack(LayoutDirection direction, float padding = 0.0f, float spacing = 0.0f, int width = 0, int height = 0) {
+        if (!currentUIManager().currentWidget) {
+            std::cerr << "No widget selected" << std::endl;
+            return nullptr;
+        }
+        LayoutParams params;
+        params.direction = direction;
+        params.padding = padding;
+        params.spacing = spacing;
+        auto stack = new StackComponent(params, width, height);
+        addComponent(stack);
+        currentUIManager().stackStack.push_back(stack);
+        return stack;
+    }
+
+    void endStack() {
+        if (currentUIManager().stackStack.empty()) {
+            std::cerr << "endStack called without beginStack" << std::endl;
+            return;
+        }
+        currentUIManager().stackStack.pop_back();
+    }
+
+    void endWidget() {
+        if (!currentUIManager().stackStack.empty()) {
+            std::cerr << "endWidget called with " << currentUIManager().stackStack.size() << " unclosed stack(s)" << std::endl;
+            currentUIManager().stackStack.clear();
+        }
+        currentUIManager().currentWidget = nullptr;
+        currentUIManager().isCreatingWidget = false;
+    }
+
+    // Resize a widget; its components are re-laid out on the next frame
+    void setWidgetSize(Widget& widget, int width, int height) {
+        if (widget.width == width && widget.height == height) {
+            return;
+        }
+        widget.width = width;
+        widget.height = height;
+        widget.layoutDirty = true;
+        requestRedraw();
+    }
+
+    // Widgets are not components, but draw their fallback background from the same table
+    void setWidgetStyleClass(Widget& widget, const std::string& name) {
+        widget.styleClass = internStyleClass(name);
+        requestRedraw();
+    }
+
+    void layoutWidget(Widget& widget) {
+        if (!widget.layoutDirty) {
+            return;
+        }
+        arrangeChildren(widget.components, widget.layout, static_cast<float>(widget.x), static_cast<float>(widget.y),
+            static_cast<float>(widget.width), static_cast<float>(widget.height));
+        widget.layoutDirty = false;
+    }
+
+    // Bring every widget's layout up to date; free when nothing was invalidated
+    void layoutUI() {
+        for (auto widget : currentUIManager().widgets) {
+            layoutWidget(*widget);
+        }
+    }
+
+    // Run every component's update()
+    void updateUI(float dt) {
+        for (auto widget : currentUIManager().widgets) {
+            updateWidget(*widget, dt);
+        }
+    }
+
+    //////////////////////////////////////////////////////////
+    ////////////HANDLES///////////////////////////////////////
+    //////////////////////////////////////////////////////////
+    // A UIHandle names a widget or component without pointing at it, so other threads can
+    // hold one safely: once the target is deleted its slot's generation changes and the
+    // handle resolves to nullptr. Get handles on the UI thread; resolve them there too.
+
+    struct UIHandle {
+        UIContext* context = nullptr; // Whose handle table (and command queue) the slot is in
+        uint32_t slot = 0;
+        uint32_t generation = 0;
+
+        explicit operator bool() const {
+            return slot != 0;
+        }
+    };
+
+    struct HandleEntry {
+        UIComponent* component = nullptr;
+        Widget* widget = nullptr;
+        uint32_t generation = 1;
+    };
+
+    struct HandleTable {
+        std::vector<HandleEntry> entries = std::vector<HandleEntry>(1); // Slot 0 is the null handle
+        std::vector<uint32_t> freeSlots;
+    };
+
+    HandleTable& handleTable();
+
+    uint32_t allocateHandleSlot() {
+        HandleTable& table = handleTable();
+        if (!table.freeSlots.empty()) {
+            uint32_t slot = table.freeSlots.back();
+            table.freeSlots.pop_back();
+            return slot;
+        }
+        table.entries.emplace_back();
+        return static_cast<uint32_t>(table.entries.size() - 1);
+    }
+
+    void releaseHandleSlot(uint32_t slot) {
+        if (!slot) {
+            return;
+        }
+        HandleEntry& entry = handleTable().entries[slot];
+        entry.component = nullptr;
+        entry.widget = nullptr;
+        ++entry.generation; // Outstanding handles to the old target stop resolving
+        handleTable().freeSlots.push_back(slot);
+    }
+
+    UIHandle handleOf(UIComponent* component) {
+        if (!component) {
+            return UIHandle();
+        }
+        if (!component->handleSlot) {
+            component->handleSlot = allocateHandleSlot();
+            handleTable().entries[component->handleSlot].component = component;
+        }
+        return UIHandle{ &ui(), component->handleSlot, handleTable().entries[component->handleSlot].generation };
+    }
+
+    UIHandle handleOf(Widget* widget) {
+        if (!widget) {
+            return UIHandle();
         }
+        if (!widget->handleSlot) {
+            widget->handleSlot = allocateHandleSlot();
+            handleTable().entries[widget->handleSlot].widget = widget;
+        }
+        return UIHandle{ &ui(), widget->handleSlot, handleTable().entries[widget->handleSlot].generation };
+    }
 
-        virtual void Draw() override {
-            if (!shaderProgram || !VAO) {
-                std::cerr << "Shader program or VAO not initialized." << std::endl;
-                return;
+    UIHandle widgetHandle(int id) {
+        for (auto widget : currentUIManager().widgets) {
+            if (widget->ID == id) {
+                return handleOf(widget);
             }
+        }
+        return UIHandle();
+    }
 
-            if (!textComponent) { // Check if textComponent is nullptr
-                std::cerr << "Text component not initialized." << std::endl;
-                return; // Skip drawing if textComponent is not initialized
-            }
+    const HandleEntry* resolveHandle(const UIHandle& handle) {
+        const HandleTable& table = handleTable();
+        if (!handle.slot || handle.context != &ui() || handle.slot >= table.entries.size() ||
+            table.entries[handle.slot].generation != handle.generation) {
+            return nullptr;
+        }
+        return &table.entries[handle.slot];
+    }
 
-            glUseProgram(shaderProgram);
-            glBindVertexArray(VAO);
+    UIComponent* resolveComponent(const UIHandle& handle) {
+        const HandleEntry* entry = resolveHandle(handle);
+        return entry ? entry->component : nullptr;
+    }
 
-            // Draw the border around the list box
-            GLint useTextureLoc = glGetUniformLocation(shaderProgram, "useTexture");
-            GLint fallbackColorLoc = glGetUniformLocation(shaderProgram, "fallbackColor");
-            GLint modelLoc = glGetUniformLocation(shaderProgram, "model");
-            GLint projLoc = glGetUniformLocation(shaderProgram, "projection");
+    Widget* resolveWidget(const UIHandle& handle) {
+        const HandleEntry* entry = resolveHandle(handle);
+        return entry ? entry->widget : nullptr;
+    }
 
-            if (useTextureLoc == -1 || fallbackColorLoc == -1 || modelLoc == -1 || projLoc == -1) {
-                std::cerr << "Failed to get uniform locations." << std::endl;
-                return;
-            }
+    void setWidgetVisible(Widget& widget, bool visible) {
+        if (widget.visible != visible) {
+            widget.visible = visible;
+            requestRedraw();
+        }
+    }
+
+    //////////////////////////////////////////////////////////
+    ////////////COMMAND QUEUE/////////////////////////////////
+    //////////////////////////////////////////////////////////
+    // Lets simulation, network or loader threads change the UI without locks: they post
+    // commands against handles, and the UI thread applies them at the start of the next
+    // frame (prepareFrame(), i.e. the pipeline's sync window). Posting never waits for
+    // rendering. Within one frame, commands of the same kind for the same target are
+    // coalesced and only the last one is applied; different targets keep their order.
+    //
+    //     SV_UI::UIHandle score = SV_UI::handleOf(SV_UI::Text("0", 1.0f)); // UI thread
+    //     // Any thread:
+    //     SV_UI::setTextAsync(score, std::to_string(points));
+    //     SV_UI::moveWidgetAsync(SV_UI::widgetHandle(3), x, y);
+    //
+    // Commands for targets deleted in the meantime are dropped.
+
+    enum class UICommandType : uint8_t {
+        SetText,    // TextComponent, or a ButtonComponent's label
+        SetItems,   // ListBoxComponent
+        MoveWidget,
+        SetVisible  // Widget or component
+    };
 
-            glUniform1i(useTextureLoc, 0); // Not using texture
-            glUniform4f(fallbackColorLoc, 0.0f, 0.0f, 0.0f, 1.0f); // Black border color
+    struct UICommand {
+        UICommandType type = UICommandType::SetText;
+        UIHandle target;
+        std::string text;
+        std::vector<std::string> items;
+        int x = 0, y = 0;
+        bool visible = true;
+    };
+
+    struct UICommandQueue {
+        MpscQueue<UICommand> pending;
+        // UI thread only: reused between frames
+        std::vector<UICommand> batch;
+        std::unordered_map<uint64_t, size_t> lastIndex;
+        // Counters, for diagnostics
+        std::atomic<uint64_t> posted{ 0 };
+        uint64_t applied = 0, coalesced = 0, stale = 0;
+    };
+
+    UICommandQueue& commandQueue(UIContext& context);
+
+    // Thread-safe. Returns false for a null handle.
+    bool postCommand(UICommand command) {
+        if (!command.target) {
+            return false;
+        }
+        UIContext& context = *command.target.context;
+        UICommandQueue& queue = commandQueue(context);
+        queue.pending.push(std::move(command));
+        queue.posted.fetch_add(1, std::memory_order_relaxed);
+        requestRedrawAsync(context);
+        return true;
+    }
 
-            glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(x - 2.0f, y - 2.0f, 0.0f));
-            model = glm::scale(model, glm::vec3(width + 4.0f, height + 4.0f, 1.0f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
+    bool setTextAsync(const UIHandle& target, std::string text) {
+        UICommand command;
+        command.type = UICommandType::SetText;
+        command.target = target;
+        command.text = std::move(text);
+        return postCommand(std::move(command));
+    }
 
-            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    bool setItemsAsync(const UIHandle& target, std::vector<std::string> items) {
+        UICommand command;
+        command.type = UICommandType::SetItems;
+        command.target = target;
+        command.items = std::move(items);
+        return postCommand(std::move(command));
+    }
 
-            // Draw the list box background
-            model = glm::translate(glm::mat4(1.0f), glm::vec3(x, y, 0.0f));
-            model = glm::scale(model, glm::vec3(width, height, 1.0f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glUniform4f(fallbackColorLoc, 0.8f, 0.8f, 0.8f, 1.0f); // Light grey background
+    bool moveWidgetAsync(const UIHandle& target, int x, int y) {
+        UICommand command;
+        command.type = UICommandType::MoveWidget;
+        command.target = target;
+        command.x = x;
+        command.y = y;
+        return postCommand(std::move(command));
+    }
 
-            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    bool setVisibleAsync(const UIHandle& target, bool visible) {
+        UICommand command;
+        command.type = UICommandType::SetVisible;
+        command.target = target;
+        command.visible = visible;
+        return postCommand(std::move(command));
+    }
 
-            // Draw the items inside the list box
-            float itemHeight = 20.0f; // Example item height
-            float currentY = y + 5.0f; // Start drawing items a bit inside the box
-            for (size_t i = 0; i < items.size(); ++i) {
-                // Highlight the hovered item
-                if (i == hoveredItemIndex) {
-                    glm::mat4 highlightModel = glm::translate(glm::mat4(1.0f), glm::vec3(x, currentY, 0.0f));
-                    highlightModel = glm::scale(highlightModel, glm::vec3(width, itemHeight, 1.0f));
-                    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(highlightModel));
-                    glUniform4f(fallbackColorLoc, 0.5f, 0.5f, 0.5f, 1.0f); // Highlight color, e.g., a shade of grey
-                    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    // Returns false if the target is gone or is not of a kind the command applies to
+    bool applyCommand(UICommand& command) {
+        const HandleEntry* entry = resolveHandle(command.target);
+        if (!entry) {
+            return false;
+        }
+        UIComponent* component = entry->component;
+        switch (command.type) {
+        case UICommandType::SetText:
+            if (auto text = dynamic_cast<TextComponent*>(component)) {
+                text->setText(command.text);
+                return true;
+            }
+            if (auto button = dynamic_cast<ButtonComponent*>(component)) {
+                if (button->textComponent) {
+                    button->textComponent->setText(command.text); // Re-measures, so arrange() re-centers it
+                    return true;
                 }
+            }
+            return false;
+        case UICommandType::SetItems:
+            if (auto list = dynamic_cast<ListBoxComponent*>(component)) {
+                list->setItems(command.items);
+                return true;
+            }
+            return false;
+        case UICommandType::MoveWidget:
+            if (entry->widget) {
+                moveWidget(*entry->widget, command.x, command.y);
+                return true;
+            }
+            return false;
+        case UICommandType::SetVisible:
+            if (entry->widget) {
+                setWidgetVisible(*entry->widget, command.visible);
+                return true;
+            }
+            if (component) {
+                component->setVisible(command.visible);
+                return true;
+            }
+            return false;
+        }
+        return false;
+    }
 
-                // Update textComponent's text to the current item
-                textComponent->setText(items[i]);
-                // Adjust textComponent's position
-                textComponent->x = x + 5; // Start a bit inside from the left
-                textComponent->y = currentY + (itemHeight / 2.0f) - (textComponent->fontSize / 2.0f);
-                // Draw the textComponent
-                textComponent->Draw();
+    // Commands coalesce per (slot, kind). The generation is left out: only one generation of a
+    // slot is live, and commands for the others are set aside as stale before coalescing.
+    uint64_t commandKey(const UICommand& command) {
+        return (static_cast<uint64_t>(command.target.slot) << 8) | static_cast<uint64_t>(command.type);
+    }
 
-                currentY += itemHeight; // Move to the next item position
+    // UI thread: apply everything posted since the last call. Called by prepareFrame().
+    void applyQueuedCommands() {
+        UICommandQueue& queue = commandQueue(ui());
+        std::vector<UICommand>& batch = queue.batch;
+        batch.clear();
+        UICommand command;
+        while (queue.pending.pop(command)) {
+            batch.push_back(std::move(command));
+        }
+        if (batch.empty()) {
+            return;
+        }
+        // Last write wins: remember the last index per (target, kind), skip the others. Commands
+        // cannot free a handle, so a target that resolves here still resolves when applied.
+        queue.lastIndex.clear();
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (resolveHandle(batch[i].target)) {
+                queue.lastIndex[commandKey(batch[i])] = i;
+            }
+        }
+        for (size_t i = 0; i < batch.size(); ++i) {
+            auto last = queue.lastIndex.find(commandKey(batch[i]));
+            if (last == queue.lastIndex.end() || !resolveHandle(batch[i].target)) {
+                ++queue.stale;
+            }
+            else if (last->second != i) {
+                ++queue.coalesced;
             }
+            else if (applyCommand(batch[i])) {
+                ++queue.applied;
+            }
+            else {
+                ++queue.stale;
+            }
+        }
+        batch.clear(); // Frees the strings now rather than next frame
+    }
+
+    //////////////////////////////////////////////////////////
+    ////////////BINDINGS//////////////////////////////////////
+    //////////////////////////////////////////////////////////
+    // Bind a component property to application state instead of setting it every frame
+    // just in case. A source is either an Observable, whose set() queues the bindings that
+    // read it, or a versioned getter: a cheap counter polled once per frame, with the value
+    // only fetched and compared when the counter moved. prepareFrame() applies what changed,
+    // so observable bindings cost nothing while their value stays the same.
+    //
+    //     SV_UI::Observable<std::string> status("Idle");
+    //     SV_UI::bindText(SV_UI::Text("", 1.0f), status);
+    //     status.set("Loading"); // The label changes in the next frame
+    //
+    //     SV_UI::bindText(fpsLabel, [&] { return stats.version; }, [&] { return std::to_string(stats.fps); });
+    //
+    // A binding ends with its component, or never fires again once its Observable is gone.
+    // Observables belong to the UI thread; other threads post through the command queue.
+
+    struct ObservableBase;
+    struct BindingSet;
+
+    struct Binding {
+        UIComponent* target = nullptr;    // nullptr once unbound
+        ObservableBase* source = nullptr; // Observable bindings, nullptr once the observable is gone
+        BindingSet* owner = nullptr;
+        std::function<uint64_t()> version; // Versioned getter bindings only
+        std::function<void()> apply;       // Read the source and push the value into the target
+        uint64_t seenVersion = 0;
+        bool queued = false; // In owner->dirty
+    };
+
+    struct BindingSet {
+        std::unordered_map<UIComponent*, std::vector<std::unique_ptr<Binding>>> byTarget;
+        std::vector<Binding*> dirty;  // Observable bindings whose source changed since the last frame
+        std::vector<Binding*> polled; // Versioned getter bindings, checked every frame
+        std::vector<std::unique_ptr<Binding>> retired; // Unbound, freed once no list points at them
+        size_t applied = 0; // Bindings applied by the last refreshBindings(), for diagnostics
 
-            glBindVertexArray(0);
-            glUseProgram(0);
+        ~BindingSet(); // Detaches from observables that outlive the context
+    };
+
+    BindingSet& bindingSet();
+
+    void queueBinding(Binding& binding) {
+        if (!binding.queued && binding.target) {
+            binding.queued = true;
+            binding.owner->dirty.push_back(&binding);
+            requestRedraw();
         }
+    }
 
+    struct ObservableBase {
+        uint64_t version = 1;
+        std::vector<Binding*> bindings;
 
-        virtual void handleEvents(SDL_Event* event) override {
-            // Handle item selection, e.g., on mouse click
-            if (event->type == SDL_MOUSEBUTTONDOWN && event->button.button == SDL_BUTTON_LEFT) {
-                int mouseX = event->button.x;
-                int mouseY = event->button.y;
-                // Check if the click is within the list box bounds
-                if (mouseX > x && mouseX < x + width && mouseY > y && mouseY < y + height) {
-                    // Calculate which item was clicked
-                    int clickedItemIndex = (mouseY - y) / 20; // Assuming 20px per item for simplicity
-                    if (clickedItemIndex >= 0 && clickedItemIndex < items.size()) {
-                        selectedItemIndex = clickedItemIndex;
-                        if (onItemSelected) {
-                            onItemSelected(items[clickedItemIndex]); // Call the callback function with the selected item
-                        }
-                    }
-                }
+        ObservableBase() {}
+        ObservableBase(const ObservableBase&) = delete; // Bindings point at this object
+        ObservableBase& operator=(const ObservableBase&) = delete;
+
+        ~ObservableBase() {
+            for (auto binding : bindings) {
+                binding->source = nullptr;
             }
+        }
 
-            // Handle mouse motion for hover effect
-            if (event->type == SDL_MOUSEMOTION) {
-                int mouseX = event->motion.x;
-                int mouseY = event->motion.y;
-                // Check if the mouse is within the list box bounds
-                if (mouseX > x && mouseX < x + width && mouseY > y && mouseY < y + height) {
-                    hoveredItemIndex = (mouseY - y) / 20; // Assuming 20px per item for simplicity
-                    if (hoveredItemIndex < 0 || hoveredItemIndex >= items.size()) {
-                        hoveredItemIndex = -1;
-                    }
-                }
-                else {
-                    hoveredItemIndex = -1;
-                }
+        // Call after changing the value in place
+        void changed() {
+            ++version;
+            for (auto binding : bindings) {
+                queueBinding(*binding);
             }
         }
     };
 
+    template <typename T>
+    struct Observable : public ObservableBase {
+        T value;
 
+        Observable() : value() {}
+        explicit Observable(T value) : value(std::move(value)) {}
 
-    // Functions for Widget
-    void drawWidget(const Widget& widget) {
-        glUseProgram(shaderProgram);
+        const T& get() const {
+            return value;
+        }
 
-        // Set up transformation and projection matrices
-        glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(widget.x, widget.y, 0.0f));
-        model = glm::scale(model, glm::vec3(widget.width, widget.height, 1.0f));
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(model));
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+        // Setting an equal value does nothing
+        void set(T newValue) {
+            if (newValue == value) {
+                return;
+            }
+            value = std::move(newValue);
+            changed();
+        }
 
-        // Bind texture if available
-        int useTextureUniform = glGetUniformLocation(shaderProgram, "useTexture");
-        if (widget.texture) {
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, widget.texture);
-            glUniform1i(glGetUniformLocation(shaderProgram, "texture1"), 0);
-            glUniform1i(useTextureUniform, 1);
+        // Edit in place, e.g. append to a vector of items, without a compare
+        template <typename Edit>
+        void modify(Edit edit) {
+            edit(value);
+            changed();
         }
-        else {
-            glUniform1i(useTextureUniform, 0);
-            glUniform4f(glGetUniformLocation(shaderProgram, "fallbackColor"), 1.0f, 0.0f, 0.0f, 1.0f);
+    };
+
+    Binding* addBinding(UIComponent* target, std::function<void()> apply) {
+        BindingSet& set = bindingSet();
+        std::unique_ptr<Binding> binding(new Binding());
+        binding->target = target;
+        binding->owner = &set;
+        binding->apply = std::move(apply);
+        Binding* result = binding.get();
+        set.byTarget[target].push_back(std::move(binding));
+        return result;
+    }
+
+    // The target shows the observable's current value right away
+    template <typename T, typename Apply>
+    Binding* bindObservable(UIComponent* target, Observable<T>& source, Apply apply) {
+        if (!target) {
+            return nullptr;
         }
+        Observable<T>* observable = &source;
+        Binding* binding = addBinding(target, [observable, apply] { apply(observable->get()); });
+        binding->source = observable;
+        binding->seenVersion = source.version;
+        source.bindings.push_back(binding);
+        binding->apply();
+        return binding;
+    }
 
-        // Draw the widget's base rectangle
-        glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    // version() must change whenever get() would return something new; it is called every frame
+    template <typename Get, typename Apply>
+    Binding* bindVersioned(UIComponent* target, std::function<uint64_t()> version, Get get, Apply apply) {
+        if (!target) {
+            return nullptr;
+        }
+        Binding* binding = addBinding(target, [get, apply] { apply(get()); });
+        binding->version = std::move(version);
+        binding->seenVersion = binding->version();
+        bindingSet().polled.push_back(binding);
+        binding->apply();
+        return binding;
+    }
 
-      //draw each component after the widget
-        for (auto component : widget.components) {
-			component->Draw();
-		}
+    Binding* bindText(TextComponent* text, Observable<std::string>& source) {
+        return bindObservable(text, source, [text](const std::string& value) { text->setText(value); });
+    }
 
-        //if it has text make sure we draw that as well
-        if (widget.textComponent) {
-			widget.textComponent->Draw();
-		}
+    // For sources that are not strings, e.g. a score: bindText(label, score, [](const int& v) { return std::to_string(v); })
+    template <typename T, typename Format>
+    Binding* bindText(TextComponent* text, Observable<T>& source, Format format) {
+        return bindObservable(text, source, [text, format](const T& value) { text->setText(format(value)); });
+    }
 
-        glBindVertexArray(0);
-        glUseProgram(0);
+    Binding* bindText(TextComponent* text, std::function<uint64_t()> version, std::function<std::string()> get) {
+        return bindVersioned(text, std::move(version), std::move(get), [text](const std::string& value) { text->setText(value); });
     }
 
-    
+    Binding* bindVisible(UIComponent* component, Observable<bool>& source) {
+        return bindObservable(component, source, [component](bool value) { component->setVisible(value); });
+    }
 
+    Binding* bindVisible(UIComponent* component, std::function<uint64_t()> version, std::function<bool()> get) {
+        return bindVersioned(component, std::move(version), std::move(get), [component](bool value) { component->setVisible(value); });
+    }
 
+    // Packed RGBA, see packColor(); 0 falls back to the style's text color
+    Binding* bindColor(TextComponent* text, Observable<uint32_t>& source) {
+        return bindObservable(text, source, [text](uint32_t value) { text->setColor(value); });
+    }
 
-    void handleWidgetEvents(Widget& widget, SDL_Event* event) {
-        for (auto component : widget.components) {
-            component->handleEvents(event);
+    Binding* bindColor(TextComponent* text, std::function<uint64_t()> version, std::function<uint32_t()> get) {
+        return bindVersioned(text, std::move(version), std::move(get), [text](uint32_t value) { text->setColor(value); });
+    }
+
+    // setItems() resets the list, so equal contents are skipped here
+    void applyBoundItems(ListBoxComponent* list, const std::vector<std::string>& items) {
+        if (list->ownedSource && list->source == list->ownedSource.get() && list->ownedSource->items == items) {
+            return;
         }
-        if (widget.draggableComponent) {
-            handleDrag(*widget.draggableComponent, event);
+        list->setItems(items);
+    }
+
+    Binding* bindItems(ListBoxComponent* list, Observable<std::vector<std::string>>& source) {
+        return bindObservable(list, source, [list](const std::vector<std::string>& items) { applyBoundItems(list, items); });
+    }
+
+    Binding* bindItems(ListBoxComponent* list, std::function<uint64_t()> version, std::function<std::vector<std::string>()> get) {
+        return bindVersioned(list, std::move(version), std::move(get), [list](const std::vector<std::string>& items) { applyBoundItems(list, items); });
+    }
+
+    void detachBinding(Binding& binding) {
+        if (binding.source) {
+            std::vector<Binding*>& siblings = binding.source->bindings;
+            siblings.erase(std::remove(siblings.begin(), siblings.end(), &binding), siblings.end());
+            binding.source = nullptr;
         }
     }
 
-    // Public API functions
-    void createWidget(int id, int x, int y, int width, int height, int options, const std::string& texturePath) {
-        if (uiManager.isCreatingWidget) {
-            throw std::runtime_error("EndWidget must be called before calling a new widget");
+    // Drop every binding of a component; called by the UIComponent destructor
+    void unbindComponent(UIComponent* component) {
+        BindingSet& set = bindingSet();
+        if (set.byTarget.empty()) {
             return;
-       }
-        uiManager.isCreatingWidget = true;
-        auto widget = new Widget();
-        widget->ID = id;
-        widget->x = x;
-        widget->y = y;
-        widget->width = width;
-        widget->height = height;
-        widget->texture = 0;
+        }
+        auto it = set.byTarget.find(component);
+        if (it == set.byTarget.end()) {
+            return;
+        }
+        for (auto& binding : it->second) {
+            detachBinding(*binding);
+            binding->target = nullptr;
+            set.retired.push_back(std::move(binding)); // dirty or polled may still point at it
+        }
+        set.byTarget.erase(it);
+    }
 
-        SDL_Surface* surface = IMG_Load(texturePath.c_str());
-        if (surface) {
-            glGenTextures(1, &widget->texture);
-            glBindTexture(GL_TEXTURE_2D, widget->texture);
+    BindingSet::~BindingSet() {
+        for (auto& item : byTarget) {
+            for (auto& binding : item.second) {
+                detachBinding(*binding);
+            }
+        }
+    }
 
-            GLenum format;
-            if (surface->format->BytesPerPixel == 4) {
-                format = GL_RGBA;
+    // UI thread: push changed sources into their components. Called by prepareFrame().
+    void refreshBindings() {
+        BindingSet& set = bindingSet();
+        set.applied = 0;
+        for (Binding* binding : set.polled) {
+            if (!binding->target) {
+                continue;
             }
-            else {
-                format = GL_RGB;
+            uint64_t version = binding->version();
+            if (version != binding->seenVersion) {
+                binding->seenVersion = version;
+                binding->apply();
+                ++set.applied;
             }
-
-            glTexImage2D(GL_TEXTURE_2D, 0, format, surface->w, surface->h, 0, format, GL_UNSIGNED_BYTE, surface->pixels);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            SDL_FreeSurface(surface);
         }
-        else {
-            std::cerr << "Failed to load texture: " << IMG_GetError() << std::endl;
+        for (size_t i = 0; i < set.dirty.size(); ++i) {
+            Binding* binding = set.dirty[i];
+            binding->queued = false;
+            if (binding->target && binding->source && binding->source->version != binding->seenVersion) {
+                binding->seenVersion = binding->source->version; // Several set() calls in one frame apply once
+                binding->apply();
+                ++set.applied;
+            }
         }
+        set.dirty.clear();
+        if (!set.retired.empty()) {
+            set.polled.erase(std::remove_if(set.polled.begin(), set.polled.end(),
+                [](const Binding* binding) { return !binding->target; }), set.polled.end());
+            set.retired.clear();
+        }
+    }
 
-        if (hasFlag(options, WIDGET_DRAGGABLE)) {
-            widget->draggableComponent = new DraggableComponent();
-            widget->draggableComponent->parent = widget;
+    // Everything that mutates the UI once per frame, in order: queued commands from other
+    // threads, bound values, animations (which may invalidate layout), layout, then component
+    // updates that depend on final sizes. No GL: what it leaves for the GL thread is queued
+    // for syncComponentsGL(), so PipelinedRenderer runs this on its worker.
+    void prepareFrame() {
+        UIManager& manager = currentUIManager();
+        Uint32 now = SDL_GetTicks();
+        float dt = manager.lastUpdateTicks ? (now - manager.lastUpdateTicks) / 1000.0f : 0.0f;
+        manager.lastUpdateTicks = now;
+        applyQueuedCommands();
+        refreshBindings();
+        updateAnimations(dt);
+        layoutUI();
+        updateUI(dt);
+    }
+
+    // Parallel recording: each top-level widget's subtree is independent, so widgets are
+    // recorded into their own lists on a work-stealing pool and appended in z-order.
+    unsigned& currentRecordThreadCount(); // 1 records serially on the calling thread
+    std::unique_ptr<WorkStealingPool>& currentRecordPool(); // Per context, so contexts on different threads do not share workers
+    std::vector<DrawList>& currentWidgetDrawLists(); // One per widget, reused between frames
+    const size_t PARALLEL_RECORD_MIN_WIDGETS = 4; // Fewer widgets are recorded serially
+
+    // Number of threads recordUI() may use, including the caller; 0 means one per hardware thread
+    void setRecordThreads(unsigned threads) {
+        if (threads == 0) {
+            threads = defaultThreadCount();
+        }
+        if (threads == currentRecordThreadCount()) {
+            return;
         }
+        currentRecordThreadCount() = threads;
+        currentRecordPool().reset(); // Recreated with the new size on the next parallel frame
+    }
+
+    // Counters for the last recordUI(); read them after renderUI() (or in the pipeline's sync window)
+    struct FrameStats {
+        size_t widgets = 0;
+        size_t widgetsOccluded = 0;    // Entirely behind an opaque widget above, not recorded at all
+        size_t componentsOccluded = 0; // Behind an opaque widget above, in a partly covered widget
+        size_t culled = 0;             // Widgets, components and stack children off screen or clipped away
+        size_t drawCommands = 0;
+        size_t vertices = 0;
+    };
 
-        uiManager.widgets.push_back(widget);
-        uiManager.currentWidget = widget;
+    FrameStats& currentFrameStats();
+
+    // Occlusion: walking widgets front to back, a widget whose visible rect lies inside the
+    // rect of an opaque widget above it is hidden. Only single-occluder containment is tested,
+    // which covers stacked full-size panels without building a coverage region.
+    const uint32_t WIDGET_OCCLUDED = 0xffffffffu;
+    const size_t MAX_OCCLUDERS = 64; // Bounds the per-widget test; the topmost opaque widgets are kept
+    std::vector<ClipRect>& currentOccluderRects();  // Opaque widget rects, topmost first
+    std::vector<uint32_t>& occludersAbove(); // Per widget: how many occluderRects are above it, or WIDGET_OCCLUDED
+
+    void computeOcclusion(const std::vector<Widget*>& widgets, const ClipRect& view) {
+        std::vector<ClipRect>& occluders = currentOccluderRects();
+        std::vector<uint32_t>& above = occludersAbove();
+        occluders.clear();
+        above.resize(widgets.size());
+        for (size_t i = widgets.size(); i-- > 0;) {
+            const Widget& widget = *widgets[i];
+            if (!widget.visible) {
+                above[i] = static_cast<uint32_t>(occluders.size()); // recordWidget() skips it
+                continue;
+            }
+            ClipRect rect = view.intersection(static_cast<float>(widget.x), static_cast<float>(widget.y),
+                static_cast<float>(widget.width), static_cast<float>(widget.height));
+            bool hidden = false;
+            if (rect.width > 0.0f && rect.height > 0.0f) {
+                for (const ClipRect& occluder : occluders) {
+                    if (occluder.contains(rect.x, rect.y, rect.width, rect.height)) {
+                        hidden = true;
+                        break;
+                    }
+                }
+            }
+            above[i] = hidden ? WIDGET_OCCLUDED : static_cast<uint32_t>(occluders.size());
+            if (!hidden && rect.width > 0.0f && rect.height > 0.0f && occluders.size() < MAX_OCCLUDERS && isOpaque(widget)) {
+                occluders.push_back(rect);
+            }
+        }
     }
 
-   
+    void updateFrameStats(const DrawList& list, size_t widgets, size_t widgetsOccluded) {
+        FrameStats& stats = currentFrameStats();
+        stats.widgets = widgets;
+        stats.widgetsOccluded = widgetsOccluded;
+        stats.componentsOccluded = list.occluded;
+        stats.culled = list.culled;
+        stats.drawCommands = list.commands.size();
+        stats.vertices = list.vertices.size() + list.shapeVertices.size();
+    }
 
-    void beginWidget(int id) {
-        for (auto widget : uiManager.widgets) {
-            if (widget->ID == id) {
-                uiManager.currentWidget = widget;
-                return;
+    // Record every widget into list, in creation order (later widgets draw on top)
+    void recordUI(DrawList& list) {
+        std::vector<Widget*>& widgets = currentUIManager().widgets;
+        list.view = viewportClip();
+        computeOcclusion(widgets, list.view);
+        const std::vector<uint32_t>& above = occludersAbove();
+        const ClipRect* occluders = currentOccluderRects().data();
+        size_t widgetsOccluded = 0;
+        for (uint32_t count : above) {
+            widgetsOccluded += count == WIDGET_OCCLUDED;
+        }
+        unsigned threads = currentRecordThreadCount();
+        if (threads <= 1 || widgets.size() < PARALLEL_RECORD_MIN_WIDGETS) {
+            for (size_t i = 0; i < widgets.size(); ++i) {
+                if (above[i] != WIDGET_OCCLUDED) {
+                    recordWidget(*widgets[i], list, occluders, above[i]);
+                }
             }
+            updateFrameStats(list, widgets.size(), widgetsOccluded);
+            return;
         }
-       
+        std::unique_ptr<WorkStealingPool>& pool = currentRecordPool();
+        if (!pool) {
+            pool.reset(new WorkStealingPool(threads));
+        }
+        std::vector<DrawList>& lists = currentWidgetDrawLists();
+        if (lists.size() < widgets.size()) {
+            lists.resize(widgets.size());
+        }
+        UIContext* owner = &ui();
+        pool->run(widgets.size(), [&](size_t i) {
+            ContextScope scope(owner); // Pool threads resolve styles through the recording context
+            lists[i].clear();
+            lists[i].view = list.view;
+            lists[i].clip = list.clip;
+            if (above[i] != WIDGET_OCCLUDED) {
+                recordWidget(*widgets[i], lists[i], occluders, above[i]);
+            }
+        });
+        size_t recordingBytes = 0;
+        for (size_t i = 0; i < widgets.size(); ++i) {
+            list.append(lists[i]);
+            recordingBytes += lists[i].capacityBytes();
+        }
+        trackResource(ResourceKind::Host, resourceHandle(&lists), recordingBytes, "DrawList");
+        updateFrameStats(list, widgets.size(), widgetsOccluded);
     }
 
-    void Text(const std::string& text, float fontSize) {
-		if (!uiManager.currentWidget) {
-			std::cerr << "No widget selected" << std::endl;
-			return;
-		}
-		auto textComponent = new TextComponent(text, fontSize);
-        textComponent->y = static_cast<float>(uiManager.currentWidget->y);
-        textComponent->x = static_cast<float>(uiManager.currentWidget->x);
-		textComponent->width = uiManager.currentWidget->width;
-		textComponent->height = uiManager.currentWidget->height;
-		textComponent->parent = uiManager.currentWidget;
-		uiManager.currentWidget->components.push_back(textComponent);
-	}
+    DrawList& currentFrameDrawList(); // Reused by renderUI() so steady-state frames do not allocate
 
-    void Button(const std::string& text, float fontSize, const std::string& texturePath, std::function<void()> onClick, int buttonWidth = 100, int buttonHeight = 50, Alignment alignment = Alignment::BottomCenter) {
-        if (!uiManager.currentWidget) {
-            std::cerr << "No widget selected" << std::endl;
+    // Serial frame: animate, layout, update, record and submit on the calling (GL) thread.
+    // See sv_ui_pipeline.h for preparing and recording on a worker thread instead.
+    void renderUI() {
+        prepareFrame();
+        syncComponentsGL();
+        DrawList& list = currentFrameDrawList();
+        list.clear();
+        recordUI(list);
+        submitDrawList(list); // One upload and a handful of draw calls for the whole UI
+        trackResource(ResourceKind::Host, resourceHandle(&list), list.capacityBytes(), "DrawList");
+    }
+
+    void handleEvents(SDL_Event* event) {
+        if (event->type == SDL_WINDOWEVENT) {
+            requestRedraw(); // Exposed, resized, restored: the back buffer must be redrawn
+        }
+        layoutUI(); // Hit tests need positions before the first frame is drawn
+        for (auto widget : currentUIManager().widgets) {
+            handleWidgetEvents(*widget, event);
+        }
+    }
+
+    void bindWindow(SDL_Window* window); // Defined in the UI CONTEXTS section
+    bool routeEvent(const SDL_Event& event);
+
+    // Event loop that only renders when something requested a redraw. onEvent sees every
+    // event before the widgets and returns false to leave the loop; onFrame draws the
+    // application and calls renderUI(), then runUI() swaps. While nothing is dirty the
+    // thread sleeps in SDL_WaitEventTimeout instead of rendering identical frames.
+    // idleTimeoutMs bounds the sleep so requestRedraw() calls without an event are noticed.
+    // Run it on the main thread, which is where SDL delivers events; events of windows whose
+    // contexts run runRoutedUI() on other threads are forwarded to them.
+    void runUI(SDL_Window* window, const std::function<bool(SDL_Event&)>& onEvent, const std::function<void()>& onFrame, int idleTimeoutMs = 250) {
+        bindWindow(window);
+        bool running = true;
+        SDL_Event event;
+        while (running) {
+            bool haveEvent = false;
+            if (!currentRedrawRequested().load(std::memory_order_relaxed)) {
+                haveEvent = SDL_WaitEventTimeout(&event, idleTimeoutMs) != 0;
+            }
+            else {
+                haveEvent = SDL_PollEvent(&event) != 0;
+            }
+            while (haveEvent && running) {
+                if (routeEvent(event)) {
+                    // Another window's event, now queued for its context's thread
+                }
+                else if (event.type == SDL_QUIT || (onEvent && !onEvent(event))) {
+                    running = false;
+                }
+                else {
+                    handleEvents(&event);
+                }
+                haveEvent = SDL_PollEvent(&event) != 0;
+            }
+            if (running && currentRedrawRequested().exchange(false)) {
+                // Cleared before drawing, so requests made while drawing (animations) schedule the next frame
+                if (onFrame) {
+                    onFrame();
+                }
+                SDL_GL_SwapWindow(window);
+            }
+        }
+    }
+
+    // Delete a widget with its components and texture. Call from the UI thread, outside event handling.
+    void destroyWidget(int id) {
+        UIManager& manager = currentUIManager();
+        auto it = std::find_if(manager.widgets.begin(), manager.widgets.end(), [id](Widget* widget) { return widget->ID == id; });
+        if (it == manager.widgets.end()) {
             return;
         }
-        auto buttonComponent = new ButtonComponent(text, fontSize, texturePath, onClick, buttonWidth, buttonHeight);
-        buttonComponent->y = static_cast<float>(uiManager.currentWidget->y);
-        buttonComponent->x = static_cast<float>(uiManager.currentWidget->x);
-        // Set buttonComponent's width and height to the specified values or defaults
-        buttonComponent->width = buttonWidth;
-        buttonComponent->height = buttonHeight;
-        buttonComponent->parent = uiManager.currentWidget;
-        uiManager.currentWidget->components.push_back(buttonComponent);
+        Widget* widget = *it;
+        manager.widgets.erase(it);
+        if (manager.currentWidget == widget) {
+            manager.currentWidget = nullptr;
+            manager.stackStack.clear();
+            manager.isCreatingWidget = false;
+        }
+        delete widget;
+        requestRedraw();
     }
 
-   void ListBox(const std::vector<std::string>& items, std::function<void(const std::string&)> onItemSelected,int ListBoxwidth = 100, int ListBoxheight = 100) {
-		if (!uiManager.currentWidget) {
-			std::cerr << "No widget selected" << std::endl;
-			return;
-		}
-		auto listBoxComponent = new ListBoxComponent(items, onItemSelected, ListBoxwidth,ListBoxheight);
-		listBoxComponent->y = static_cast<float>(uiManager.currentWidget->y);
-		listBoxComponent->x = static_cast<float>(uiManager.currentWidget->x);
-        listBoxComponent->width = ListBoxwidth;
-		listBoxComponent->height = ListBoxheight;
-		listBoxComponent->parent = uiManager.currentWidget;
-		uiManager.currentWidget->components.push_back(listBoxComponent);
-	}
-    void endWidget() {
-        uiManager.currentWidget = nullptr;
-        uiManager.isCreatingWidget = false;
+    // Free every widget and the GL objects from initOpenGL(), then report anything still
+    // tracked (see sv_ui_memory.h). Call once before destroying the GL context.
+    bool shutdownUI(bool report = true) {
+        for (auto widget : currentUIManager().widgets) {
+            delete widget;
+        }
+        currentUIManager() = UIManager();
+
+        untrackResource(ResourceKind::Host, resourceHandle(&currentFrameDrawList()));
+        currentFrameDrawList() = DrawList();
+        untrackResource(ResourceKind::Host, resourceHandle(&currentWidgetDrawLists()));
+        std::vector<DrawList>().swap(currentWidgetDrawLists());
+        if (currentVAO()) {
+            // A context that never ran initOpenGL() has no GL objects and may have no GL context
+            releaseDrawListRenderer();
+            glDeleteBuffers(1, &currentVBO());
+            glDeleteBuffers(1, &currentEBO());
+            glDeleteVertexArrays(1, &currentVAO());
+            glDeleteProgram(currentShaderProgram());
+            std::lock_guard<std::mutex> lock(glTextMutex);
+            if (--glTextUsers == 0) {
+                gltTerminate();
+            }
+        }
+        currentVAO() = currentVBO() = currentEBO() = currentShaderProgram() = 0;
+        return report ? reportLeaks() : true;
     }
 
-    void renderUI() {
-        for (auto& widget : uiManager.widgets) {
-            drawWidget(*widget); // Draw the widget itself
+    //////////////////////////////////////////////////////////
+    ////////////UI CONTEXTS///////////////////////////////////
+    //////////////////////////////////////////////////////////
+    // All UI state belongs to a UIContext: widgets, GL objects, draw lists, animations,
+    // theme, resource accounting. Each thread has a current context; a thread that never
+    // sets one uses the process's default context, so single-window programs need no changes.
+    //
+    //     // On the thread that renders the second display, with its GL context current:
+    //     SV_UI::UIContext* second = SV_UI::createContext();
+    //     SV_UI::setCurrentContext(second);
+    //     SV_UI::initOpenGL();
+    //     SV_UI::setProjectionMatrix(1920, 1080);
+    //     ... createWidget(), renderUI() ...
+    //     SV_UI::destroyContext(second); // GL context still current
+    //
+    // Contexts used concurrently must be current on different threads; one context must
+    // only be used by one thread at a time (the pipeline's worker and the record pool
+    // borrow the caller's context while it waits). GL contexts must share objects with the
+    // first one that called initOpenGL() (SDL_GL_SHARE_WITH_CURRENT_CONTEXT), because
+    // glText's program and font texture exist once per process.
+    //
+    // SDL only delivers events on the main thread. Run runUI() there (or a loop calling
+    // routeEvent()), and runRoutedUI() on each other display's thread: every event that
+    // names a window (input, window, drop events) goes to the context bound to that window,
+    // and SDL_QUIT goes to all of them.
+    //
+    //     std::thread second([&]() {
+    //         SDL_GL_MakeCurrent(secondWindow, secondGL);
+    //         SV_UI::ContextScope scope(secondContext);
+    //         SV_UI::runRoutedUI(secondWindow, nullptr, [&]() { ... SV_UI::renderUI(); });
+    //     });
+    //     SV_UI::runUI(mainWindow, nullptr, [&]() { ... SV_UI::renderUI(); });
+
+    struct UIContext {
+        GLuint shaderProgram = 0;
+        GLuint VAO = 0, VBO = 0, EBO = 0;
+        glm::mat4 projection = glm::mat4(1.0f);
+        int viewportWidth = 0, viewportHeight = 0;
+        UIManager uiManager;
+        std::atomic<bool> redrawRequested{ true };
+        ClipRect eventClip;
+        DrawListRenderer drawListRenderer;
+        Animator animator;
+        unsigned recordThreadCount = 1;
+        std::unique_ptr<WorkStealingPool> recordPool;
+        std::vector<DrawList> widgetDrawLists;
+        FrameStats frameStats;
+        std::vector<ClipRect> occluderRects;
+        std::vector<uint32_t> occludersAbove;
+        DrawList frameDrawList;
+        const CompiledTheme* activeTheme = &builtinTheme;
+        Styles styles;
+        ResourceTracker resourceTracker;
+        HandleTable handleTable;
+        UICommandQueue commands;
+        BindingSet bindings;
+        std::vector<std::shared_ptr<void>> extensions; // State of optional headers, see contextState()
+
+        // Event routing, see routeEvent()
+        Uint32 windowID = 0; // SDL window this context draws into, 0 until bindWindow()
+        std::atomic<bool> routedEvents{ false }; // Its thread waits in runRoutedUI() rather than on SDL's queue
+        std::mutex inboxMutex;
+        std::condition_variable inboxReady;
+        std::vector<SDL_Event> inbox;
+
+        UIContext() = default;
+        UIContext(const UIContext&) = delete;
+        UIContext& operator=(const UIContext&) = delete;
+    };
+
+    UIContext& defaultUIContext() {
+        static UIContext context;
+        return context;
+    }
+
+    UIContext& ui() {
+        return currentUIContext ? *currentUIContext : defaultUIContext();
+    }
+
+    std::mutex contextsMutex;
+    std::vector<UIContext*> createdContexts; // Every context but the default one, for event routing
+
+    UIContext* createContext() {
+        UIContext* context = new UIContext();
+        std::lock_guard<std::mutex> lock(contextsMutex);
+        createdContexts.push_back(context);
+        return context;
+    }
+
+    // nullptr makes the default context current again
+    void setCurrentContext(UIContext* context) {
+        currentUIContext = context;
+    }
+
+    UIContext* getCurrentContext() {
+        return &ui();
+    }
+
+    // Shuts the context down (see shutdownUI()) and frees it. Its GL context must be current.
+    bool destroyContext(UIContext* context, bool report = true) {
+        if (!context || context == &defaultUIContext()) {
+            return false;
+        }
+        bool clean;
+        {
+            ContextScope scope(context);
+            clean = shutdownUI(report);
+        }
+        if (currentUIContext == context) {
+            currentUIContext = nullptr;
+        }
+        {
+            std::lock_guard<std::mutex> lock(contextsMutex);
+            createdContexts.erase(std::remove(createdContexts.begin(), createdContexts.end(), context), createdContexts.end());
+        }
+        delete context;
+        return clean;
+    }
+
+    // The current context draws into window; its events are routed here
+    void bindWindow(SDL_Window* window) {
+        ui().windowID = SDL_GetWindowID(window);
+    }
 
-            // Now draw the components of the widget
-            for (auto& component : widget->components) {
-                component->Draw(); // This includes TextComponent, ButtonComponent, and dropDownComponent
+    // The window an event belongs to, 0 for events that name none
+    Uint32 eventWindowID(const SDL_Event& event) {
+        switch (event.type) {
+        case SDL_WINDOWEVENT: return event.window.windowID;
+        case SDL_KEYDOWN:
+        case SDL_KEYUP: return event.key.windowID;
+        case SDL_TEXTEDITING: return event.edit.windowID;
+        case SDL_TEXTINPUT: return event.text.windowID;
+        case SDL_MOUSEMOTION: return event.motion.windowID;
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP: return event.button.windowID;
+        case SDL_MOUSEWHEEL: return event.wheel.windowID;
+        case SDL_DROPFILE:
+        case SDL_DROPTEXT:
+        case SDL_DROPBEGIN:
+        case SDL_DROPCOMPLETE: return event.drop.windowID;
+        default: return event.type >= SDL_USEREVENT ? event.user.windowID : 0;
+        }
+    }
+
+    void postRoutedEvent(UIContext& context, const SDL_Event& event) {
+        {
+            std::lock_guard<std::mutex> lock(context.inboxMutex);
+            context.inbox.push_back(event);
+        }
+        context.inboxReady.notify_one();
+    }
 
-               
+    // On the thread polling SDL: hand event to the runRoutedUI() thread of the context bound
+    // to its window. Returns false when the caller should handle it itself: the window is its
+    // own or nobody's, or the event names no window. SDL_QUIT is also posted to every routed
+    // context, and still returns false.
+    bool routeEvent(const SDL_Event& event) {
+        std::lock_guard<std::mutex> lock(contextsMutex);
+        if (event.type == SDL_QUIT) {
+            for (UIContext* context : createdContexts) {
+                if (context->routedEvents && context != &ui()) {
+                    postRoutedEvent(*context, event);
+                }
+            }
+            return false;
+        }
+        Uint32 windowID = eventWindowID(event);
+        if (windowID == 0 || windowID == ui().windowID) {
+            return false;
+        }
+        for (UIContext* context : createdContexts) {
+            if (context->windowID == windowID && context->routedEvents) {
+                postRoutedEvent(*context, event);
+                return true;
             }
         }
+        return false;
     }
 
-    void handleEvents(SDL_Event* event) {
-        for (auto widget : uiManager.widgets) {
-            handleWidgetEvents(*widget, event);
+    // Wakes runRoutedUI() for a redraw request; false if context is not routed
+    bool wakeRoutedContext(UIContext& context) {
+        if (!context.routedEvents) {
+            return false;
+        }
+        {
+            std::lock_guard<std::mutex> lock(context.inboxMutex); // So the wait cannot miss the request
         }
+        context.inboxReady.notify_one();
+        return true;
     }
 
+    // runUI() for a context on a thread other than the main one: takes the events routeEvent()
+    // forwards to this context's window instead of polling SDL, otherwise the same loop.
+    // The context and the window's GL context must be current on the calling thread.
+    void runRoutedUI(SDL_Window* window, const std::function<bool(SDL_Event&)>& onEvent, const std::function<void()>& onFrame, int idleTimeoutMs = 250) {
+        UIContext& context = ui();
+        bindWindow(window);
+        context.routedEvents = true;
+        std::vector<SDL_Event> events;
+        bool running = true;
+        while (running) {
+            {
+                std::unique_lock<std::mutex> lock(context.inboxMutex);
+                context.inboxReady.wait_for(lock, std::chrono::milliseconds(idleTimeoutMs), [&context]() {
+                    return !context.inbox.empty() || context.redrawRequested.load(std::memory_order_relaxed);
+                });
+                events.swap(context.inbox);
+            }
+            for (SDL_Event& event : events) {
+                if (event.type == SDL_QUIT || (onEvent && !onEvent(event))) {
+                    running = false;
+                    break;
+                }
+                handleEvents(&event);
+            }
+            events.clear();
+            if (running && context.redrawRequested.exchange(false)) {
+                if (onFrame) {
+                    onFrame();
+                }
+                SDL_GL_SwapWindow(window);
+            }
+        }
+        context.routedEvents = false;
+    }
+
+    std::atomic<size_t> nextContextStateSlot{ 0 };
+
+    // Per-context state for headers that build on this one (e.g. the immediate-mode UI):
+    // one T per context, created on first use in that context
+    template <typename T>
+    T& contextState(UIContext& context) {
+        static const size_t slot = nextContextStateSlot++;
+        std::vector<std::shared_ptr<void>>& extensions = context.extensions;
+        if (extensions.size() <= slot) {
+            extensions.resize(slot + 1);
+        }
+        if (!extensions[slot]) {
+            extensions[slot] = std::make_shared<T>();
+        }
+        return *static_cast<T*>(extensions[slot].get());
+    }
+
+    template <typename T>
+    T& contextState() {
+        return contextState<T>(ui());
+    }
+
+    GLuint& currentShaderProgram() { return ui().shaderProgram; }
+    GLuint& currentVAO() { return ui().VAO; }
+    GLuint& currentVBO() { return ui().VBO; }
+    GLuint& currentEBO() { return ui().EBO; }
+    glm::mat4& currentProjection() { return ui().projection; }
+    int& currentViewportWidth() { return ui().viewportWidth; }
+    int& currentViewportHeight() { return ui().viewportHeight; }
+    UIManager& currentUIManager() { return ui().uiManager; }
+    std::atomic<bool>& currentRedrawRequested() { return ui().redrawRequested; }
+    ClipRect& currentEventClip() { return ui().eventClip; }
+    DrawListRenderer& currentDrawListRenderer() { return ui().drawListRenderer; }
+    Animator& currentAnimator() { return ui().animator; }
+    unsigned& currentRecordThreadCount() { return ui().recordThreadCount; }
+    std::unique_ptr<WorkStealingPool>& currentRecordPool() { return ui().recordPool; }
+    std::vector<DrawList>& currentWidgetDrawLists() { return ui().widgetDrawLists; }
+    FrameStats& currentFrameStats() { return ui().frameStats; }
+    std::vector<ClipRect>& currentOccluderRects() { return ui().occluderRects; }
+    std::vector<uint32_t>& occludersAbove() { return ui().occludersAbove; }
+    DrawList& currentFrameDrawList() { return ui().frameDrawList; }
+    const CompiledTheme*& currentActiveTheme() { return ui().activeTheme; }
+    Styles& currentStyles() { return ui().styles; }
+    ResourceTracker& currentResourceTracker() { return ui().resourceTracker; }
+    HandleTable& handleTable() { return ui().handleTable; }
+    BindingSet& bindingSet() { return ui().bindings; }
+    UICommandQueue& commandQueue(UIContext& context) { return context.commands; }
+
+    // The former globals under their old names, for code written before contexts existed.
+    // They always refer to the default context; use the current*() accessors in code that
+    // may run with another context current.
+    GLuint& shaderProgram = defaultUIContext().shaderProgram;
+    GLuint& VAO = defaultUIContext().VAO;
+    GLuint& VBO = defaultUIContext().VBO;
+    GLuint& EBO = defaultUIContext().EBO;
+    glm::mat4& projection = defaultUIContext().projection;
+    int& viewportWidth = defaultUIContext().viewportWidth;
+    int& viewportHeight = defaultUIContext().viewportHeight;
+    UIManager& uiManager = defaultUIContext().uiManager;
+    std::atomic<bool>& redrawRequested = defaultUIContext().redrawRequested;
+    ClipRect& eventClip = defaultUIContext().eventClip;
+    DrawListRenderer& drawListRenderer = defaultUIContext().drawListRenderer;
+    Animator& animator = defaultUIContext().animator;
+    unsigned& recordThreadCount = defaultUIContext().recordThreadCount;
+    std::unique_ptr<WorkStealingPool>& recordPool = defaultUIContext().recordPool;
+    std::vector<DrawList>& widgetDrawLists = defaultUIContext().widgetDrawLists;
+    FrameStats& frameStats = defaultUIContext().frameStats;
+    std::vector<ClipRect>& occluderRects = defaultUIContext().occluderRects;
+    DrawList& frameDrawList = defaultUIContext().frameDrawList;
+    const CompiledTheme*& activeTheme = defaultUIContext().activeTheme;
+    Styles& styles = defaultUIContext().styles;
+    ResourceTracker& resourceTracker = defaultUIContext().resourceTracker;
+
     // Additional utility functions and widget operations can be defined here...
 
 } // namespace SV_UI
@@ -0,0 +1,177 @@
+#pragma once
+
+//////////////////////////////////////////////////////////
+////////////SV UI ANIMATION TRACKS////////////////////////
+//////////////////////////////////////////////////////////
+// Number crunching behind SV_UI's tweens. Tracks are grouped by easing curve
+// and stored structure-of-arrays, so one frame is a straight pass over a few
+// float arrays per curve, four tracks at a time with SSE (scalar elsewhere).
+// What a track animates is not known here; sv_ui3.0.h maps finished values
+// onto widgets and components (see the ANIMATION section there).
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SV_UI_ANIMATION_SSE 1
+#endif
+
+namespace SV_UI {
+
+    enum class Easing : uint8_t {
+        Linear,
+        InQuad,
+        OutQuad,
+        InOutQuad,
+        OutCubic,
+        InOutCubic,
+        Count
+    };
+
+    // t in [0, 1]
+    inline float ease(Easing easing, float t) {
+        switch (easing) {
+        case Easing::InQuad:
+            return t * t;
+        case Easing::OutQuad:
+            return t * (2.0f - t);
+        case Easing::InOutQuad:
+            return t < 0.5f ? 2.0f * t * t : 1.0f - 2.0f * (1.0f - t) * (1.0f - t);
+        case Easing::OutCubic: {
+            float u = 1.0f - t;
+            return 1.0f - u * u * u;
+        }
+        case Easing::InOutCubic: {
+            float u = 1.0f - t;
+            return t < 0.5f ? 4.0f * t * t * t : 1.0f - 4.0f * u * u * u;
+        }
+        default:
+            return t;
+        }
+    }
+
+#ifdef SV_UI_ANIMATION_SSE
+    template <Easing E>
+    inline __m128 easeSSE(__m128 t) {
+        const __m128 one = _mm_set1_ps(1.0f);
+        switch (E) {
+        case Easing::InQuad:
+            return _mm_mul_ps(t, t);
+        case Easing::OutQuad:
+            return _mm_mul_ps(t, _mm_sub_ps(_mm_set1_ps(2.0f), t));
+        case Easing::InOutQuad: {
+            __m128 u = _mm_sub_ps(one, t);
+            __m128 low = _mm_mul_ps(_mm_set1_ps(2.0f), _mm_mul_ps(t, t));
+            __m128 high = _mm_sub_ps(one, _mm_mul_ps(_mm_set1_ps(2.0f), _mm_mul_ps(u, u)));
+            __m128 isLow = _mm_cmplt_ps(t, _mm_set1_ps(0.5f));
+            return _mm_or_ps(_mm_and_ps(isLow, low), _mm_andnot_ps(isLow, high));
+        }
+        case Easing::OutCubic: {
+            __m128 u = _mm_sub_ps(one, t);
+            return _mm_sub_ps(one, _mm_mul_ps(u, _mm_mul_ps(u, u)));
+        }
+        case Easing::InOutCubic: {
+            __m128 u = _mm_sub_ps(one, t);
+            __m128 four = _mm_set1_ps(4.0f);
+            __m128 low = _mm_mul_ps(four, _mm_mul_ps(t, _mm_mul_ps(t, t)));
+            __m128 high = _mm_sub_ps(one, _mm_mul_ps(four, _mm_mul_ps(u, _mm_mul_ps(u, u))));
+            __m128 isLow = _mm_cmplt_ps(t, _mm_set1_ps(0.5f));
+            return _mm_or_ps(_mm_and_ps(isLow, low), _mm_andnot_ps(isLow, high));
+        }
+        default:
+            return t;
+        }
+    }
+#endif
+
+    // All tracks that use one easing curve. Index order is not stable: removeAt() swaps
+    // the last track into the hole, and the caller follows it through ids.
+    struct TrackPool {
+        std::vector<float> from, delta, elapsed, invDuration, value;
+        std::vector<uint32_t> ids; // Caller's handle for each track
+
+        size_t size() const {
+            return ids.size();
+        }
+
+        // delay > 0 holds the start value for that many seconds
+        size_t add(uint32_t id, float start, float end, float duration, float delay) {
+            from.push_back(start);
+            delta.push_back(end - start);
+            elapsed.push_back(-delay);
+            invDuration.push_back(duration > 0.0f ? 1.0f / duration : 1e30f);
+            value.push_back(start);
+            ids.push_back(id);
+            return ids.size() - 1;
+        }
+
+        // Returns the id of the track moved into index, or the removed id if it was last
+        uint32_t removeAt(size_t index) {
+            size_t last = ids.size() - 1;
+            uint32_t moved = ids[last];
+            from[index] = from[last];
+            delta[index] = delta[last];
+            elapsed[index] = elapsed[last];
+            invDuration[index] = invDuration[last];
+            value[index] = value[last];
+            ids[index] = moved;
+            from.pop_back();
+            delta.pop_back();
+            elapsed.pop_back();
+            invDuration.pop_back();
+            value.pop_back();
+            ids.pop_back();
+            return moved;
+        }
+
+        // Step every track by dt and recompute value; indices of tracks that reached
+        // their end are appended to finished
+        void advance(float dt, Easing easing, std::vector<uint32_t>& finished) {
+            switch (easing) {
+            case Easing::InQuad: advanceWith<Easing::InQuad>(dt, finished); break;
+            case Easing::OutQuad: advanceWith<Easing::OutQuad>(dt, finished); break;
+            case Easing::InOutQuad: advanceWith<Easing::InOutQuad>(dt, finished); break;
+            case Easing::OutCubic: advanceWith<Easing::OutCubic>(dt, finished); break;
+            case Easing::InOutCubic: advanceWith<Easing::InOutCubic>(dt, finished); break;
+            default: advanceWith<Easing::Linear>(dt, finished); break;
+            }
+        }
+
+        template <Easing E>
+        void advanceWith(float dt, std::vector<uint32_t>& finished) {
+            size_t count = ids.size();
+            size_t i = 0;
+#ifdef SV_UI_ANIMATION_SSE
+            const __m128 step = _mm_set1_ps(dt);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+            for (; i + 4 <= count; i += 4) {
+                __m128 e = _mm_add_ps(_mm_loadu_ps(&elapsed[i]), step);
+                _mm_storeu_ps(&elapsed[i], e);
+                __m128 raw = _mm_mul_ps(e, _mm_loadu_ps(&invDuration[i]));
+                __m128 t = _mm_min_ps(_mm_max_ps(raw, zero), one);
+                __m128 v = _mm_add_ps(_mm_loadu_ps(&from[i]), _mm_mul_ps(_mm_loadu_ps(&delta[i]), easeSSE<E>(t)));
+                _mm_storeu_ps(&value[i], v);
+                int done = _mm_movemask_ps(_mm_cmpge_ps(raw, one));
+                while (done) {
+                    int lane = 0;
+                    while (!(done & (1 << lane))) ++lane;
+                    finished.push_back(static_cast<uint32_t>(i + lane));
+                    done &= ~(1 << lane);
+                }
+            }
+#endif
+            for (; i < count; ++i) {
+                elapsed[i] += dt;
+                float raw = elapsed[i] * invDuration[i];
+                float t = raw < 0.0f ? 0.0f : (raw > 1.0f ? 1.0f : raw);
+                value[i] = from[i] + delta[i] * ease(E, t);
+                if (raw >= 1.0f) {
+                    finished.push_back(static_cast<uint32_t>(i));
+                }
+            }
+        }
+    };
+}
@@ -0,0 +1,357 @@
+#pragma once
+
+//////////////////////////////////////////////////////////
+////////////SV UI CONSOLE/////////////////////////////////
+//////////////////////////////////////////////////////////
+// A log view for high line rates:
+//
+//     auto* console = SV_UI::Console(8 << 20, 600, 300); // At most 8 MB of log
+//     // Any thread:
+//     console->append("listening on :8080");
+//     console->append(message, SV_UI::ConsoleSeverity::Error);
+//
+// Lines go into a fixed arena: a ring of bytes for the text and a ring of line
+// records pointing into it. When either is full the oldest lines are dropped,
+// so memory never grows past the configured size and appending never
+// allocates. Producers hold a mutex only for a memcpy; the UI thread holds it
+// only to copy out the lines it is about to show.
+//
+// Like ListBox rows, only visible lines get glyphs, from a ring of text objects
+// keyed by line number. Lines never change once appended, so a line's glyphs
+// are built once while it stays on screen, and a frame costs at most one
+// screenful of glyph building however many lines arrived since the last one.
+//
+// While the view is at the bottom it follows new lines; scrolling up stops
+// that, and scrolling back down (or End) resumes it.
+//
+// Line text takes its color from the Console style part: Normal for Info, and
+// the Trace, Debug, Warning and Error states for the other severities.
+
+#include "sv_ui3.0.h"
+#include <mutex>
+
+namespace SV_UI {
+
+    enum class ConsoleSeverity : uint8_t {
+        Trace,
+        Debug,
+        Info,
+        Warning,
+        Error,
+        Count
+    };
+
+    // Style state a line's text color is looked up with, in the Console part
+    inline StyleState severityState(ConsoleSeverity severity) {
+        switch (severity) {
+        case ConsoleSeverity::Trace: return StyleState::Trace;
+        case ConsoleSeverity::Debug: return StyleState::Debug;
+        case ConsoleSeverity::Warning: return StyleState::Warning;
+        case ConsoleSeverity::Error: return StyleState::Error;
+        default: return StyleState::Normal;
+        }
+    }
+
+    struct ConsoleLine {
+        uint64_t offset = 0; // Absolute position in the text ring; the bytes are at offset % size
+        uint32_t length = 0;
+        ConsoleSeverity severity = ConsoleSeverity::Info;
+    };
+
+    // The arena. Line n is lines[n % lines.size()] for firstLine <= n < endLine; numbers only
+    // grow, so they stay valid keys after older lines were dropped. Lock mutex around every use.
+    struct ConsoleBuffer {
+        std::vector<char> text;
+        std::vector<ConsoleLine> lines;
+        uint64_t firstLine = 0, endLine = 0;
+        uint64_t textEnd = 0; // Absolute position after the newest line
+        uint64_t dropped = 0;   // Lines pushed out to make room
+        uint64_t truncated = 0; // Lines cut to maxLineBytes
+        size_t maxLineBytes = 0;
+        std::mutex mutex;
+
+        // A quarter of the budget for line records, the rest for text
+        explicit ConsoleBuffer(size_t memoryLimit) {
+            size_t lineCount = std::max<size_t>(16, memoryLimit / 4 / sizeof(ConsoleLine));
+            lines.resize(lineCount);
+            text.resize(std::max<size_t>(1024, memoryLimit - std::min(memoryLimit, lineCount * sizeof(ConsoleLine))));
+            maxLineBytes = std::min<size_t>(4096, text.size() / 4);
+        }
+
+        size_t bytes() const {
+            return text.size() + lines.size() * sizeof(ConsoleLine);
+        }
+
+        void push(const char* data, size_t length, ConsoleSeverity severity) {
+            if (length > maxLineBytes) {
+                length = maxLineBytes;
+                ++truncated;
+            }
+            size_t size = text.size();
+            uint64_t offset = textEnd;
+            if (offset % size + length > size) {
+                offset += size - offset % size; // Keep every line contiguous, skipping the ring's tail
+            }
+            uint64_t end = offset + length;
+            while (firstLine < endLine && (endLine - firstLine == lines.size() ||
+                (end > size && lines[firstLine % lines.size()].offset < end - size))) {
+                ++firstLine; // Its slot or bytes are about to be overwritten
+                ++dropped;
+            }
+            std::memcpy(text.data() + offset % size, data, length);
+            lines[endLine % lines.size()] = { offset, static_cast<uint32_t>(length), severity };
+            ++endLine;
+            textEnd = end;
+        }
+
+        std::string_view line(uint64_t number) const {
+            const ConsoleLine& record = lines[number % lines.size()];
+            return std::string_view(text.data() + record.offset % text.size(), record.length);
+        }
+    };
+
+    struct ConsoleComponent : public UIComponent {
+        ConsoleBuffer buffer;
+        UIContext* owner; // Woken on append, so producers need no context current
+
+        float fontSize = 1.5f;
+        float lineSpacing = 2.0f;
+        float scrollbarWidth = 10.0f;
+        int scrollStep = 3; // Lines per mouse wheel notch
+        bool colorBySeverity = true; // Text color from the Console part's severity states, else Normal
+
+        // View, UI thread only
+        uint64_t topLine = 0; // First line shown
+        bool follow = true;
+        uint64_t shownFirst = 0, shownEnd = 0; // Buffer range as of the last update()
+        size_t visibleCount = 0;
+        bool isMouseOver = false;
+        bool isDraggingScrollbar = false;
+        float scrollbarGrabOffset = 0.0f;
+
+        // Glyph ring: line n uses slot n % lineSlots; lineForSlot says which line it was set for.
+        // update() picks the lines, syncGL() creates the texts and sets the stale slots' glyphs.
+        std::vector<GLTtext*> lineTexts;
+        size_t lineSlots = 0;
+        std::vector<uint64_t> lineForSlot;
+        std::vector<ConsoleSeverity> severityForSlot;
+        std::vector<std::string> textForSlot; // Copied under the lock, turned into glyphs by syncGL()
+        std::vector<size_t> staleSlots;
+
+        ConsoleComponent(size_t memoryLimit, int width, int height) : buffer(memoryLimit), owner(&ui()) {
+            this->width = width;
+            this->height = height;
+            styleType = StyleComponent::Console;
+            trackResource(ResourceKind::Host, resourceHandle(this), buffer.bytes(), "Console");
+            countObject("ConsoleComponent", 1);
+        }
+
+        ~ConsoleComponent() {
+            for (auto text : lineTexts) {
+                gltDeleteText(text);
+            }
+            untrackResource(ResourceKind::Host, resourceHandle(this));
+            countObject("ConsoleComponent", -1);
+        }
+
+        // Any thread. Splits at newlines (a trailing one ends the last line, it does not add an empty one).
+        void append(std::string_view text, ConsoleSeverity severity = ConsoleSeverity::Info) {
+            {
+                std::lock_guard<std::mutex> lock(buffer.mutex);
+                size_t start = 0;
+                do {
+                    size_t newline = text.find('\n', start);
+                    size_t stop = newline == std::string_view::npos ? text.size() : newline;
+                    size_t length = stop - start;
+                    if (length > 0 && text[stop - 1] == '\r') {
+                        --length;
+                    }
+                    buffer.push(text.data() + start, length, severity);
+                    start = stop + 1;
+                } while (start < text.size());
+            }
+            requestRedrawAsync(*owner);
+        }
+
+        // Any thread; line numbers keep counting, so cached glyphs never show stale text
+        void clear() {
+            {
+                std::lock_guard<std::mutex> lock(buffer.mutex);
+                buffer.firstLine = buffer.endLine;
+            }
+            requestRedrawAsync(*owner);
+        }
+
+        float rowHeight() const {
+            return gltGetLineHeight(fontSize) + lineSpacing;
+        }
+
+        float linesWidth() const {
+            return needsScrollbar() ? width - scrollbarWidth : static_cast<float>(width);
+        }
+
+        size_t pageLines() const {
+            return static_cast<size_t>(std::max(1.0f, height / rowHeight()));
+        }
+
+        bool needsScrollbar() const {
+            return shownEnd - shownFirst > pageLines();
+        }
+
+        uint64_t lastTop() const {
+            return shownEnd - std::min<uint64_t>(shownEnd - shownFirst, pageLines());
+        }
+
+        // Moves the view; reaching the bottom turns following back on
+        void scrollTo(int64_t line) {
+            uint64_t top = static_cast<uint64_t>(std::max<int64_t>(line, static_cast<int64_t>(shownFirst)));
+            top = std::min(top, lastTop());
+            follow = top >= lastTop();
+            if (top != topLine) {
+                topLine = top;
+                requestRedraw();
+            }
+        }
+
+        void scrollbarThumb(float& thumbY, float& thumbHeight) const {
+            double total = static_cast<double>(shownEnd - shownFirst);
+            double page = static_cast<double>(pageLines());
+            thumbHeight = total > page ? static_cast<float>(height * (page / total)) : static_cast<float>(height);
+            if (thumbHeight < 16.0f) thumbHeight = 16.0f;
+            double range = static_cast<double>(lastTop() - shownFirst);
+            thumbY = y + (range > 0.0 ? static_cast<float>((height - thumbHeight) * ((topLine - shownFirst) / range)) : 0.0f);
+        }
+
+        virtual void update(float dt) override {
+            size_t rows = pageLines() + 1; // A partly visible line at the bottom
+            if (lineSlots < rows) {
+                lineSlots = rows;
+                lineForSlot.assign(lineSlots, ~0ull); // The modulus changed
+                severityForSlot.resize(lineSlots);
+                textForSlot.resize(lineSlots);
+                requestRedraw(); // A pipelined frame is recorded before syncGL() adds the texts
+            }
+            {
+                std::lock_guard<std::mutex> lock(buffer.mutex);
+                shownFirst = buffer.firstLine;
+                shownEnd = buffer.endLine;
+                topLine = follow ? lastTop() : std::min(std::max(topLine, shownFirst), lastTop());
+                visibleCount = static_cast<size_t>(std::min<uint64_t>(rows, shownEnd - topLine));
+                for (uint64_t line = topLine; line < topLine + visibleCount; ++line) {
+                    size_t slot = static_cast<size_t>(line % lineSlots);
+                    if (lineForSlot[slot] != line) {
+                        lineForSlot[slot] = line;
+                        severityForSlot[slot] = buffer.lines[line % buffer.lines.size()].severity;
+                        textForSlot[slot].assign(buffer.line(line));
+                        staleSlots.push_back(slot);
+                    }
+                }
+            }
+            if (!staleSlots.empty()) {
+                requestGLSync(*this);
+            }
+        }
+
+        virtual void syncGL() override {
+            while (lineTexts.size() < lineSlots) {
+                lineTexts.push_back(gltCreateText());
+            }
+            for (size_t slot : staleSlots) {
+                setGLText(lineTexts[slot], textForSlot[slot].c_str());
+            }
+            staleSlots.clear();
+        }
+
+        virtual void Draw() override {
+            drawRecorded(*this);
+        }
+
+        virtual void record(DrawList& list) override {
+            const ResolvedStyle& box = style();
+            float b = box.borderWidth;
+            list.addRoundedRect(x - b, y - b, width + 2.0f * b, height + 2.0f * b, box.background, box.cornerRadius, b, box.border);
+
+            list.pushClip(x, y, linesWidth(), static_cast<float>(height));
+            float step = rowHeight();
+            size_t shown = lineTexts.size() == lineSlots ? visibleCount : 0;
+            for (size_t i = 0; i < shown; ++i) {
+                size_t slot = static_cast<size_t>((topLine + i) % lineSlots);
+                StyleState state = colorBySeverity ? severityState(severityForSlot[slot]) : StyleState::Normal;
+                list.addText(lineTexts[slot], x + 5.0f, y + i * step + 0.5f * lineSpacing, fontSize, style(state).text);
+            }
+            list.popClip();
+
+            if (needsScrollbar()) {
+                float thumbY, thumbHeight;
+                scrollbarThumb(thumbY, thumbHeight);
+                float trackX = x + width - scrollbarWidth;
+                const ResolvedStyle& bar = style(StyleComponent::Scrollbar, isDraggingScrollbar ? StyleState::Pressed : StyleState::Normal);
+                list.addRect(trackX, y, scrollbarWidth, static_cast<float>(height), bar.background);
+                list.addRect(trackX + 1.0f, thumbY, scrollbarWidth - 2.0f, thumbHeight, bar.accent);
+            }
+        }
+
+        virtual void handleEvents(SDL_Event* event) override {
+            if (event->type == SDL_MOUSEBUTTONDOWN && event->button.button == SDL_BUTTON_LEFT) {
+                int mouseX = event->button.x, mouseY = event->button.y;
+                isMouseOver = mouseX > x && mouseX < x + width && mouseY > y && mouseY < y + height;
+                if (isMouseOver && needsScrollbar() && mouseX >= x + linesWidth()) {
+                    float thumbY, thumbHeight;
+                    scrollbarThumb(thumbY, thumbHeight);
+                    if (mouseY >= thumbY && mouseY < thumbY + thumbHeight) {
+                        isDraggingScrollbar = true;
+                        scrollbarGrabOffset = mouseY - thumbY;
+                        requestRedraw();
+                    }
+                    else {
+                        // Clicking the track pages towards the click
+                        int64_t page = static_cast<int64_t>(pageLines());
+                        scrollTo(static_cast<int64_t>(topLine) + (mouseY < thumbY ? -page : page));
+                    }
+                }
+            }
+            else if (event->type == SDL_MOUSEBUTTONUP && event->button.button == SDL_BUTTON_LEFT) {
+                if (isDraggingScrollbar) {
+                    isDraggingScrollbar = false;
+                    requestRedraw();
+                }
+            }
+            else if (event->type == SDL_MOUSEMOTION) {
+                int mouseX = event->motion.x, mouseY = event->motion.y;
+                isMouseOver = mouseX > x && mouseX < x + width && mouseY > y && mouseY < y + height;
+                if (isDraggingScrollbar) {
+                    float thumbY, thumbHeight;
+                    scrollbarThumb(thumbY, thumbHeight);
+                    float travel = height - thumbHeight;
+                    double fraction = travel > 0.0f ? (mouseY - scrollbarGrabOffset - y) / travel : 0.0;
+                    scrollTo(static_cast<int64_t>(shownFirst) + static_cast<int64_t>(std::llround(fraction * (lastTop() - shownFirst))));
+                }
+            }
+            else if (event->type == SDL_MOUSEWHEEL && isMouseOver) {
+                scrollTo(static_cast<int64_t>(topLine) - event->wheel.y * scrollStep);
+            }
+            else if (event->type == SDL_KEYDOWN && isMouseOver) {
+                int64_t page = static_cast<int64_t>(pageLines());
+                switch (event->key.keysym.sym) {
+                case SDLK_PAGEUP: scrollTo(static_cast<int64_t>(topLine) - page); break;
+                case SDLK_PAGEDOWN: scrollTo(static_cast<int64_t>(topLine) + page); break;
+                case SDLK_HOME: scrollTo(static_cast<int64_t>(shownFirst)); break;
+                case SDLK_END: scrollTo(static_cast<int64_t>(lastTop())); break;
+                default: break;
+                }
+            }
+        }
+    };
+
+    // memoryLimit caps the log text and line records (1 KB at least); older lines are dropped to stay under it
+    ConsoleComponent* Console(size_t memoryLimit, int width, int height) {
+        if (!currentUIManager().currentWidget) {
+            std::cerr << "No widget selected" << std::endl;
+            return nullptr;
+        }
+        auto console = new ConsoleComponent(memoryLimit, width, height);
+        addComponent(console);
+        assignResource(ResourceKind::Host, resourceHandle(console), "Console", currentUIManager().currentWidget->ID);
+        return console;
+    }
+}
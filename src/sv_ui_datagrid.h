@@ -0,0 +1,840 @@
+#pragma once
+
+//////////////////////////////////////////////////////////
+////////////SV UI DATA GRID///////////////////////////////
+//////////////////////////////////////////////////////////
+// A table for millions of rows. The data is handed over as columns (typed
+// arrays or string views owned by the caller), never as row objects:
+//
+//     SV_UI::GridDataSource table;
+//     table.addColumn("Host", hostNames.data(), hostNames.size()); // std::string_view
+//     table.addColumn("Port", ports.data(), ports.size());         // int64_t
+//     table.addColumn("Load", load.data(), load.size(), 3);        // double, 3 decimals
+//     auto* grid = SV_UI::DataGrid(&table, 800, 500);
+//     grid->onCellSelected = [](size_t row, size_t column) { ... }; // Data row
+//
+// Clicking a header sorts by that column (ascending, descending, off). Sorting
+// is a parallel sort of a row permutation on a background thread, so the
+// columns are only read and the UI keeps running; the grid shows the old order
+// until the new one is swapped in. The selection follows its data row. Dragging a header border resizes the column.
+// The header stays fixed while the cells scroll. Only cells on screen are
+// formatted and get glyphs, from a ring of text objects like ListBox rows, so
+// frame cost depends on the box size, not on the row count.
+//
+// After changing the arrays, call dataChanged() on the UI thread. A sort reads
+// the arrays while sorting() is true, so change them only when it is false.
+
+#include "sv_ui3.0.h"
+#include "sv_ui_parallel.h"
+#include "sv_ui_listindex.h" // SortOrder
+#include <numeric>
+#include <cstdio>
+
+namespace SV_UI {
+
+    enum class ColumnType : uint8_t {
+        Int64,
+        Double,
+        String
+    };
+
+    struct GridColumn {
+        std::string name;
+        ColumnType type = ColumnType::String;
+        const int64_t* ints = nullptr;
+        const double* doubles = nullptr;
+        const std::string_view* strings = nullptr;
+        int precision = 2; // Decimals shown for Double columns
+        float width = 100.0f; // Initial width in the grid
+    };
+
+    // Columns over arrays the caller owns; every column must have rowCount entries
+    struct GridDataSource {
+        std::vector<GridColumn> columns;
+        size_t rowCount = 0;
+
+        GridColumn& addColumn(const std::string& name, ColumnType type, size_t rows) {
+            if (!columns.empty() && rows != rowCount) {
+                std::cerr << "GridDataSource: column " << name << " has " << rows << " rows, expected " << rowCount << std::endl;
+            }
+            rowCount = columns.empty() ? rows : std::min(rowCount, rows);
+            columns.emplace_back();
+            columns.back().name = name;
+            columns.back().type = type;
+            return columns.back();
+        }
+
+        GridColumn& addColumn(const std::string& name, const int64_t* data, size_t rows) {
+            GridColumn& column = addColumn(name, ColumnType::Int64, rows);
+            column.ints = data;
+            return column;
+        }
+
+        GridColumn& addColumn(const std::string& name, const double* data, size_t rows, int precision = 2) {
+            GridColumn& column = addColumn(name, ColumnType::Double, rows);
+            column.doubles = data;
+            column.precision = precision;
+            return column;
+        }
+
+        GridColumn& addColumn(const std::string& name, const std::string_view* data, size_t rows) {
+            GridColumn& column = addColumn(name, ColumnType::String, rows);
+            column.strings = data;
+            return column;
+        }
+
+        void formatCell(size_t column, size_t row, std::string& out) const {
+            const GridColumn& source = columns[column];
+            switch (source.type) {
+            case ColumnType::Int64:
+                out = std::to_string(source.ints[row]);
+                break;
+            case ColumnType::Double: {
+                char text[64];
+                int length = std::snprintf(text, sizeof(text), "%.*f", source.precision, source.doubles[row]);
+                out.assign(text, length > 0 ? std::min<size_t>(length, sizeof(text) - 1) : 0);
+                break;
+            }
+            case ColumnType::String:
+                out.assign(source.strings[row].data(), source.strings[row].size());
+                break;
+            }
+        }
+    };
+
+    // NaN has no place in the order of the other values; it sorts last in either direction
+    template <typename T>
+    bool isMissingKey(T value) {
+        return value != value;
+    }
+
+    // Numeric keys are sorted as (key, row) pairs, so each comparison reads two adjacent
+    // records instead of two random places in the column
+    template <typename T>
+    void sortGridKeys(const T* values, bool descending, std::vector<uint32_t>& rows, unsigned threads) {
+        std::vector<std::pair<T, uint32_t>> keyed(rows.size());
+        parallelFor(rows.size(), threads, [&](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; ++i) {
+                keyed[i] = { values[i], static_cast<uint32_t>(i) };
+            }
+        });
+        parallelSort(keyed, threads, [descending](const std::pair<T, uint32_t>& a, const std::pair<T, uint32_t>& b) {
+            bool aMissing = isMissingKey(a.first), bMissing = isMissingKey(b.first);
+            if (aMissing != bMissing) return bMissing;
+            if (a.first < b.first) return !descending;
+            if (b.first < a.first) return descending;
+            return a.second < b.second;
+        });
+        for (size_t i = 0; i < rows.size(); ++i) {
+            rows[i] = keyed[i].second;
+        }
+    }
+
+    // Sorts rows, a permutation of [0, rowCount), by the key column (none: row order). Ties
+    // keep the lower row first in both directions, so repeated sorts give the same order.
+    void sortGridRows(const GridColumn* key, size_t rowCount, SortOrder sortOrder, std::vector<uint32_t>& rows, unsigned threads) {
+        rows.resize(rowCount);
+        std::iota(rows.begin(), rows.end(), 0u);
+        if (sortOrder == SortOrder::None || !key) {
+            return;
+        }
+        bool descending = sortOrder == SortOrder::Descending;
+        switch (key->type) {
+        case ColumnType::Int64:
+            sortGridKeys(key->ints, descending, rows, threads);
+            break;
+        case ColumnType::Double:
+            sortGridKeys(key->doubles, descending, rows, threads);
+            break;
+        case ColumnType::String: {
+            // Strings are compared in place: copying them out would cost more than the cache misses
+            const std::string_view* values = key->strings;
+            parallelSort(rows, threads, [values, descending](uint32_t a, uint32_t b) {
+                int c = values[a].compare(values[b]);
+                if (c != 0) return descending ? c > 0 : c < 0;
+                return a < b;
+            });
+            break;
+        }
+        }
+    }
+
+    void sortGridRows(const GridDataSource& source, size_t column, SortOrder sortOrder, std::vector<uint32_t>& rows, unsigned threads) {
+        sortGridRows(column < source.columns.size() ? &source.columns[column] : nullptr, source.rowCount, sortOrder, rows, threads);
+    }
+
+    // displayRows[order[i]] = i
+    void invertGridOrder(const std::vector<uint32_t>& order, std::vector<uint32_t>& displayRows, unsigned threads) {
+        displayRows.resize(order.size());
+        parallelFor(order.size(), threads, [&](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; ++i) {
+                displayRows[order[i]] = static_cast<uint32_t>(i);
+            }
+        });
+    }
+
+    const size_t NO_GRID_ROW = static_cast<size_t>(-1);
+
+    struct DataGridComponent : public UIComponent {
+        GridDataSource* source = nullptr;
+        std::vector<uint32_t> order; // Display row -> data row
+        std::vector<uint32_t> displayRows; // Data row -> display row, the inverse of order
+        std::vector<float> columnWidths;
+        std::vector<double> columnOffsets; // Prefix sums of columnWidths, one more entry than columns
+        size_t sortColumn = NO_GRID_ROW;
+        SortOrder sortOrder = SortOrder::None;
+        unsigned threadCount = defaultThreadCount();
+        std::function<void(size_t, size_t)> onCellSelected; // Data row and column
+
+        float fontSize = 1.5f;
+        float rowHeight = 20.0f;
+        float headerHeight = 24.0f;
+        float minColumnWidth = 24.0f;
+        float cellPadding = 5.0f;
+        float scrollbarWidth = 10.0f;
+        float scrollStep = 60.0f; // Pixels per mouse wheel notch
+
+        double scrollY = 0.0; // Double so offsets stay exact past a few million rows
+        float scrollX = 0.0f;
+        size_t selectedRow = NO_GRID_ROW; // Data row, so the selection survives sorting
+        size_t selectedColumn = NO_GRID_ROW;
+        size_t hoveredRow = NO_GRID_ROW; // Display row
+        bool isMouseOver = false;
+        size_t resizingColumn = NO_GRID_ROW;
+        float resizeGrabX = 0.0f, resizeStartWidth = 0.0f;
+        bool isDraggingScrollbar = false;
+        float scrollbarGrabOffset = 0.0f;
+
+        // Visible part, derived by update() and read by record()
+        size_t firstRow = 0, lastRow = NO_GRID_ROW; // Display rows
+        size_t firstColumn = 0, lastColumn = NO_GRID_ROW;
+
+        // Cell text ring: cell (row, column) uses slot (row % rowSlots) * columnSlots + column % columnSlots,
+        // so scrolling by one row or column refreshes only the cells that came into view. update()
+        // formats the strings; syncGL() creates the texts and turns the stale strings into glyphs.
+        std::vector<GLTtext*> cellTexts;
+        std::vector<uint64_t> cellForSlot; // Data row and column the slot was set for
+        std::vector<std::string> cellStringForSlot;
+        std::vector<size_t> staleCells;
+        size_t rowSlots = 0, columnSlots = 0;
+        std::vector<GLTtext*> headerTexts;
+        std::vector<int> headerSortForColumn; // Sort mark each header text was set with, -1 before
+        std::vector<std::string> headerStrings;
+        std::vector<size_t> staleHeaders;
+        std::string cellScratch;
+
+        // Background sort: the thread fills sortedOrder and sortedDisplayRows, and update()
+        // swaps them in once sortFinished is set. One runs at a time; a sort asked for
+        // meanwhile starts when it ends, and results of a superseded sort are dropped.
+        std::thread sortThread;
+        std::atomic<bool> sortFinished{ false };
+        std::vector<uint32_t> sortedOrder, sortedDisplayRows;
+        uint64_t sortGeneration = 0; // Of the order wanted
+        uint64_t runningSortGeneration = 0; // Of the order sortThread computes
+        bool sortQueued = false;
+        UIContext* owner = &ui(); // Woken when a sort finishes
+
+        DataGridComponent(GridDataSource* dataSource, int width = 400, int height = 300) {
+            this->width = width;
+            this->height = height;
+            styleType = StyleComponent::ListBox;
+            setDataSource(dataSource);
+            countObject("DataGridComponent", 1);
+        }
+
+        ~DataGridComponent() {
+            if (sortThread.joinable()) {
+                sortThread.join();
+            }
+            for (auto text : cellTexts) {
+                gltDeleteText(text);
+            }
+            for (auto text : headerTexts) {
+                gltDeleteText(text);
+            }
+            untrackResource(ResourceKind::Host, resourceHandle(this));
+            countObject("DataGridComponent", -1);
+        }
+
+        void setDataSource(GridDataSource* dataSource) {
+            source = dataSource;
+            columnWidths.clear();
+            if (source) {
+                for (const GridColumn& column : source->columns) {
+                    columnWidths.push_back(std::max(column.width, minColumnWidth));
+                }
+            }
+            sortColumn = NO_GRID_ROW;
+            sortOrder = SortOrder::None;
+            selectedRow = selectedColumn = NO_GRID_ROW;
+            dataChanged();
+        }
+
+        // The arrays changed (values, or the row count): re-sort and re-format what is on screen
+        void dataChanged() {
+            if (source && columnWidths.size() < source->columns.size()) {
+                for (size_t c = columnWidths.size(); c < source->columns.size(); ++c) {
+                    columnWidths.push_back(std::max(source->columns[c].width, minColumnWidth));
+                }
+            }
+            updateColumnOffsets();
+            fitOrderToRows(source ? source->rowCount : 0);
+            startSort();
+            if (selectedRow != NO_GRID_ROW && selectedRow >= rowCount()) {
+                selectedRow = NO_GRID_ROW;
+            }
+            // Twice the permutation and its inverse: a sort builds new ones beside them
+            trackResource(ResourceKind::Host, resourceHandle(this), 2 * (order.capacity() + displayRows.capacity()) * sizeof(uint32_t), "DataGrid", "", parent ? parent->ID : -1);
+            invalidateCells();
+            clampScroll();
+            requestRedraw();
+        }
+
+        // Until the sort lands, show the old order without the rows that are gone and with
+        // the new rows at the end
+        void fitOrderToRows(size_t rows) {
+            if (order.size() == rows) {
+                return;
+            }
+            size_t previous = order.size();
+            if (rows < previous) {
+                order.erase(std::remove_if(order.begin(), order.end(), [rows](uint32_t row) { return row >= rows; }), order.end());
+            }
+            else {
+                order.resize(rows);
+                std::iota(order.begin() + previous, order.end(), static_cast<uint32_t>(previous));
+            }
+            invertGridOrder(order, displayRows, threadCount);
+        }
+
+        // Compute the order for sortColumn and sortOrder on sortThread
+        void startSort() {
+            ++sortGeneration;
+            if (sortThread.joinable()) {
+                sortQueued = true; // Started by pollSort() when the running one ends
+                return;
+            }
+            launchSort();
+        }
+
+        void launchSort() {
+            sortQueued = false;
+            if (!source) {
+                return;
+            }
+            // Copies, so the thread never touches the source's vector of columns
+            bool keyed = sortOrder != SortOrder::None && sortColumn < source->columns.size();
+            GridColumn key = keyed ? source->columns[sortColumn] : GridColumn();
+            size_t rows = source->rowCount;
+            SortOrder direction = sortOrder;
+            unsigned threads = threadCount;
+            runningSortGeneration = sortGeneration;
+            sortFinished = false;
+            sortThread = std::thread([this, keyed, key, rows, direction, threads]() {
+                sortGridRows(keyed ? &key : nullptr, rows, direction, sortedOrder, threads);
+                invertGridOrder(sortedOrder, sortedDisplayRows, threads);
+                sortFinished = true;
+                requestRedrawAsync(*owner);
+            });
+        }
+
+        // Swap in a finished sort; with wait, block until the current order is in place
+        void pollSort(bool wait = false) {
+            while (sortThread.joinable() && (wait || sortFinished)) {
+                sortThread.join();
+                if (runningSortGeneration == sortGeneration && sortedOrder.size() == order.size()) {
+                    order.swap(sortedOrder);
+                    displayRows.swap(sortedDisplayRows);
+                    invalidateCells();
+                    requestRedraw();
+                }
+                if (sortQueued) {
+                    launchSort();
+                }
+            }
+        }
+
+        // A sort is running or waiting to run
+        bool sorting() const {
+            return sortThread.joinable();
+        }
+
+        size_t rowCount() const {
+            return order.size();
+        }
+
+        size_t columnCount() const {
+            return columnWidths.size();
+        }
+
+        void sortBy(size_t column, SortOrder newOrder) {
+            if (!source || column >= columnCount()) {
+                return;
+            }
+            sortColumn = newOrder == SortOrder::None ? NO_GRID_ROW : column;
+            sortOrder = newOrder;
+            startSort();
+            requestRedraw(); // The header shows the new sort mark right away
+        }
+
+        // Header clicks cycle ascending, descending, unsorted
+        void toggleSort(size_t column) {
+            if (column != sortColumn) {
+                sortBy(column, SortOrder::Ascending);
+            }
+            else {
+                sortBy(column, sortOrder == SortOrder::Ascending ? SortOrder::Descending : SortOrder::None);
+            }
+        }
+
+        void setColumnWidth(size_t column, float columnWidth) {
+            if (column >= columnCount()) {
+                return;
+            }
+            columnWidth = std::max(columnWidth, minColumnWidth);
+            if (columnWidth != columnWidths[column]) {
+                columnWidths[column] = columnWidth;
+                updateColumnOffsets();
+                clampScroll();
+                requestRedraw();
+            }
+        }
+
+        void updateColumnOffsets() {
+            columnOffsets.assign(columnWidths.size() + 1, 0.0);
+            for (size_t c = 0; c < columnWidths.size(); ++c) {
+                columnOffsets[c + 1] = columnOffsets[c] + columnWidths[c];
+            }
+        }
+
+        //////// Geometry ////////
+
+        float cellsWidth() const {
+            return needsScrollbar() ? width - scrollbarWidth : static_cast<float>(width);
+        }
+
+        float cellsHeight() const {
+            return std::max(0.0f, height - headerHeight);
+        }
+
+        double contentHeight() const {
+            return static_cast<double>(rowCount()) * rowHeight;
+        }
+
+        float contentWidth() const {
+            return columnOffsets.empty() ? 0.0f : static_cast<float>(columnOffsets.back());
+        }
+
+        bool needsScrollbar() const {
+            return contentHeight() > cellsHeight();
+        }
+
+        double maxScrollY() const {
+            return std::max(0.0, contentHeight() - cellsHeight());
+        }
+
+        float maxScrollX() const {
+            return std::max(0.0f, contentWidth() - cellsWidth());
+        }
+
+        void clampScroll() {
+            scrollY = std::min(std::max(scrollY, 0.0), maxScrollY());
+            scrollX = std::min(std::max(scrollX, 0.0f), maxScrollX());
+        }
+
+        void scrollTo(double offsetY, float offsetX) {
+            double oldY = scrollY;
+            float oldX = scrollX;
+            scrollY = offsetY;
+            scrollX = offsetX;
+            clampScroll();
+            if (scrollY != oldY || scrollX != oldX) {
+                requestRedraw();
+            }
+        }
+
+        // Column under a content-space x, or NO_GRID_ROW past the last column
+        size_t columnAt(double contentX) const {
+            if (contentX < 0.0 || columnOffsets.size() < 2 || contentX >= columnOffsets.back()) {
+                return NO_GRID_ROW;
+            }
+            return std::upper_bound(columnOffsets.begin(), columnOffsets.end(), contentX) - columnOffsets.begin() - 1;
+        }
+
+        // Display row under a screen y in the cell area, or NO_GRID_ROW
+        size_t rowAtY(float screenY) const {
+            double contentY = screenY - (y + headerHeight) + scrollY;
+            if (screenY < y + headerHeight || contentY < 0.0 || contentY >= contentHeight()) {
+                return NO_GRID_ROW;
+            }
+            return static_cast<size_t>(contentY / rowHeight);
+        }
+
+        size_t displayRowOf(size_t dataRow) const {
+            return dataRow < displayRows.size() ? displayRows[dataRow] : NO_GRID_ROW;
+        }
+
+        void scrollToRow(size_t displayRow) {
+            double top = static_cast<double>(displayRow) * rowHeight;
+            if (top < scrollY) {
+                scrollTo(top, scrollX);
+            }
+            else if (top + rowHeight > scrollY + cellsHeight()) {
+                scrollTo(top + rowHeight - cellsHeight(), scrollX);
+            }
+        }
+
+        void scrollToColumn(size_t column) {
+            float left = static_cast<float>(columnOffsets[column]), right = static_cast<float>(columnOffsets[column + 1]);
+            if (left < scrollX) {
+                scrollTo(scrollY, left);
+            }
+            else if (right > scrollX + cellsWidth()) {
+                scrollTo(scrollY, right - cellsWidth());
+            }
+        }
+
+        void selectCell(size_t displayRow, size_t column) {
+            if (displayRow >= rowCount() || column >= columnCount()) {
+                return;
+            }
+            selectedRow = order[displayRow];
+            selectedColumn = column;
+            scrollToRow(displayRow);
+            scrollToColumn(column);
+            requestRedraw();
+            if (onCellSelected) {
+                onCellSelected(selectedRow, selectedColumn);
+            }
+        }
+
+        void scrollbarThumb(float& thumbY, float& thumbHeight) const {
+            float track = cellsHeight();
+            double total = contentHeight();
+            thumbHeight = total > 0.0 ? static_cast<float>(track * (track / total)) : track;
+            if (thumbHeight < 16.0f) thumbHeight = 16.0f;
+            double limit = maxScrollY();
+            thumbY = y + headerHeight + (limit > 0.0 ? static_cast<float>((track - thumbHeight) * (scrollY / limit)) : 0.0f);
+        }
+
+        //////// Cell texts ////////
+
+        void invalidateCells() {
+            std::fill(cellForSlot.begin(), cellForSlot.end(), ~0ull);
+        }
+
+        static uint64_t cellKey(size_t dataRow, size_t column) {
+            return (static_cast<uint64_t>(dataRow) << 20) | column;
+        }
+
+        size_t cellSlot(size_t displayRow, size_t column) const {
+            return (displayRow % rowSlots) * columnSlots + column % columnSlots;
+        }
+
+        // Grow the ring to hold the visible block and format the cells new to their slot
+        void prepareCells() {
+            size_t rows = lastRow - firstRow + 1, columns = lastColumn - firstColumn + 1;
+            if (rows > rowSlots || columns > columnSlots) {
+                rowSlots = std::max(rows, rowSlots);
+                columnSlots = std::max(columns, columnSlots);
+                cellForSlot.assign(rowSlots * columnSlots, ~0ull); // The moduli changed, so every slot is stale
+                cellStringForSlot.resize(rowSlots * columnSlots);
+                staleCells.clear();
+            }
+            for (size_t row = firstRow; row <= lastRow; ++row) {
+                size_t dataRow = order[row];
+                for (size_t column = firstColumn; column <= lastColumn; ++column) {
+                    size_t slot = cellSlot(row, column);
+                    uint64_t key = cellKey(dataRow, column);
+                    if (cellForSlot[slot] != key) {
+                        cellForSlot[slot] = key;
+                        source->formatCell(column, dataRow, cellStringForSlot[slot]);
+                        staleCells.push_back(slot);
+                    }
+                }
+            }
+        }
+
+        void prepareHeaders() {
+            while (headerStrings.size() < columnCount()) {
+                headerStrings.emplace_back();
+                headerSortForColumn.push_back(-1);
+            }
+            for (size_t column = firstColumn; column <= lastColumn; ++column) {
+                int mark = column == sortColumn ? static_cast<int>(sortOrder) : 0;
+                if (headerSortForColumn[column] != mark) {
+                    headerSortForColumn[column] = mark;
+                    std::string& name = headerStrings[column];
+                    name = source->columns[column].name;
+                    if (mark) {
+                        name += sortOrder == SortOrder::Ascending ? " ^" : " v";
+                    }
+                    staleHeaders.push_back(column);
+                }
+            }
+        }
+
+        virtual void syncGL() override {
+            while (cellTexts.size() < cellStringForSlot.size()) {
+                cellTexts.push_back(gltCreateText());
+            }
+            while (headerTexts.size() < headerStrings.size()) {
+                headerTexts.push_back(gltCreateText());
+            }
+            for (size_t slot : staleCells) {
+                setGLText(cellTexts[slot], cellStringForSlot[slot].c_str());
+            }
+            for (size_t column : staleHeaders) {
+                setGLText(headerTexts[column], headerStrings[column].c_str());
+            }
+            staleCells.clear();
+            staleHeaders.clear();
+        }
+
+        // False for a frame recorded between a ring growing and the syncGL() that fills it
+        bool textsReady() const {
+            return cellTexts.size() == cellStringForSlot.size() && headerTexts.size() == headerStrings.size();
+        }
+
+        //////// Per frame ////////
+
+        virtual void Draw() override {
+            drawRecorded(*this);
+        }
+
+        virtual void update(float dt) override {
+            pollSort();
+            clampScroll();
+            lastRow = lastColumn = NO_GRID_ROW;
+            if (!source || rowCount() == 0 || columnCount() == 0) {
+                return;
+            }
+            firstRow = static_cast<size_t>(scrollY / rowHeight);
+            lastRow = std::min(rowCount() - 1, static_cast<size_t>((scrollY + cellsHeight()) / rowHeight));
+            firstColumn = columnAt(scrollX);
+            if (firstColumn == NO_GRID_ROW) {
+                lastRow = NO_GRID_ROW;
+                return;
+            }
+            lastColumn = firstColumn;
+            while (lastColumn + 1 < columnCount() && columnOffsets[lastColumn + 1] < scrollX + cellsWidth()) {
+                ++lastColumn;
+            }
+            prepareCells();
+            prepareHeaders();
+            if (!staleCells.empty() || !staleHeaders.empty()) {
+                requestGLSync(*this);
+            }
+            if (!textsReady()) {
+                requestRedraw(); // A pipelined frame is recorded before syncGL() adds the texts
+            }
+        }
+
+        virtual void record(DrawList& list) override {
+            const ResolvedStyle& box = style();
+            float b = box.borderWidth;
+            list.addRoundedRect(x - b, y - b, width + 2.0f * b, height + 2.0f * b, box.background, box.cornerRadius, b, box.border);
+            const ResolvedStyle& header = style(StyleComponent::GridHeader, StyleState::Normal);
+            list.addRect(x, y, cellsWidth(), headerHeight, header.background);
+            if (lastRow == NO_GRID_ROW) {
+                return;
+            }
+            float cellsTop = y + headerHeight;
+            float originX = x - scrollX;
+            float textOffsetY = (rowHeight - gltGetLineHeight(fontSize)) / 2.0f;
+
+            list.pushClip(x, cellsTop, cellsWidth(), cellsHeight());
+            for (size_t row = firstRow; row <= lastRow; ++row) {
+                float rowY = cellsTop + static_cast<float>(row * static_cast<double>(rowHeight) - scrollY);
+                bool selected = order[row] == selectedRow;
+                const ResolvedStyle& look = style(StyleComponent::ListRow, selected ? StyleState::Selected : (row == hoveredRow ? StyleState::Hover : StyleState::Normal));
+                if (look.background >> 24) {
+                    list.addRect(x, rowY, cellsWidth(), rowHeight, look.background);
+                }
+                if (selected && selectedColumn >= firstColumn && selectedColumn <= lastColumn) {
+                    list.addRoundedRect(originX + static_cast<float>(columnOffsets[selectedColumn]), rowY,
+                        columnWidths[selectedColumn], rowHeight, 0, 0.0f, 1.0f, look.accent); // Outline of the selected cell
+                }
+            }
+            for (size_t column = firstColumn; column <= lastColumn; ++column) {
+                list.addRect(originX + static_cast<float>(columnOffsets[column + 1]) - 1.0f, cellsTop, 1.0f, cellsHeight(), header.border);
+            }
+            // Texts after all quads, so the submit enters glText's state once; each column clips its own cells
+            bool texts = textsReady();
+            for (size_t column = firstColumn; texts && column <= lastColumn; ++column) {
+                float columnX = originX + static_cast<float>(columnOffsets[column]);
+                list.pushClip(columnX, cellsTop, columnWidths[column] - cellPadding, cellsHeight());
+                for (size_t row = firstRow; row <= lastRow; ++row) {
+                    float rowY = cellsTop + static_cast<float>(row * static_cast<double>(rowHeight) - scrollY);
+                    uint32_t color = style(StyleComponent::ListRow, order[row] == selectedRow ? StyleState::Selected : StyleState::Normal).text;
+                    list.addText(cellTexts[cellSlot(row, column)], columnX + cellPadding, rowY + textOffsetY, fontSize, color);
+                }
+                list.popClip();
+            }
+            list.popClip();
+
+            // Fixed header: scrolls sideways with the cells, never vertically
+            list.pushClip(x, y, cellsWidth(), headerHeight);
+            float headerTextY = y + (headerHeight - gltGetLineHeight(fontSize)) / 2.0f;
+            for (size_t column = firstColumn; column <= lastColumn; ++column) {
+                float right = originX + static_cast<float>(columnOffsets[column + 1]);
+                list.addRect(right - 1.0f, y, 1.0f, headerHeight, column == resizingColumn ? header.accent : header.border);
+            }
+            for (size_t column = firstColumn; texts && column <= lastColumn; ++column) {
+                float columnX = originX + static_cast<float>(columnOffsets[column]);
+                list.pushClip(columnX, y, columnWidths[column] - cellPadding, headerHeight);
+                list.addText(headerTexts[column], columnX + cellPadding, headerTextY, fontSize, header.text);
+                list.popClip();
+            }
+            list.popClip();
+
+            if (needsScrollbar()) {
+                float thumbY, thumbHeight;
+                scrollbarThumb(thumbY, thumbHeight);
+                float trackX = x + width - scrollbarWidth;
+                const ResolvedStyle& bar = style(StyleComponent::Scrollbar, isDraggingScrollbar ? StyleState::Pressed : StyleState::Normal);
+                list.addRect(trackX, cellsTop, scrollbarWidth, cellsHeight(), bar.background);
+                list.addRect(trackX + 1.0f, thumbY, scrollbarWidth - 2.0f, thumbHeight, bar.accent);
+            }
+        }
+
+        //////// Events ////////
+
+        // Column whose right border is within a few pixels of a header x, for resizing
+        size_t columnBorderAt(float screenX) const {
+            double contentX = screenX - x + scrollX;
+            for (size_t column = firstColumn; column <= lastColumn && lastColumn != NO_GRID_ROW; ++column) {
+                if (std::fabs(columnOffsets[column + 1] - contentX) <= 4.0) {
+                    return column;
+                }
+            }
+            return NO_GRID_ROW;
+        }
+
+        void updateHover(int mouseX, int mouseY) {
+            isMouseOver = mouseX > x && mouseX < x + width && mouseY > y && mouseY < y + height;
+            size_t hovered = isMouseOver && mouseX < x + cellsWidth() ? rowAtY(static_cast<float>(mouseY)) : NO_GRID_ROW;
+            if (hovered != hoveredRow) {
+                hoveredRow = hovered;
+                requestRedraw();
+            }
+        }
+
+        virtual void handleEvents(SDL_Event* event) override {
+            if (!source) {
+                return;
+            }
+            if (event->type == SDL_MOUSEBUTTONDOWN && event->button.button == SDL_BUTTON_LEFT) {
+                int mouseX = event->button.x, mouseY = event->button.y;
+                updateHover(mouseX, mouseY);
+                if (!isMouseOver) {
+                    return;
+                }
+                if (needsScrollbar() && mouseX >= x + cellsWidth()) {
+                    float thumbY, thumbHeight;
+                    scrollbarThumb(thumbY, thumbHeight);
+                    if (mouseY >= thumbY && mouseY < thumbY + thumbHeight) {
+                        isDraggingScrollbar = true;
+                        scrollbarGrabOffset = mouseY - thumbY;
+                        requestRedraw();
+                    }
+                    else if (mouseY >= y + headerHeight) {
+                        scrollTo(scrollY + (mouseY < thumbY ? -cellsHeight() : cellsHeight()), scrollX); // Page towards the click
+                    }
+                }
+                else if (mouseY < y + headerHeight) {
+                    size_t border = columnBorderAt(static_cast<float>(mouseX));
+                    if (border != NO_GRID_ROW) {
+                        resizingColumn = border;
+                        resizeGrabX = static_cast<float>(mouseX);
+                        resizeStartWidth = columnWidths[border];
+                        requestRedraw();
+                    }
+                    else {
+                        size_t column = columnAt(mouseX - x + scrollX);
+                        if (column != NO_GRID_ROW) {
+                            toggleSort(column);
+                        }
+                    }
+                }
+                else if (hoveredRow != NO_GRID_ROW) {
+                    size_t column = columnAt(mouseX - x + scrollX);
+                    if (column != NO_GRID_ROW) {
+                        selectCell(hoveredRow, column);
+                    }
+                }
+            }
+            else if (event->type == SDL_MOUSEBUTTONUP && event->button.button == SDL_BUTTON_LEFT) {
+                if (isDraggingScrollbar || resizingColumn != NO_GRID_ROW) {
+                    isDraggingScrollbar = false;
+                    resizingColumn = NO_GRID_ROW;
+                    requestRedraw();
+                }
+            }
+            else if (event->type == SDL_MOUSEMOTION) {
+                int mouseX = event->motion.x, mouseY = event->motion.y;
+                if (resizingColumn != NO_GRID_ROW) {
+                    setColumnWidth(resizingColumn, resizeStartWidth + (mouseX - resizeGrabX));
+                }
+                else if (isDraggingScrollbar) {
+                    float thumbY, thumbHeight;
+                    scrollbarThumb(thumbY, thumbHeight);
+                    float travel = cellsHeight() - thumbHeight;
+                    double fraction = travel > 0.0f ? (mouseY - scrollbarGrabOffset - (y + headerHeight)) / travel : 0.0;
+                    scrollTo(fraction * maxScrollY(), scrollX);
+                }
+                updateHover(mouseX, mouseY);
+            }
+            else if (event->type == SDL_MOUSEWHEEL && isMouseOver) {
+                bool sideways = (SDL_GetModState() & KMOD_SHIFT) != 0;
+                float across = sideways ? event->wheel.y : -event->wheel.x;
+                float down = sideways ? 0.0f : event->wheel.y;
+                scrollTo(scrollY - down * scrollStep, scrollX - across * scrollStep);
+            }
+            else if (event->type == SDL_KEYDOWN && isMouseOver && selectedRow != NO_GRID_ROW) {
+                handleKey(event->key.keysym);
+            }
+        }
+
+        // Arrows and paging move the selected cell; Ctrl+C copies its text
+        void handleKey(const SDL_Keysym& key) {
+            size_t row = displayRowOf(selectedRow);
+            if (row == NO_GRID_ROW) {
+                return;
+            }
+            size_t column = selectedColumn;
+            size_t page = std::max<size_t>(1, static_cast<size_t>(cellsHeight() / rowHeight));
+            switch (key.sym) {
+            case SDLK_UP: row = row > 0 ? row - 1 : 0; break;
+            case SDLK_DOWN: row = std::min(row + 1, rowCount() - 1); break;
+            case SDLK_LEFT: column = column > 0 ? column - 1 : 0; break;
+            case SDLK_RIGHT: column = std::min(column + 1, columnCount() - 1); break;
+            case SDLK_PAGEUP: row = row > page ? row - page : 0; break;
+            case SDLK_PAGEDOWN: row = std::min(row + page, rowCount() - 1); break;
+            case SDLK_HOME: row = 0; break;
+            case SDLK_END: row = rowCount() - 1; break;
+            case SDLK_c:
+                if (key.mod & (KMOD_CTRL | KMOD_GUI)) {
+                    source->formatCell(selectedColumn, selectedRow, cellScratch);
+                    SDL_SetClipboardText(cellScratch.c_str());
+                }
+                return;
+            default:
+                return;
+            }
+            selectCell(row, column);
+        }
+    };
+
+    // The source is not owned and must outlive the grid
+    DataGridComponent* DataGrid(GridDataSource* source, int width = 400, int height = 300) {
+        if (!currentUIManager().currentWidget) {
+            std::cerr << "No widget selected" << std::endl;
+            return nullptr;
+        }
+        auto grid = new DataGridComponent(source, width, height);
+        addComponent(grid);
+        assignResource(ResourceKind::Host, resourceHandle(grid), "DataGrid", currentUIManager().currentWidget->ID);
+        return grid;
+    }
+}
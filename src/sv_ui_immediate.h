@@ -0,0 +1,599 @@
+#pragma once
+
+//////////////////////////////////////////////////////////
+////////////SV UI IMMEDIATE MODE//////////////////////////
+//////////////////////////////////////////////////////////
+// Immediate-mode front end for SV_UI. Unlike createWidget()/endWidget(), which
+// build a retained tree once, these functions are called every frame:
+//
+//     SV_UI::IM::beginFrame();
+//     if (SV_UI::IM::Begin("Debug", 20, 20, 300, 200, SV_UI::WIDGET_DRAGGABLE)) {
+//         SV_UI::IM::Text("Hello World");
+//         if (SV_UI::IM::Button("Reload")) { ... }
+//         SV_UI::IM::End();
+//     }
+//     SV_UI::IM::endFrame(); // Submits the frame's draw list
+//
+// Widgets are identified by hashing their label together with the ID stack
+// (Begin() and PushID() push onto it), so the same label may be reused in
+// different windows. State that must survive between frames (window position,
+// drag offsets, list scroll and selection) lives in a small open-addressing
+// table keyed by that hash. Geometry goes straight into a DrawList that is
+// cleared, not freed, every frame, so a steady-state frame does not allocate.
+
+#include "sv_ui3.0.h"
+
+namespace SV_UI {
+namespace IM {
+
+    const int ID_STACK_DEPTH = 64;
+    const uint32_t STATE_RETAIN_FRAMES = 120; // Drop state for widgets not seen for this many frames
+    const float ITEM_SPACING = 4.0f;
+    const float WINDOW_PADDING = 8.0f;
+    const float TEXT_SCALE = 1.5f;
+
+    // FNV-1a, seeded with the parent ID so identical labels in different scopes differ
+    inline uint32_t hashID(const void* data, size_t size, uint32_t seed) {
+        uint32_t hash = seed ^ 2166136261u;
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 16777619u;
+        }
+        return hash ? hash : 1; // 0 is reserved for "no widget"
+    }
+
+    inline uint32_t hashID(const char* label, uint32_t seed) {
+        return hashID(label, std::strlen(label), seed);
+    }
+
+    enum StateFlags : uint8_t {
+        STATE_HOVERED = 1 << 0,
+        STATE_DRAGGING = 1 << 1,
+        STATE_CHECKED = 1 << 2
+    };
+
+    // Everything a widget needs to remember between frames
+    struct WidgetState {
+        uint32_t id = 0;
+        uint32_t lastFrame = 0;
+        float x = 0.0f, y = 0.0f;
+        float dragOffsetX = 0.0f, dragOffsetY = 0.0f;
+        float scrollY = 0.0f;
+        int selected = -1;
+        uint8_t flags = 0;
+        GLTtext* text = nullptr; // Cached glyph geometry for the widget's label
+    };
+
+    // Open-addressing hash table with linear probing. Capacity is a power of two
+    // and grows only when the live count passes 70%, so after warm-up lookups never allocate.
+    struct StateTable {
+        std::vector<WidgetState> slots;
+        size_t count = 0;
+
+        StateTable() {
+            slots.resize(256);
+        }
+
+        WidgetState* find(uint32_t id) {
+            size_t mask = slots.size() - 1;
+            for (size_t i = id & mask;; i = (i + 1) & mask) {
+                if (slots[i].id == id) return &slots[i];
+                if (slots[i].id == 0) return nullptr;
+            }
+        }
+
+        // Returns the state for id, inserting a default one if needed. isNew tells the caller to initialise it.
+        WidgetState& obtain(uint32_t id, bool& isNew) {
+            if ((count + 1) * 10 > slots.size() * 7) {
+                grow();
+            }
+            size_t mask = slots.size() - 1;
+            size_t i = id & mask;
+            while (slots[i].id != 0 && slots[i].id != id) {
+                i = (i + 1) & mask;
+            }
+            isNew = slots[i].id == 0;
+            if (isNew) {
+                slots[i] = WidgetState();
+                slots[i].id = id;
+                ++count;
+            }
+            return slots[i];
+        }
+
+        void grow() {
+            std::vector<WidgetState> old;
+            old.swap(slots);
+            slots.resize(old.size() * 2);
+            count = 0;
+            for (const WidgetState& state : old) {
+                if (state.id != 0) {
+                    bool isNew;
+                    obtain(state.id, isNew) = state;
+                }
+            }
+        }
+
+        // Remove entries that were not touched since minFrame. Uses backward-shift
+        // deletion so no tombstones accumulate.
+        void sweep(uint32_t minFrame) {
+            size_t mask = slots.size() - 1;
+            for (size_t i = 0; i < slots.size();) {
+                if (slots[i].id == 0 || slots[i].lastFrame >= minFrame) {
+                    ++i;
+                    continue;
+                }
+                if (slots[i].text) {
+                    gltDeleteText(slots[i].text);
+                }
+                size_t hole = i;
+                for (size_t j = (hole + 1) & mask; slots[j].id != 0; j = (j + 1) & mask) {
+                    size_t home = slots[j].id & mask;
+                    // Move j into the hole if its home slot is not cyclically in (hole, j]
+                    bool inRange = hole <= j ? (home > hole && home <= j) : (home > hole || home <= j);
+                    if (!inRange) {
+                        slots[hole] = slots[j];
+                        hole = j;
+                    }
+                }
+                slots[hole] = WidgetState();
+                --count;
+                // Re-examine slot i, something may have shifted into it
+            }
+        }
+
+        void clear() {
+            for (WidgetState& state : slots) {
+                if (state.text) {
+                    gltDeleteText(state.text);
+                }
+                state = WidgetState();
+            }
+            count = 0;
+        }
+    };
+
+    struct WindowFrame {
+        uint32_t id = 0;
+        float x = 0.0f, y = 0.0f, width = 0.0f, height = 0.0f;
+        float cursorX = 0.0f, cursorY = 0.0f;
+        float lineHeight = 0.0f;
+        float lastItemX = 0.0f, lastItemY = 0.0f, lastItemWidth = 0.0f;
+        int textCount = 0; // Text() items are keyed by position, so changing strings keep their cache slot
+        bool sameLine = false;
+        bool draggable = false;
+    };
+
+    struct Context {
+        StateTable states;
+        DrawList drawList;
+        uint32_t idStack[ID_STACK_DEPTH];
+        int idStackSize = 0;
+        uint32_t frame = 1;
+
+        // Input, accumulated from events between frames
+        int mouseX = 0, mouseY = 0;
+        bool mouseDown = false;
+        bool mousePressed = false, mouseReleased = false; // Edges seen since the last frame
+        float wheelY = 0.0f;
+
+        uint32_t activeID = 0;  // Widget holding the mouse (pressed on and not yet released)
+        uint32_t hoveredWindow = 0, nextHoveredWindow = 0;
+        // Union of the windows drawn last frame; mouse motion outside it cannot change anything
+        float boundsMinX = 0.0f, boundsMinY = 0.0f, boundsMaxX = 0.0f, boundsMaxY = 0.0f;
+        float nextMinX = 0.0f, nextMinY = 0.0f, nextMaxX = 0.0f, nextMaxY = 0.0f;
+        bool inWindow = false;
+        WindowFrame window;
+    };
+
+    // One per UI context, created on first use
+    Context& currentContext() {
+        return contextState<Context>();
+    }
+
+    Context& context = contextState<Context>(defaultUIContext()); // The default context's, under its former name
+
+    inline uint32_t currentSeed() {
+        Context& ctx = currentContext();
+        return ctx.idStackSize ? ctx.idStack[ctx.idStackSize - 1] : 0;
+    }
+
+    inline uint32_t getID(const char* label) {
+        return hashID(label, currentSeed());
+    }
+
+    void pushIDValue(uint32_t id) {
+        Context& ctx = currentContext();
+        if (ctx.idStackSize >= ID_STACK_DEPTH) {
+            std::cerr << "IM::PushID: ID stack overflow" << std::endl;
+            return;
+        }
+        ctx.idStack[ctx.idStackSize++] = id;
+    }
+
+    void PushID(const char* label) {
+        pushIDValue(getID(label));
+    }
+
+    void PushID(int index) {
+        pushIDValue(hashID(&index, sizeof(index), currentSeed()));
+    }
+
+    void PopID() {
+        Context& ctx = currentContext();
+        if (ctx.idStackSize == 0) {
+            std::cerr << "IM::PopID: ID stack underflow" << std::endl;
+            return;
+        }
+        --ctx.idStackSize;
+    }
+
+    WidgetState& stateFor(uint32_t id, bool& isNew) {
+        Context& ctx = currentContext();
+        WidgetState& state = ctx.states.obtain(id, isNew);
+        state.lastFrame = ctx.frame;
+        return state;
+    }
+
+    inline bool mouseIn(float x, float y, float w, float h) {
+        Context& ctx = currentContext();
+        return ctx.mouseX >= x && ctx.mouseX < x + w && ctx.mouseY >= y && ctx.mouseY < y + h;
+    }
+
+    // Only the topmost window under the mouse (as of last frame) receives input
+    inline bool windowAcceptsInput() {
+        Context& ctx = currentContext();
+        return !ctx.inWindow || ctx.hoveredWindow == ctx.window.id || ctx.activeID != 0;
+    }
+
+    // Feed SDL events in here between frames
+    inline bool inWindowBounds(int x, int y) {
+        Context& ctx = currentContext();
+        return x >= ctx.boundsMinX && x < ctx.boundsMaxX && y >= ctx.boundsMinY && y < ctx.boundsMaxY;
+    }
+
+    void handleEvent(SDL_Event* event) {
+        Context& ctx = currentContext();
+        switch (event->type) {
+        case SDL_MOUSEMOTION:
+            ctx.mouseX = event->motion.x;
+            ctx.mouseY = event->motion.y;
+            // Hover and drag feedback; moving out of a window needs one more frame to clear its hover state
+            if (ctx.mouseDown || ctx.hoveredWindow != 0 || inWindowBounds(ctx.mouseX, ctx.mouseY)) {
+                requestRedraw();
+            }
+            break;
+        case SDL_MOUSEBUTTONDOWN:
+            if (event->button.button == SDL_BUTTON_LEFT) {
+                ctx.mouseX = event->button.x;
+                ctx.mouseY = event->button.y;
+                ctx.mouseDown = true;
+                ctx.mousePressed = true;
+            }
+            break;
+        case SDL_MOUSEBUTTONUP:
+            if (event->button.button == SDL_BUTTON_LEFT) {
+                ctx.mouseX = event->button.x;
+                ctx.mouseY = event->button.y;
+                ctx.mouseDown = false;
+                ctx.mouseReleased = true;
+            }
+            break;
+        case SDL_MOUSEWHEEL:
+            ctx.wheelY += static_cast<float>(event->wheel.y);
+            break;
+        }
+        if (event->type == SDL_MOUSEBUTTONDOWN || event->type == SDL_MOUSEBUTTONUP || event->type == SDL_MOUSEWHEEL) {
+            requestRedraw(); // Clicks are only processed by the next frame's widget calls
+        }
+    }
+
+    void beginFrame() {
+        Context& ctx = currentContext();
+        ctx.drawList.clear();
+        ctx.idStackSize = 0;
+        ctx.hoveredWindow = ctx.nextHoveredWindow;
+        ctx.nextHoveredWindow = 0;
+        ctx.nextMinX = ctx.nextMinY = ctx.nextMaxX = ctx.nextMaxY = 0.0f;
+    }
+
+    void endFrame() {
+        Context& ctx = currentContext();
+        if (ctx.inWindow) {
+            std::cerr << "IM::endFrame: Begin() without matching End()" << std::endl;
+        }
+        ctx.boundsMinX = ctx.nextMinX;
+        ctx.boundsMinY = ctx.nextMinY;
+        ctx.boundsMaxX = ctx.nextMaxX;
+        ctx.boundsMaxY = ctx.nextMaxY;
+        if (!ctx.mouseDown) {
+            ctx.activeID = 0;
+        }
+        submitDrawList(ctx.drawList);
+
+        ctx.mousePressed = false;
+        ctx.mouseReleased = false;
+        ctx.wheelY = 0.0f;
+        if (ctx.frame % STATE_RETAIN_FRAMES == 0) {
+            ctx.states.sweep(ctx.frame - STATE_RETAIN_FRAMES);
+        }
+        ++ctx.frame;
+    }
+
+    void shutdown() {
+        currentContext().states.clear();
+    }
+
+    // Reserve space for an item in the current window and return its top-left corner
+    void placeItem(float width, float height, float& outX, float& outY) {
+        WindowFrame& w = currentContext().window;
+        if (w.sameLine) {
+            outX = w.lastItemX + w.lastItemWidth + ITEM_SPACING;
+            outY = w.lastItemY;
+            w.lineHeight = height > w.lineHeight ? height : w.lineHeight;
+            w.sameLine = false;
+        }
+        else {
+            w.cursorY += w.lineHeight > 0.0f ? w.lineHeight + ITEM_SPACING : 0.0f;
+            outX = w.cursorX;
+            outY = w.cursorY;
+            w.lineHeight = height;
+        }
+        w.lastItemX = outX;
+        w.lastItemY = outY;
+        w.lastItemWidth = width;
+    }
+
+    void SameLine() {
+        currentContext().window.sameLine = true;
+    }
+
+    // IM widgets have no style class: they take the active theme's defaults, like retained components
+    inline const ResolvedStyle& style(StyleComponent part, StyleState state = StyleState::Normal) {
+        return currentActiveTheme()->lookup(0, part, state);
+    }
+
+    // Cached label geometry; gltSetText is a no-op when the string did not change
+    GLTtext* labelText(WidgetState& state, const char* label) {
+        if (!state.text) {
+            state.text = gltCreateText();
+        }
+        setGLText(state.text, label);
+        return state.text;
+    }
+
+    bool Begin(const char* name, float x, float y, float width, float height, int options = WIDGET_NONE, GLuint texture = 0) {
+        Context& ctx = currentContext();
+        if (ctx.inWindow) {
+            std::cerr << "IM::Begin: windows cannot be nested, call End() first" << std::endl;
+            return false;
+        }
+        uint32_t id = getID(name);
+        bool isNew;
+        WidgetState& state = stateFor(id, isNew);
+        if (isNew) {
+            state.x = x;
+            state.y = y;
+        }
+
+        WindowFrame& w = ctx.window;
+        w = WindowFrame();
+        w.id = id;
+        w.x = state.x;
+        w.y = state.y;
+        w.width = width;
+        w.height = height;
+        w.cursorX = w.x + WINDOW_PADDING;
+        w.cursorY = w.y + WINDOW_PADDING;
+        w.draggable = hasFlag(options, WIDGET_DRAGGABLE);
+        ctx.inWindow = true;
+
+        if (mouseIn(w.x, w.y, width, height)) {
+            ctx.nextHoveredWindow = id; // Later windows draw on top, so the last hit wins
+        }
+        if (ctx.nextMaxX <= ctx.nextMinX) {
+            ctx.nextMinX = w.x;
+            ctx.nextMinY = w.y;
+            ctx.nextMaxX = w.x + width;
+            ctx.nextMaxY = w.y + height;
+        }
+        else {
+            ctx.nextMinX = std::min(ctx.nextMinX, w.x);
+            ctx.nextMinY = std::min(ctx.nextMinY, w.y);
+            ctx.nextMaxX = std::max(ctx.nextMaxX, w.x + width);
+            ctx.nextMaxY = std::max(ctx.nextMaxY, w.y + height);
+        }
+
+        if (texture) {
+            ctx.drawList.addImage(texture, w.x, w.y, width, height);
+        }
+        else {
+            ctx.drawList.addRect(w.x, w.y, width, height, style(StyleComponent::Window).background);
+        }
+        pushIDValue(id);
+        return true;
+    }
+
+    void End() {
+        Context& ctx = currentContext();
+        if (!ctx.inWindow) {
+            std::cerr << "IM::End: no window to end" << std::endl;
+            return;
+        }
+        WindowFrame& w = ctx.window;
+        bool isNew;
+        WidgetState& state = stateFor(w.id, isNew);
+
+        // Items were processed first, so a press that none of them claimed starts a window drag
+        if (w.draggable) {
+            if (ctx.mousePressed && ctx.activeID == 0 && ctx.hoveredWindow == w.id && mouseIn(w.x, w.y, w.width, w.height)) {
+                ctx.activeID = w.id;
+                state.flags |= STATE_DRAGGING;
+                state.dragOffsetX = ctx.mouseX - state.x;
+                state.dragOffsetY = ctx.mouseY - state.y;
+            }
+            if ((state.flags & STATE_DRAGGING) && ctx.activeID == w.id && ctx.mouseDown) {
+                state.x = ctx.mouseX - state.dragOffsetX;
+                state.y = ctx.mouseY - state.dragOffsetY;
+            }
+            else {
+                state.flags &= ~STATE_DRAGGING;
+            }
+        }
+
+        PopID();
+        ctx.inWindow = false;
+    }
+
+    void TextColored(const char* text, uint32_t color, float scale = TEXT_SCALE) {
+        Context& ctx = currentContext();
+        int index = ctx.window.textCount++;
+        uint32_t id = hashID(&index, sizeof(index), currentSeed() ^ 0x54455854u);
+        bool isNew;
+        WidgetState& state = stateFor(id, isNew);
+        GLTtext* glt = labelText(state, text);
+
+        float width = gltGetTextWidth(glt, scale);
+        float height = gltGetTextHeight(glt, scale);
+        float x, y;
+        placeItem(width, height, x, y);
+        ctx.drawList.addText(glt, text, std::strlen(text), x, y, scale, color);
+    }
+
+    // In the theme's text color
+    void Text(const char* text, float scale = TEXT_SCALE) {
+        TextColored(text, style(StyleComponent::Text).text, scale);
+    }
+
+    void Text(const char* text, float scale, float r, float g, float b) {
+        TextColored(text, packColor(r, g, b), scale);
+    }
+
+    // Returns true on the frame the button is released while still under the mouse
+    bool Button(const char* label, float width = 0.0f, float height = 0.0f) {
+        Context& ctx = currentContext();
+        uint32_t id = getID(label);
+        bool isNew;
+        WidgetState& state = stateFor(id, isNew);
+        GLTtext* glt = labelText(state, label);
+
+        if (width <= 0.0f) width = gltGetTextWidth(glt, TEXT_SCALE) + 2.0f * WINDOW_PADDING;
+        if (height <= 0.0f) height = gltGetTextHeight(glt, TEXT_SCALE) + WINDOW_PADDING;
+        float x, y;
+        placeItem(width, height, x, y);
+
+        bool hovered = windowAcceptsInput() && mouseIn(x, y, width, height) && (ctx.activeID == 0 || ctx.activeID == id);
+        bool clicked = false;
+        if (hovered && ctx.mousePressed && ctx.activeID == 0) {
+            ctx.activeID = id;
+        }
+        if (ctx.activeID == id && ctx.mouseReleased) {
+            clicked = hovered;
+            ctx.activeID = 0;
+        }
+
+        const ResolvedStyle& look = style(StyleComponent::Button, ctx.activeID == id ? StyleState::Pressed : (hovered ? StyleState::Hover : StyleState::Normal));
+        ctx.drawList.addRect(x, y, width, height, look.background);
+        ctx.drawList.addText(glt, label, std::strlen(label), x + width / 2.0f, y + height / 2.0f, TEXT_SCALE, look.text, GLT_CENTER, GLT_CENTER);
+        state.flags = hovered ? (state.flags | STATE_HOVERED) : (state.flags & ~STATE_HOVERED);
+        return clicked;
+    }
+
+    // Toggles *value on click; returns true when it changed
+    bool Checkbox(const char* label, bool* value) {
+        Context& ctx = currentContext();
+        uint32_t id = getID(label);
+        bool isNew;
+        WidgetState& state = stateFor(id, isNew);
+        GLTtext* glt = labelText(state, label);
+
+        float box = gltGetTextHeight(glt, TEXT_SCALE);
+        float width = box + ITEM_SPACING + gltGetTextWidth(glt, TEXT_SCALE);
+        float x, y;
+        placeItem(width, box, x, y);
+
+        bool hovered = windowAcceptsInput() && mouseIn(x, y, width, box) && (ctx.activeID == 0 || ctx.activeID == id);
+        bool changed = false;
+        if (hovered && ctx.mousePressed && ctx.activeID == 0) {
+            ctx.activeID = id;
+        }
+        if (ctx.activeID == id && ctx.mouseReleased) {
+            if (hovered) {
+                *value = !*value;
+                changed = true;
+            }
+            ctx.activeID = 0;
+        }
+
+        const ResolvedStyle& look = style(StyleComponent::Checkbox, ctx.activeID == id ? StyleState::Pressed : (hovered ? StyleState::Hover : StyleState::Normal));
+        ctx.drawList.addRect(x, y, box, box, look.background);
+        if (*value) {
+            float inset = box * 0.25f;
+            ctx.drawList.addRect(x + inset, y + inset, box - 2.0f * inset, box - 2.0f * inset, look.accent);
+        }
+        ctx.drawList.addText(glt, label, std::strlen(label), x + box + ITEM_SPACING, y, TEXT_SCALE, look.text);
+        return changed;
+    }
+
+    // Scrollable list of rows. Only the rows inside the box are emitted, clipped to it.
+    // *selected is read and written by the caller; returns true when the selection changed.
+    bool ListBox(const char* label, const char* const* items, int itemCount, int* selected, float width, int visibleRows = 6) {
+        Context& ctx = currentContext();
+        uint32_t id = getID(label);
+        bool isNew;
+        WidgetState& state = stateFor(id, isNew);
+
+        const float rowHeight = 20.0f;
+        float height = rowHeight * visibleRows;
+        float x, y;
+        placeItem(width, height, x, y);
+
+        bool hovered = windowAcceptsInput() && mouseIn(x, y, width, height);
+        float maxScroll = itemCount * rowHeight - height;
+        if (maxScroll < 0.0f) maxScroll = 0.0f;
+        if (hovered) {
+            state.scrollY -= ctx.wheelY * rowHeight * 3.0f;
+        }
+        state.scrollY = state.scrollY < 0.0f ? 0.0f : (state.scrollY > maxScroll ? maxScroll : state.scrollY);
+
+        int first = static_cast<int>(state.scrollY / rowHeight);
+        int last = static_cast<int>((state.scrollY + height) / rowHeight);
+        if (last >= itemCount) last = itemCount - 1;
+
+        int hoveredRow = -1;
+        if (hovered) {
+            hoveredRow = static_cast<int>((ctx.mouseY - y + state.scrollY) / rowHeight);
+            if (hoveredRow >= itemCount) hoveredRow = -1;
+        }
+        bool changed = false;
+        if (hoveredRow >= 0 && ctx.mousePressed && ctx.activeID == 0 && *selected != hoveredRow) {
+            *selected = hoveredRow;
+            changed = true;
+        }
+        state.selected = *selected;
+
+        ctx.drawList.addRect(x, y, width, height, style(StyleComponent::ListBox).background);
+        pushIDValue(id);
+        // Rows at the edges are only partly inside the box; the clip trims them
+        ctx.drawList.pushClip(x, y, width, height);
+        for (int i = first; i <= last; ++i) {
+            float rowY = y + i * rowHeight - state.scrollY;
+            const ResolvedStyle& row = style(StyleComponent::ListRow, i == *selected ? StyleState::Selected : (i == hoveredRow ? StyleState::Hover : StyleState::Normal));
+            if (i == *selected || i == hoveredRow) {
+                ctx.drawList.addRect(x, rowY, width, rowHeight, row.background);
+            }
+            // Row text is cached per visible slot, so scrolling re-uses the same few GLTtext objects
+            int slot = i - first;
+            bool rowIsNew;
+            WidgetState& rowState = stateFor(hashID(&slot, sizeof(slot), currentSeed()), rowIsNew);
+            GLTtext* glt = labelText(rowState, items[i]);
+            ctx.drawList.addText(glt, items[i], std::strlen(items[i]), x + 5.0f, rowY + rowHeight / 2.0f, TEXT_SCALE, row.text, GLT_LEFT, GLT_CENTER);
+        }
+        ctx.drawList.popClip();
+        PopID();
+        return changed;
+    }
+
+} // namespace IM
+} // namespace SV_UI
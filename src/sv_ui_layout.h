@@ -0,0 +1,557 @@
+#pragma once
+
+//////////////////////////////////////////////////////////
+////////////SV UI LAYOUT FILES////////////////////////////
+//////////////////////////////////////////////////////////
+// Screens described in a text file instead of code. The text is compiled once
+// (at build time, or by a tool) into a binary file that loadLayout() maps into
+// memory and replays through the builder API, without parsing or copying strings.
+//
+// Text format, one statement per line, indentation is free, '#' starts a comment:
+//
+//     widget id=1 x=0 y=0 w=400 h=400 draggable texture="metalPanel_green.png"
+//         layout vertical padding=10 spacing=8
+//         text "Hello World" size=2
+//         stack horizontal spacing=4
+//             button "OK" size=1 w=75 h=30 name=ok
+//             button "Cancel" size=1 w=75 h=30 name=cancel
+//         end
+//         listbox w=250 h=100 name=options
+//             item "Option 1"
+//             item "Option 2"
+//         end
+//     end
+//
+// Statements: widget, layout, text, button, stack ... end, listbox ... end
+// (with item lines), end. Keys: id x y w h size padding spacing flex align
+// (TopLeft ... BottomRight) texture name draggable. Callbacks cannot live in a
+// file; name elements and bind them after loading:
+//
+//     auto screen = SV_UI::loadLayout("main.svl");
+//     screen->button("ok")->onClick = [] { ... };
+//
+// ListBox rows point straight into the mapped file, so the LoadedLayout must stay
+// alive while its widgets are shown.
+//
+// Binary layout (all fields little-endian, 4-byte aligned):
+//   LayoutFileHeader | LayoutRecord[recordCount] | LayoutStringRef[stringCount] | string pool
+// Strings in the pool are null-terminated so they can be handed to glText directly.
+// Fields are read in place, so compiling and loading are refused on big-endian hosts.
+
+#include "sv_ui3.0.h"
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+namespace SV_UI {
+
+    const uint32_t LAYOUT_MAGIC = 0x4c555653; // "SVUL"
+    const uint32_t LAYOUT_VERSION = 1;
+    const uint32_t LAYOUT_NO_STRING = 0xffffffffu;
+
+    enum class LayoutOp : uint8_t {
+        Widget,
+        Layout,
+        Text,
+        Button,
+        ListBox,
+        BeginStack,
+        EndStack,
+        EndWidget
+    };
+
+    // The file is the in-memory structs, which only match the little-endian format on a little-endian host
+    inline bool layoutByteOrderSupported() {
+        const uint32_t probe = 1;
+        unsigned char lowByte;
+        std::memcpy(&lowByte, &probe, 1);
+        return lowByte == 1;
+    }
+
+    const uint8_t LAYOUT_FLAG_DRAGGABLE = 1;
+    const uint8_t LAYOUT_FLAG_ALIGNED = 2; // align= was given; otherwise the builder's default stays
+
+    struct LayoutFileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t recordCount;
+        uint32_t stringCount;
+        uint32_t poolSize;
+    };
+
+    // One builder call
+    struct LayoutRecord {
+        uint8_t op;
+        uint8_t direction; // LayoutDirection
+        uint8_t alignment; // Alignment
+        uint8_t flags;
+        int32_t id;
+        int32_t x, y, width, height;
+        float fontSize, padding, spacing, flex;
+        uint32_t text;    // Index into the string table, or LAYOUT_NO_STRING
+        uint32_t texture;
+        uint32_t name;
+        uint32_t firstItem, itemCount; // ListBox rows, consecutive string table entries
+    };
+
+    struct LayoutStringRef {
+        uint32_t offset, length; // Into the pool, length without the terminator
+    };
+
+    //////////////////////////////////////////////////////////
+    // Compiler
+
+    struct LayoutCompiler {
+        std::vector<LayoutRecord> records;
+        std::vector<LayoutStringRef> strings;
+        std::string pool;
+        std::vector<LayoutOp> open; // Blocks waiting for "end"
+        int lineNumber = 0;
+        bool failed = false;
+
+        uint32_t addString(const std::string& text) {
+            LayoutStringRef ref;
+            ref.offset = static_cast<uint32_t>(pool.size());
+            ref.length = static_cast<uint32_t>(text.size());
+            pool += text;
+            pool.push_back('\0');
+            strings.push_back(ref);
+            return static_cast<uint32_t>(strings.size() - 1);
+        }
+
+        void error(const std::string& message) {
+            std::cerr << "Layout line " << lineNumber << ": " << message << std::endl;
+            failed = true;
+        }
+
+        // Split a line into words; quoted strings (with \" and \\ escapes) stay whole, key="value" too
+        static bool tokenize(const std::string& line, std::vector<std::string>& tokens) {
+            tokens.clear();
+            size_t i = 0;
+            while (i < line.size()) {
+                while (i < line.size() && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) ++i;
+                if (i >= line.size() || line[i] == '#') {
+                    break;
+                }
+                std::string token;
+                while (i < line.size() && line[i] != ' ' && line[i] != '\t' && line[i] != '\r') {
+                    if (line[i] == '"') {
+                        token.push_back('"');
+                        ++i;
+                        while (i < line.size() && line[i] != '"') {
+                            if (line[i] == '\\' && i + 1 < line.size()) ++i;
+                            token.push_back(line[i++]);
+                        }
+                        if (i >= line.size()) {
+                            return false; // Unterminated string
+                        }
+                        ++i;
+                    }
+                    else {
+                        token.push_back(line[i++]);
+                    }
+                }
+                tokens.push_back(token);
+            }
+            return true;
+        }
+
+        static std::string unquote(const std::string& token) {
+            return !token.empty() && token[0] == '"' ? token.substr(1) : token;
+        }
+
+        static bool parseDirection(const std::string& word, uint8_t& out) {
+            if (word == "vertical") out = static_cast<uint8_t>(LayoutDirection::Vertical);
+            else if (word == "horizontal") out = static_cast<uint8_t>(LayoutDirection::Horizontal);
+            else if (word == "overlay") out = static_cast<uint8_t>(LayoutDirection::Overlay);
+            else return false;
+            return true;
+        }
+
+        static bool parseAlignment(const std::string& word, uint8_t& out) {
+            static const char* names[] = { "TopLeft", "TopCenter", "TopRight", "CenterLeft", "Center",
+                "CenterRight", "BottomLeft", "BottomCenter", "BottomRight" };
+            for (uint8_t i = 0; i < 9; ++i) {
+                if (word == names[i]) {
+                    out = i;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        LayoutRecord makeRecord(LayoutOp op) {
+            LayoutRecord record;
+            std::memset(&record, 0, sizeof(record));
+            record.op = static_cast<uint8_t>(op);
+            record.text = record.texture = record.name = LAYOUT_NO_STRING;
+            record.fontSize = 1.0f;
+            return record;
+        }
+
+        // Apply key=value words (and bare flags) from tokens[first..] to record
+        void applyKeys(LayoutRecord& record, const std::vector<std::string>& tokens, size_t first) {
+            for (size_t t = first; t < tokens.size() && !failed; ++t) {
+                const std::string& token = tokens[t];
+                size_t eq = token.find('=');
+                std::string key = token.substr(0, eq);
+                std::string value = eq == std::string::npos ? "" : unquote(token.substr(eq + 1));
+                try {
+                    if (key == "draggable" && eq == std::string::npos) record.flags |= LAYOUT_FLAG_DRAGGABLE;
+                    else if (eq == std::string::npos) error("expected key=value, got '" + token + "'");
+                    else if (key == "id") record.id = std::stoi(value);
+                    else if (key == "x") record.x = std::stoi(value);
+                    else if (key == "y") record.y = std::stoi(value);
+                    else if (key == "w") record.width = std::stoi(value);
+                    else if (key == "h") record.height = std::stoi(value);
+                    else if (key == "size") record.fontSize = std::stof(value);
+                    else if (key == "padding") record.padding = std::stof(value);
+                    else if (key == "spacing") record.spacing = std::stof(value);
+                    else if (key == "flex") record.flex = std::stof(value);
+                    else if (key == "texture") record.texture = addString(value);
+                    else if (key == "name") record.name = addString(value);
+                    else if (key == "align") {
+                        if (!parseAlignment(value, record.alignment)) error("unknown alignment '" + value + "'");
+                        record.flags |= LAYOUT_FLAG_ALIGNED;
+                    }
+                    else error("unknown key '" + key + "'");
+                }
+                catch (const std::exception&) {
+                    error("bad number for '" + key + "'");
+                }
+            }
+        }
+
+        void compileLine(const std::string& line) {
+            std::vector<std::string> tokens;
+            if (!tokenize(line, tokens)) {
+                error("unterminated string");
+                return;
+            }
+            if (tokens.empty()) {
+                return;
+            }
+            const std::string& statement = tokens[0];
+            bool inListBox = !open.empty() && open.back() == LayoutOp::ListBox;
+            if (inListBox && statement != "item" && statement != "end") {
+                error("only item lines may appear inside a listbox");
+                return;
+            }
+            if (statement != "widget" && statement != "end" && open.empty()) {
+                error("'" + statement + "' outside of a widget");
+                return;
+            }
+
+            if (statement == "widget") {
+                if (!open.empty()) {
+                    error("widgets cannot be nested");
+                    return;
+                }
+                LayoutRecord record = makeRecord(LayoutOp::Widget);
+                applyKeys(record, tokens, 1);
+                records.push_back(record);
+                open.push_back(LayoutOp::Widget);
+            }
+            else if (statement == "layout" || statement == "stack") {
+                LayoutRecord record = makeRecord(statement == "layout" ? LayoutOp::Layout : LayoutOp::BeginStack);
+                if (tokens.size() < 2 || !parseDirection(tokens[1], record.direction)) {
+                    error(statement + " needs vertical, horizontal or overlay");
+                    return;
+                }
+                applyKeys(record, tokens, 2);
+                records.push_back(record);
+                if (statement == "stack") {
+                    open.push_back(LayoutOp::BeginStack);
+                }
+            }
+            else if (statement == "text" || statement == "button") {
+                if (tokens.size() < 2 || tokens[1].empty() || tokens[1][0] != '"') {
+                    error(statement + " needs a quoted string");
+                    return;
+                }
+                LayoutRecord record = makeRecord(statement == "text" ? LayoutOp::Text : LayoutOp::Button);
+                record.text = addString(unquote(tokens[1]));
+                if (statement == "button") {
+                    record.width = 100;
+                    record.height = 50;
+                    record.alignment = static_cast<uint8_t>(Alignment::BottomCenter);
+                }
+                applyKeys(record, tokens, 2);
+                records.push_back(record);
+            }
+            else if (statement == "listbox") {
+                LayoutRecord record = makeRecord(LayoutOp::ListBox);
+                record.width = 100;
+                record.height = 100;
+                applyKeys(record, tokens, 1);
+                records.push_back(record);
+                open.push_back(LayoutOp::ListBox);
+            }
+            else if (statement == "item") {
+                if (!inListBox || tokens.size() != 2 || tokens[1].empty() || tokens[1][0] != '"') {
+                    error("item needs a quoted string inside a listbox");
+                    return;
+                }
+                // Items are added right after their listbox's other strings, so they are consecutive
+                LayoutRecord& listBox = records.back();
+                uint32_t index = addString(unquote(tokens[1]));
+                if (listBox.itemCount == 0) {
+                    listBox.firstItem = index;
+                }
+                else if (listBox.firstItem + listBox.itemCount != index) {
+                    error("internal: listbox items are not consecutive");
+                }
+                ++listBox.itemCount;
+            }
+            else if (statement == "end") {
+                if (open.empty()) {
+                    error("'end' without an open block");
+                    return;
+                }
+                LayoutOp block = open.back();
+                open.pop_back();
+                if (block == LayoutOp::Widget) records.push_back(makeRecord(LayoutOp::EndWidget));
+                else if (block == LayoutOp::BeginStack) records.push_back(makeRecord(LayoutOp::EndStack));
+            }
+            else {
+                error("unknown statement '" + statement + "'");
+            }
+        }
+    };
+
+    // Compile layout text into the binary format; returns false and reports to std::cerr on errors
+    bool compileLayout(const std::string& source, std::vector<char>& out) {
+        if (!layoutByteOrderSupported()) {
+            std::cerr << "Layout files are little-endian and cannot be written on this big-endian host" << std::endl;
+            return false;
+        }
+        LayoutCompiler compiler;
+        std::istringstream lines(source);
+        std::string line;
+        while (std::getline(lines, line) && !compiler.failed) {
+            ++compiler.lineNumber;
+            compiler.compileLine(line);
+        }
+        if (!compiler.failed && !compiler.open.empty()) {
+            compiler.error("missing 'end' at end of file");
+        }
+        if (compiler.failed) {
+            return false;
+        }
+
+        LayoutFileHeader header;
+        header.magic = LAYOUT_MAGIC;
+        header.version = LAYOUT_VERSION;
+        header.recordCount = static_cast<uint32_t>(compiler.records.size());
+        header.stringCount = static_cast<uint32_t>(compiler.strings.size());
+        header.poolSize = static_cast<uint32_t>(compiler.pool.size());
+        out.clear();
+        auto append = [&out](const void* data, size_t size) {
+            const char* bytes = static_cast<const char*>(data);
+            out.insert(out.end(), bytes, bytes + size);
+        };
+        append(&header, sizeof(header));
+        append(compiler.records.data(), compiler.records.size() * sizeof(LayoutRecord));
+        append(compiler.strings.data(), compiler.strings.size() * sizeof(LayoutStringRef));
+        append(compiler.pool.data(), compiler.pool.size());
+        return true;
+    }
+
+    bool compileLayoutFile(const std::string& sourcePath, const std::string& binaryPath) {
+        std::ifstream in(sourcePath, std::ios::binary);
+        if (!in) {
+            std::cerr << "Failed to open layout source " << sourcePath << std::endl;
+            return false;
+        }
+        std::stringstream text;
+        text << in.rdbuf();
+        std::vector<char> binary;
+        if (!compileLayout(text.str(), binary)) {
+            std::cerr << "Failed to compile layout " << sourcePath << std::endl;
+            return false;
+        }
+        std::ofstream outFile(binaryPath, std::ios::binary | std::ios::trunc);
+        outFile.write(binary.data(), binary.size());
+        if (!outFile) {
+            std::cerr << "Failed to write layout binary " << binaryPath << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    //////////////////////////////////////////////////////////
+    // Loader
+
+    // Rows of a listbox, read in place from the mapped file
+    struct MappedListSource : public ListDataSource {
+        const LayoutStringRef* refs = nullptr;
+        const char* pool = nullptr;
+        int count = 0;
+
+        virtual int rowCount() const override {
+            return count;
+        }
+
+        virtual std::string_view rowText(int row) const override {
+            return std::string_view(pool + refs[row].offset, refs[row].length);
+        }
+    };
+
+    struct LoadedLayout {
+        MappedFile file;
+        std::vector<MappedListSource> sources;
+        std::unordered_map<std::string_view, UIComponent*> components; // By name=, keys point into file
+        std::unordered_map<std::string_view, Widget*> widgets;
+
+        LoadedLayout() = default;
+        LoadedLayout(const LoadedLayout&) = delete;
+        LoadedLayout& operator=(const LoadedLayout&) = delete;
+
+        ~LoadedLayout() {
+            sources.clear(); // Detaches the list boxes before the rows are unmapped
+            untrackResource(ResourceKind::Host, resourceHandle(file.data));
+        }
+
+        UIComponent* component(std::string_view name) const {
+            auto it = components.find(name);
+            return it == components.end() ? nullptr : it->second;
+        }
+
+        ButtonComponent* button(std::string_view name) const {
+            return dynamic_cast<ButtonComponent*>(component(name));
+        }
+
+        TextComponent* text(std::string_view name) const {
+            return dynamic_cast<TextComponent*>(component(name));
+        }
+
+        ListBoxComponent* listBox(std::string_view name) const {
+            return dynamic_cast<ListBoxComponent*>(component(name));
+        }
+
+        Widget* widget(std::string_view name) const {
+            auto it = widgets.find(name);
+            return it == widgets.end() ? nullptr : it->second;
+        }
+    };
+
+    // Build the screen described by a compiled layout file. Returns nullptr if the file is
+    // missing or malformed; nothing is created in that case.
+    std::unique_ptr<LoadedLayout> loadLayout(const std::string& path) {
+        if (!layoutByteOrderSupported()) {
+            std::cerr << "Layout " << path << " is little-endian and cannot be read on this big-endian host" << std::endl;
+            return nullptr;
+        }
+        std::unique_ptr<LoadedLayout> layout(new LoadedLayout());
+        if (!layout->file.open(path)) {
+            std::cerr << "Failed to open layout " << path << std::endl;
+            return nullptr;
+        }
+        trackResource(ResourceKind::Host, resourceHandle(layout->file.data), layout->file.size, "Layout", path);
+
+        // Validate everything up front, so replay can index without checks
+        const char* data = layout->file.data;
+        LayoutFileHeader header;
+        if (layout->file.size < sizeof(header)) {
+            std::cerr << "Layout " << path << " is truncated" << std::endl;
+            return nullptr;
+        }
+        std::memcpy(&header, data, sizeof(header));
+        size_t recordsEnd = sizeof(header) + static_cast<size_t>(header.recordCount) * sizeof(LayoutRecord);
+        size_t stringsEnd = recordsEnd + static_cast<size_t>(header.stringCount) * sizeof(LayoutStringRef);
+        if (header.magic != LAYOUT_MAGIC || header.version != LAYOUT_VERSION || stringsEnd + header.poolSize != layout->file.size) {
+            std::cerr << "Layout " << path << " has a bad header or size" << std::endl;
+            return nullptr;
+        }
+        const LayoutRecord* records = reinterpret_cast<const LayoutRecord*>(data + sizeof(header));
+        const LayoutStringRef* refs = reinterpret_cast<const LayoutStringRef*>(data + recordsEnd);
+        const char* pool = data + stringsEnd;
+        for (uint32_t i = 0; i < header.stringCount; ++i) {
+            if (static_cast<size_t>(refs[i].offset) + refs[i].length >= header.poolSize || pool[refs[i].offset + refs[i].length] != '\0') {
+                std::cerr << "Layout " << path << " has a bad string table" << std::endl;
+                return nullptr;
+            }
+        }
+        size_t listBoxes = 0;
+        int depth = 0;
+        for (uint32_t i = 0; i < header.recordCount; ++i) {
+            const LayoutRecord& r = records[i];
+            auto stringOk = [&](uint32_t s) { return s == LAYOUT_NO_STRING || s < header.stringCount; };
+            bool ok = r.op <= static_cast<uint8_t>(LayoutOp::EndWidget) && r.direction <= 2 && r.alignment <= 8 &&
+                stringOk(r.text) && stringOk(r.texture) && stringOk(r.name) &&
+                static_cast<uint64_t>(r.firstItem) + r.itemCount <= header.stringCount;
+            LayoutOp op = static_cast<LayoutOp>(r.op);
+            if (op == LayoutOp::Widget) ok = ok && depth++ == 0;
+            else if (op == LayoutOp::BeginStack) ok = ok && depth++ > 0;
+            else if (op == LayoutOp::EndStack) ok = ok && depth-- > 1;
+            else if (op == LayoutOp::EndWidget) ok = ok && depth-- == 1;
+            else ok = ok && depth > 0;
+            if ((op == LayoutOp::Text || op == LayoutOp::Button) && r.text == LAYOUT_NO_STRING) ok = false;
+            if (!ok) {
+                std::cerr << "Layout " << path << " has a bad record " << i << std::endl;
+                return nullptr;
+            }
+            if (op == LayoutOp::ListBox) ++listBoxes;
+        }
+        if (depth != 0) {
+            std::cerr << "Layout " << path << " has unbalanced blocks" << std::endl;
+            return nullptr;
+        }
+
+        auto str = [&](uint32_t s) { return pool + refs[s].offset; };
+        auto view = [&](uint32_t s) { return std::string_view(pool + refs[s].offset, refs[s].length); };
+        layout->sources.resize(listBoxes); // Never resized again, list boxes keep pointers into it
+        size_t nextSource = 0;
+
+        for (uint32_t i = 0; i < header.recordCount; ++i) {
+            const LayoutRecord& r = records[i];
+            UIComponent* created = nullptr;
+            switch (static_cast<LayoutOp>(r.op)) {
+            case LayoutOp::Widget:
+                createWidget(r.id, r.x, r.y, r.width, r.height, (r.flags & LAYOUT_FLAG_DRAGGABLE) ? WIDGET_DRAGGABLE : 0,
+                    r.texture == LAYOUT_NO_STRING ? std::string() : std::string(view(r.texture)));
+                if (r.name != LAYOUT_NO_STRING) {
+                    layout->widgets[view(r.name)] = currentUIManager().currentWidget;
+                }
+                break;
+            case LayoutOp::Layout:
+                setLayout(static_cast<LayoutDirection>(r.direction), r.padding, r.spacing);
+                break;
+            case LayoutOp::Text:
+                created = Text(str(r.text), r.fontSize);
+                break;
+            case LayoutOp::Button:
+                created = Button(str(r.text), r.fontSize, r.texture == LAYOUT_NO_STRING ? std::string() : std::string(view(r.texture)),
+                    nullptr, r.width, r.height, static_cast<Alignment>(r.alignment));
+                break;
+            case LayoutOp::ListBox: {
+                MappedListSource& source = layout->sources[nextSource++];
+                source.refs = refs + r.firstItem;
+                source.pool = pool;
+                source.count = static_cast<int>(r.itemCount);
+                created = ListBox(&source, nullptr, r.width, r.height);
+                break;
+            }
+            case LayoutOp::BeginStack:
+                created = beginStack(static_cast<LayoutDirection>(r.direction), r.padding, r.spacing, r.width, r.height);
+                break;
+            case LayoutOp::EndStack:
+                endStack();
+                break;
+            case LayoutOp::EndWidget:
+                endWidget();
+                break;
+            }
+            if (created) {
+                if (r.flags & LAYOUT_FLAG_ALIGNED) {
+                    created->alignment = static_cast<Alignment>(r.alignment);
+                }
+                created->flex = r.flex;
+                if (r.name != LAYOUT_NO_STRING) {
+                    layout->components[view(r.name)] = created;
+                }
+            }
+        }
+        return layout;
+    }
+}
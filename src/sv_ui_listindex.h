@@ -0,0 +1,762 @@
+#pragma once
+
+//////////////////////////////////////////////////////////
+////////////SV UI LIST INDEX//////////////////////////////
+//////////////////////////////////////////////////////////
+// ListIndexView is a ListDataSource that filters and sorts another source
+// without copying its rows. Hand it to ListBox() in place of the source:
+//
+//     SV_UI::VectorListSource assets(names);
+//     SV_UI::ListIndexView view(&assets);
+//     view.setSort(SV_UI::SortOrder::Ascending);
+//     SV_UI::ListBox(&view, onSelected, 300, 400);
+//
+// Typing while the mouse is over the list drives setFilterQuery(). Matching is
+// ASCII case-insensitive, and by default a row matches when it starts with the
+// query (FilterMode::Prefix); setFilterMode(FilterMode::Substring) matches the
+// query anywhere in the row, at the cost of a linear scan (see below). Every base row gets a handle that follows it through
+// base edits, and the view keeps sequences of handles (never the text):
+//   - baseRows: every handle in base order, so a handle's position is its row
+//   - order:    every handle in display order (empty when unsorted)
+//   - visible:  the handles of order that match the current query
+//   - keyIndex: handles sorted by folded text, built on first prefix search,
+//               so a prefix query is two binary searches
+// The sequences are implicit treaps (RowSequence), so a single-row insert,
+// remove, update or move costs O(log^2 n) and nothing is renumbered. They take
+// about 16 bytes per row each. Substring queries have no index: a new query
+// scans every row, O(n) text compares split across threads, and only when a
+// query grows (the old query is contained in the new one) are the current
+// matches refined instead. Prefer prefix mode for large sources.
+// Base edits are reported to the list as precise insert/remove/move
+// notifications. The base source's rowText() must be safe to call from
+// several threads at once.
+
+#include "sv_ui3.0.h"
+#include "sv_ui_parallel.h"
+#include <numeric>
+#include <cstdint>
+
+namespace SV_UI {
+
+    inline char foldChar(char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+
+    inline std::string foldString(std::string_view text) {
+        std::string folded(text);
+        for (char& c : folded) c = foldChar(c);
+        return folded;
+    }
+
+    inline int compareFolded(std::string_view a, std::string_view b) {
+        size_t n = a.size() < b.size() ? a.size() : b.size();
+        for (size_t i = 0; i < n; ++i) {
+            char ca = foldChar(a[i]), cb = foldChar(b[i]);
+            if (ca != cb) return static_cast<unsigned char>(ca) < static_cast<unsigned char>(cb) ? -1 : 1;
+        }
+        return a.size() == b.size() ? 0 : (a.size() < b.size() ? -1 : 1);
+    }
+
+    // needle must already be folded
+    inline bool startsWithFolded(std::string_view text, std::string_view needle) {
+        if (text.size() < needle.size()) return false;
+        for (size_t i = 0; i < needle.size(); ++i) {
+            if (foldChar(text[i]) != needle[i]) return false;
+        }
+        return true;
+    }
+
+    // needle must already be folded; returns npos when absent
+    inline size_t findFolded(std::string_view text, std::string_view needle) {
+        if (needle.empty()) return 0;
+        if (text.size() < needle.size()) return std::string_view::npos;
+        char first = needle[0];
+        for (size_t i = 0; i + needle.size() <= text.size(); ++i) {
+            if (foldChar(text[i]) == first && startsWithFolded(text.substr(i), needle)) {
+                return i;
+            }
+        }
+        return std::string_view::npos;
+    }
+
+    enum class SortOrder {
+        None,       // Base order
+        Ascending,
+        Descending
+    };
+
+    enum class FilterMode {
+        Substring,
+        Prefix
+    };
+
+    // A sequence of row handles (small non-negative ints) kept as an implicit treap
+    // in arrays indexed by handle. Inserting or erasing at a position, reading the
+    // handle at a position and finding a handle's position are all O(log n).
+    struct RowSequence {
+        std::vector<int> left, right, parent;
+        std::vector<int> size; // Subtree size; 0 means the handle is not in the sequence
+        int root = -1;
+
+        // Fixed per handle: a bijective hash is as good as a random heap priority
+        static uint32_t priority(int handle) {
+            uint32_t x = static_cast<uint32_t>(handle) * 0x9E3779B1u;
+            x ^= x >> 15;
+            x *= 0x85EBCA77u;
+            x ^= x >> 13;
+            return x;
+        }
+
+        int count() const {
+            return root < 0 ? 0 : size[root];
+        }
+
+        bool contains(int handle) const {
+            return handle >= 0 && handle < static_cast<int>(size.size()) && size[handle] > 0;
+        }
+
+        void reserveHandles(int handles) {
+            if (static_cast<int>(size.size()) < handles) {
+                left.resize(handles, -1);
+                right.resize(handles, -1);
+                parent.resize(handles, -1);
+                size.resize(handles, 0);
+            }
+        }
+
+        void clear() {
+            std::fill(size.begin(), size.end(), 0);
+            root = -1;
+        }
+
+        // Replace the contents with handles, in that order, in O(n)
+        void assign(const std::vector<int>& handles) {
+            clear();
+            std::vector<int> spine; // Right spine of the tree built so far
+            for (int handle : handles) {
+                int last = -1;
+                while (!spine.empty() && priority(spine.back()) < priority(handle)) {
+                    last = spine.back();
+                    spine.pop_back();
+                }
+                left[handle] = last;
+                right[handle] = -1;
+                if (!spine.empty()) right[spine.back()] = handle;
+                spine.push_back(handle);
+            }
+            if (spine.empty()) {
+                return;
+            }
+            root = spine.front();
+            parent[root] = -1;
+            // Preorder puts parents before children, so pull in reverse
+            std::vector<int> preorder, pending{ root };
+            preorder.reserve(handles.size());
+            while (!pending.empty()) {
+                int x = pending.back();
+                pending.pop_back();
+                preorder.push_back(x);
+                if (left[x] >= 0) pending.push_back(left[x]);
+                if (right[x] >= 0) pending.push_back(right[x]);
+            }
+            for (auto it = preorder.rbegin(); it != preorder.rend(); ++it) {
+                pull(*it);
+            }
+        }
+
+        int at(int position) const {
+            int x = root;
+            for (;;) {
+                int leftSize = subtreeSize(left[x]);
+                if (position < leftSize) {
+                    x = left[x];
+                }
+                else if (position == leftSize) {
+                    return x;
+                }
+                else {
+                    position -= leftSize + 1;
+                    x = right[x];
+                }
+            }
+        }
+
+        int positionOf(int handle) const {
+            int position = subtreeSize(left[handle]);
+            for (int x = handle; parent[x] >= 0; x = parent[x]) {
+                int up = parent[x];
+                if (right[up] == x) position += subtreeSize(left[up]) + 1;
+            }
+            return position;
+        }
+
+        // Length of the prefix whose handles satisfy before(); before() must be true
+        // for a prefix of the sequence and false for the rest
+        template <typename Before>
+        int countBefore(Before before) const {
+            int x = root, position = 0;
+            while (x >= 0) {
+                if (before(x)) {
+                    position += subtreeSize(left[x]) + 1;
+                    x = right[x];
+                }
+                else {
+                    x = left[x];
+                }
+            }
+            return position;
+        }
+
+        void insert(int position, int handle) {
+            left[handle] = right[handle] = -1;
+            size[handle] = 1;
+            int a, b;
+            split(root, position, a, b);
+            setRoot(merge(merge(a, handle), b));
+        }
+
+        void erase(int handle) {
+            int a, b, single, c;
+            split(root, positionOf(handle), a, b);
+            split(b, 1, single, c);
+            setRoot(merge(a, c));
+            size[handle] = 0;
+        }
+
+        // Call visit(handle) for positions [begin, end) in order
+        template <typename Visit>
+        void forRange(int begin, int end, Visit visit) const {
+            visitRange(root, begin, end, visit);
+        }
+
+        std::vector<int> toVector() const {
+            std::vector<int> handles;
+            handles.reserve(count());
+            forRange(0, count(), [&handles](int handle) { handles.push_back(handle); });
+            return handles;
+        }
+
+        int subtreeSize(int x) const {
+            return x < 0 ? 0 : size[x];
+        }
+
+        void pull(int x) {
+            size[x] = 1;
+            if (left[x] >= 0) {
+                size[x] += size[left[x]];
+                parent[left[x]] = x;
+            }
+            if (right[x] >= 0) {
+                size[x] += size[right[x]];
+                parent[right[x]] = x;
+            }
+        }
+
+        void setRoot(int x) {
+            root = x;
+            if (root >= 0) parent[root] = -1;
+        }
+
+        // First count handles of tree t into a, the rest into b
+        void split(int t, int count, int& a, int& b) {
+            if (t < 0) {
+                a = b = -1;
+                return;
+            }
+            int leftSize = subtreeSize(left[t]);
+            if (count <= leftSize) {
+                split(left[t], count, a, left[t]);
+                b = t;
+            }
+            else {
+                split(right[t], count - leftSize - 1, right[t], b);
+                a = t;
+            }
+            pull(t);
+        }
+
+        int merge(int a, int b) {
+            if (a < 0) return b;
+            if (b < 0) return a;
+            if (priority(a) > priority(b)) {
+                right[a] = merge(right[a], b);
+                pull(a);
+                return a;
+            }
+            left[b] = merge(a, left[b]);
+            pull(b);
+            return b;
+        }
+
+        template <typename Visit>
+        void visitRange(int x, int begin, int end, Visit& visit) const {
+            if (x < 0 || begin >= end) {
+                return;
+            }
+            int leftSize = subtreeSize(left[x]);
+            if (begin < leftSize) visitRange(left[x], begin, std::min(end, leftSize), visit);
+            if (begin <= leftSize && leftSize < end) visit(x);
+            if (end > leftSize + 1) visitRange(right[x], std::max(begin - leftSize - 1, 0), end - leftSize - 1, visit);
+        }
+    };
+
+    struct ListIndexView : public ListDataSource, public ListDataObserver {
+        ListDataSource* base = nullptr;
+        SortOrder sortOrder = SortOrder::None;
+        std::function<bool(int, int)> compareRows; // Orders base rows; nullptr sorts by case-insensitive text
+        FilterMode filterMode = FilterMode::Prefix; // Substring is a linear scan
+        std::string query; // Folded
+        unsigned threadCount = defaultThreadCount();
+
+        RowSequence baseRows;
+        RowSequence order;
+        RowSequence visible;
+        RowSequence keyIndex;
+        bool keyIndexBuilt = false;
+        std::vector<int> freeHandles; // Handles of removed rows, reused before new ones
+        int handleLimit = 0;          // One past the largest handle handed out
+
+        // Edits larger than this are applied as a full rebuild and a reset
+        int bulkEditThreshold = 64;
+
+        explicit ListIndexView(ListDataSource* base) : base(base) {
+            base->addObserver(this);
+            rebuild(true);
+        }
+
+        ~ListIndexView() {
+            if (base) {
+                base->removeObserver(this);
+            }
+        }
+
+        const RowSequence& displayOrder() const {
+            return sortOrder == SortOrder::None ? baseRows : order;
+        }
+
+        const RowSequence& rows() const {
+            return query.empty() ? displayOrder() : visible;
+        }
+
+        int baseRow(int handle) const {
+            return baseRows.positionOf(handle);
+        }
+
+        virtual int rowCount() const override {
+            return rows().count();
+        }
+
+        virtual std::string_view rowText(int row) const override {
+            return base->rowText(baseRow(rows().at(row)));
+        }
+
+        // Keys are row handles: they follow a row through base edits, sorts and queries
+        virtual int rowKey(int row) const override {
+            return rows().at(row);
+        }
+
+        virtual int rowForKey(int key) const override {
+            const RowSequence& current = rows();
+            return current.contains(key) ? current.positionOf(key) : -1;
+        }
+
+        virtual bool rowMatch(int row, int& start, int& length) const override {
+            if (query.empty()) {
+                return false;
+            }
+            std::string_view text = rowText(row);
+            size_t at = filterMode == FilterMode::Prefix ? (startsWithFolded(text, query) ? 0 : std::string_view::npos) : findFolded(text, query);
+            if (at == std::string_view::npos) {
+                return false;
+            }
+            start = static_cast<int>(at);
+            length = static_cast<int>(query.size());
+            return true;
+        }
+
+        virtual bool setFilterQuery(std::string_view newQuery) override {
+            setQuery(newQuery);
+            return true;
+        }
+
+        ///////////////////////////////// ORDERING ////////////////////////////////////
+
+        // The comparisons take base rows, not handles
+
+        bool keyLess(int a, int b) const {
+            int c = compareFolded(base->rowText(a), base->rowText(b));
+            return c != 0 ? c < 0 : a < b;
+        }
+
+        // Strict display order; ties fall back to the base index so positions are unique
+        bool displayLess(int a, int b) const {
+            if (sortOrder == SortOrder::None) {
+                return a < b;
+            }
+            bool aFirst, bFirst;
+            if (compareRows) {
+                aFirst = compareRows(a, b);
+                bFirst = compareRows(b, a);
+            }
+            else {
+                int c = compareFolded(base->rowText(a), base->rowText(b));
+                aFirst = c < 0;
+                bFirst = c > 0;
+            }
+            if (sortOrder == SortOrder::Descending) {
+                std::swap(aFirst, bFirst);
+            }
+            return aFirst || (!bFirst && a < b);
+        }
+
+        bool matches(int row) const {
+            if (query.empty()) {
+                return true;
+            }
+            std::string_view text = base->rowText(row);
+            return filterMode == FilterMode::Prefix ? startsWithFolded(text, query) : findFolded(text, query) != std::string_view::npos;
+        }
+
+        // Where base row belongs in a sequence ordered by less
+        template <typename Less>
+        int insertionPoint(const RowSequence& rows, int row, Less less) const {
+            return rows.countBefore([&](int handle) { return less(baseRow(handle), row); });
+        }
+
+        int displayPosition(const RowSequence& rows, int row) const {
+            return insertionPoint(rows, row, [this](int a, int b) { return displayLess(a, b); });
+        }
+
+        // Base row of every handle, for whole-list passes that would otherwise pay O(log n) per lookup
+        std::vector<int> handleRows() const {
+            std::vector<int> rowOf(handleLimit, -1);
+            int row = 0;
+            baseRows.forRange(0, baseRows.count(), [&](int handle) { rowOf[handle] = row++; });
+            return rowOf;
+        }
+
+        void ensureKeyIndex() {
+            if (keyIndexBuilt) {
+                return;
+            }
+            std::vector<int> rowOf = handleRows();
+            std::vector<int> handles = baseRows.toVector();
+            parallelSort(handles, threadCount, [&](int a, int b) { return keyLess(rowOf[a], rowOf[b]); });
+            keyIndex.assign(handles);
+            keyIndexBuilt = true;
+        }
+
+        bool sortsByKey() const {
+            return sortOrder != SortOrder::None && !compareRows;
+        }
+
+        ///////////////////////////////// QUERIES /////////////////////////////////////
+
+        // Recompute visible from scratch for the current query
+        void scanAll() {
+            if (query.empty()) {
+                visible.clear();
+                return;
+            }
+            std::vector<int> matched;
+            if (filterMode == FilterMode::Prefix) {
+                ensureKeyIndex();
+                auto prefixOf = [this](int handle) { return base->rowText(baseRow(handle)).substr(0, query.size()); };
+                int lower = keyIndex.countBefore([&](int handle) { return compareFolded(prefixOf(handle), query) < 0; });
+                int upper = keyIndex.countBefore([&](int handle) { return compareFolded(prefixOf(handle), query) <= 0; });
+                matched.reserve(upper - lower);
+                keyIndex.forRange(lower, upper, [&matched](int handle) { matched.push_back(handle); });
+                if (!(sortsByKey() && sortOrder == SortOrder::Ascending)) {
+                    // keyIndex order is only the display order for an ascending text sort
+                    const RowSequence& display = displayOrder();
+                    std::vector<std::pair<int, int>> ranked;
+                    ranked.reserve(matched.size());
+                    for (int handle : matched) ranked.push_back({ display.positionOf(handle), handle });
+                    std::sort(ranked.begin(), ranked.end());
+                    for (size_t i = 0; i < ranked.size(); ++i) matched[i] = ranked[i].second;
+                }
+            }
+            else {
+                std::vector<int> rowOf = handleRows();
+                std::vector<int> all = displayOrder().toVector();
+                parallelFilter(all, matched, threadCount, [&](int handle) { return matches(rowOf[handle]); });
+            }
+            visible.assign(matched);
+        }
+
+        void setQuery(std::string_view newQuery) {
+            std::string folded = foldString(newQuery);
+            if (folded == query) {
+                return;
+            }
+            bool refine = !query.empty() && (filterMode == FilterMode::Prefix ? folded.compare(0, query.size(), query) == 0 : folded.find(query) != std::string::npos);
+            query = folded;
+            if (refine) {
+                // Everything matching the longer query matched the shorter one
+                std::vector<int> current = visible.toVector(), narrowed;
+                parallelFilter(current, narrowed, threadCount, [this](int handle) { return matches(baseRow(handle)); });
+                visible.assign(narrowed);
+            }
+            else {
+                scanAll();
+            }
+            notifyReset();
+        }
+
+        void setFilterMode(FilterMode mode) {
+            if (mode == filterMode) {
+                return;
+            }
+            filterMode = mode;
+            scanAll();
+            notifyReset();
+        }
+
+        void setSort(SortOrder newOrder, std::function<bool(int, int)> compare = nullptr) {
+            sortOrder = newOrder;
+            compareRows = compare;
+            rebuild();
+            notifyReset();
+        }
+
+        // renumber hands out fresh handles, for when the base rows are no longer the same rows
+        void rebuild(bool renumber = false) {
+            int count = base->rowCount();
+            if (renumber || baseRows.count() != count) {
+                freeHandles.clear();
+                handleLimit = count;
+                for (RowSequence* sequence : { &baseRows, &order, &visible, &keyIndex }) {
+                    sequence->reserveHandles(handleLimit);
+                }
+                std::vector<int> handles(count);
+                std::iota(handles.begin(), handles.end(), 0);
+                baseRows.assign(handles);
+            }
+            keyIndexBuilt = false;
+            keyIndex.clear();
+            if (sortsByKey() && sortOrder == SortOrder::Ascending) {
+                ensureKeyIndex();
+                order.assign(keyIndex.toVector());
+            }
+            else if (sortOrder != SortOrder::None) {
+                std::vector<int> rowOf = handleRows();
+                std::vector<int> handles = baseRows.toVector();
+                parallelSort(handles, threadCount, [&](int a, int b) { return displayLess(rowOf[a], rowOf[b]); });
+                order.assign(handles);
+            }
+            else {
+                order.clear();
+            }
+            scanAll();
+        }
+
+        ///////////////////////////////// BASE EDITS //////////////////////////////////
+
+        int newHandle() {
+            if (!freeHandles.empty()) {
+                int handle = freeHandles.back();
+                freeHandles.pop_back();
+                return handle;
+            }
+            int handle = handleLimit++;
+            for (RowSequence* sequence : { &baseRows, &order, &visible, &keyIndex }) {
+                sequence->reserveHandles(handleLimit);
+            }
+            return handle;
+        }
+
+        // Take handle out of rows and put it back where less says its base row belongs
+        template <typename Less>
+        void reposition(RowSequence& rows, int handle, int row, int& from, int& to, Less less) {
+            from = rows.positionOf(handle);
+            rows.erase(handle);
+            to = insertionPoint(rows, row, less);
+            rows.insert(to, handle);
+        }
+
+        void repositionDisplay(RowSequence& rows, int handle, int row, int& from, int& to) {
+            reposition(rows, handle, row, from, to, [this](int a, int b) { return displayLess(a, b); });
+        }
+
+        void repositionKey(int handle, int row) {
+            int from, to;
+            reposition(keyIndex, handle, row, from, to, [this](int a, int b) { return keyLess(a, b); });
+        }
+
+        // Re-sort handles whose text changed, and with notify tell the list where each one
+        // moves. They all come out first so the rest stays sorted for the binary searches;
+        // as far as the list knows, the ones not yet placed are still where they were.
+        template <typename Less>
+        void repositionAll(RowSequence& rows, const std::vector<int>& handles, Less less, bool notify) {
+            std::vector<std::pair<int, int>> pending; // (position, handle) in list order
+            pending.reserve(handles.size());
+            for (int handle : handles) pending.push_back({ rows.positionOf(handle), handle });
+            std::sort(pending.begin(), pending.end());
+            for (size_t i = 0; i < pending.size(); ++i) {
+                pending[i].first -= static_cast<int>(i); // Now the count of settled rows before it
+                rows.erase(pending[i].second);
+            }
+            std::vector<std::pair<int, int>> moves;
+            for (size_t i = 0; i < pending.size(); ++i) {
+                int handle = pending[i].second;
+                int from = pending[i].first;
+                int settled = insertionPoint(rows, baseRow(handle), less);
+                rows.insert(settled, handle);
+                int to = settled;
+                for (size_t j = i + 1; j < pending.size(); ++j) {
+                    if (pending[j].first < settled) ++to;
+                    else ++pending[j].first;
+                }
+                if (from != to) moves.push_back({ from, to });
+            }
+            if (!notify) {
+                return;
+            }
+            // Send the moves once rows is whole again, so the list can read it during them
+            for (const auto& move : moves) notifyMoved(move.first, move.second);
+            for (int handle : handles) notifyUpdated(rows.positionOf(handle), 1);
+        }
+
+        virtual void onRowsInserted(int first, int count) override {
+            if (count > bulkEditThreshold) {
+                onRowsReset();
+                return;
+            }
+            // Place every new row in baseRows first so base rows resolve while we notify
+            std::vector<int> added(count);
+            for (int i = 0; i < count; ++i) {
+                added[i] = newHandle();
+                baseRows.insert(first + i, added[i]);
+            }
+            bool unsortedAll = sortOrder == SortOrder::None && query.empty();
+            for (int i = 0; i < count; ++i) {
+                int handle = added[i], row = first + i;
+                if (keyIndexBuilt) {
+                    keyIndex.insert(insertionPoint(keyIndex, row, [this](int a, int b) { return keyLess(a, b); }), handle);
+                }
+                if (sortOrder != SortOrder::None) {
+                    int position = displayPosition(order, row);
+                    order.insert(position, handle);
+                    if (query.empty()) notifyInserted(position, 1);
+                }
+                if (!query.empty() && matches(row)) {
+                    int position = displayPosition(visible, row);
+                    visible.insert(position, handle);
+                    notifyInserted(position, 1);
+                }
+            }
+            if (unsortedAll) {
+                notifyInserted(first, count);
+            }
+        }
+
+        virtual void onRowsRemoved(int first, int count) override {
+            if (count > bulkEditThreshold) {
+                onRowsReset();
+                return;
+            }
+            // The removed rows' text is gone, but their handles still sit at [first, first + count)
+            std::vector<int> removed;
+            removed.reserve(count);
+            baseRows.forRange(first, first + count, [&removed](int handle) { removed.push_back(handle); });
+            for (int handle : removed) {
+                baseRows.erase(handle);
+            }
+            for (int handle : removed) {
+                if (keyIndexBuilt) {
+                    keyIndex.erase(handle);
+                }
+                if (sortOrder != SortOrder::None) {
+                    int position = order.positionOf(handle);
+                    order.erase(handle);
+                    if (query.empty()) notifyRemoved(position, 1);
+                }
+                if (visible.contains(handle)) {
+                    int position = visible.positionOf(handle);
+                    visible.erase(handle);
+                    notifyRemoved(position, 1);
+                }
+            }
+            freeHandles.insert(freeHandles.end(), removed.begin(), removed.end());
+            if (sortOrder == SortOrder::None && query.empty()) {
+                notifyRemoved(first, count);
+            }
+        }
+
+        virtual void onRowsUpdated(int first, int count) override {
+            if (count > bulkEditThreshold) {
+                onRowsReset();
+                return;
+            }
+            std::vector<int> changed;
+            changed.reserve(count);
+            baseRows.forRange(first, first + count, [&changed](int handle) { changed.push_back(handle); });
+            if (keyIndexBuilt) {
+                repositionAll(keyIndex, changed, [this](int a, int b) { return keyLess(a, b); }, false);
+            }
+            if (sortOrder != SortOrder::None) {
+                repositionAll(order, changed, [this](int a, int b) { return displayLess(a, b); }, query.empty());
+            }
+            else if (query.empty()) {
+                notifyUpdated(first, count);
+            }
+            if (query.empty()) {
+                return;
+            }
+
+            // Rows that stop matching leave, the rest are re-sorted, then new matches join
+            std::vector<int> staying;
+            for (int handle : changed) {
+                if (!visible.contains(handle)) {
+                    continue;
+                }
+                if (matches(baseRow(handle))) {
+                    staying.push_back(handle);
+                    continue;
+                }
+                int position = visible.positionOf(handle);
+                visible.erase(handle);
+                notifyRemoved(position, 1);
+            }
+            repositionAll(visible, staying, [this](int a, int b) { return displayLess(a, b); }, true);
+            for (int handle : changed) {
+                int row = baseRow(handle);
+                if (!visible.contains(handle) && matches(row)) {
+                    int position = displayPosition(visible, row);
+                    visible.insert(position, handle);
+                    notifyInserted(position, 1);
+                }
+            }
+        }
+
+        virtual void onRowMoved(int from, int to) override {
+            // Moving the handle in baseRows renumbers every row in between for free
+            int handle = baseRows.at(from);
+            baseRows.erase(handle);
+            baseRows.insert(to, handle);
+
+            // Only the moved row can now be out of place (by text, or by index when unsorted)
+            int orderFrom = from, orderTo = to;
+            if (sortOrder != SortOrder::None) {
+                repositionDisplay(order, handle, to, orderFrom, orderTo);
+            }
+            if (keyIndexBuilt) {
+                repositionKey(handle, to);
+            }
+            if (query.empty()) {
+                if (orderFrom != orderTo) notifyMoved(orderFrom, orderTo);
+                return;
+            }
+            if (visible.contains(handle)) {
+                int visibleFrom, visibleTo;
+                repositionDisplay(visible, handle, to, visibleFrom, visibleTo);
+                if (visibleFrom != visibleTo) notifyMoved(visibleFrom, visibleTo);
+            }
+        }
+
+        virtual void onRowsReset() override {
+            rebuild(true);
+            notifyReset();
+        }
+    };
+}
@@ -0,0 +1,234 @@
+#pragma once
+
+//////////////////////////////////////////////////////////
+////////////SV UI RESOURCE ACCOUNTING/////////////////////
+//////////////////////////////////////////////////////////
+// Bookkeeping for everything the UI allocates that outlives a frame: GL
+// textures and buffers, and large CPU buffers (streaming frames, mapped
+// layouts, draw lists). Each entry is attributed to an owner ("Widget",
+// "ButtonComponent", "TextureCache", ...), optionally to a widget ID and the
+// file it came from. Live objects (widgets, components) are counted per type.
+//
+//     SV_UI::ResourceUsage all = SV_UI::resourceUsage();
+//     SV_UI::ResourceUsage panel = SV_UI::widgetResourceUsage(1);
+//     SV_UI::printResourceUsage(std::cout);
+//
+// shutdownUI() frees the UI and calls reportLeaks(), which lists whatever is
+// still tracked, so a texture nobody released shows up with its widget ID and
+// source path. Byte counts are what was requested from GL; drivers may pad.
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace SV_UI {
+
+    enum class ResourceKind : uint8_t {
+        Texture, // GPU texture memory
+        Buffer,  // GPU buffer objects (vertex, index, pixel)
+        Host     // CPU memory
+    };
+
+    struct ResourceEntry {
+        ResourceKind kind = ResourceKind::Host;
+        uint64_t handle = 0;   // GL name, or the address of the CPU buffer
+        size_t bytes = 0;
+        const char* owner = ""; // Static string naming the component type or cache
+        int widgetID = -1;      // -1 when not owned by a widget
+        std::string source;     // File the data came from, if any
+    };
+
+    struct ResourceUsage {
+        size_t textureBytes = 0, bufferBytes = 0, hostBytes = 0;
+        size_t resources = 0; // Tracked entries that matched
+
+        size_t gpuBytes() const { return textureBytes + bufferBytes; }
+        size_t totalBytes() const { return textureBytes + bufferBytes + hostBytes; }
+
+        void add(const ResourceEntry& entry) {
+            switch (entry.kind) {
+            case ResourceKind::Texture: textureBytes += entry.bytes; break;
+            case ResourceKind::Buffer: bufferBytes += entry.bytes; break;
+            case ResourceKind::Host: hostBytes += entry.bytes; break;
+            }
+            ++resources;
+        }
+    };
+
+    struct ResourceTracker {
+        std::mutex mutex; // Streaming producers and loader threads may track too
+        std::unordered_map<uint64_t, ResourceEntry> entries;
+        std::map<std::string, int64_t> liveObjects; // Ordered so reports are stable
+    };
+
+    ResourceTracker& currentResourceTracker(); // Per UI context, defined in sv_ui3.0.h
+
+    uint64_t resourceKey(ResourceKind kind, uint64_t handle) {
+        return (static_cast<uint64_t>(kind) << 56) ^ handle; // GL names and user-space addresses fit below
+    }
+
+    uint64_t resourceHandle(const void* pointer) {
+        return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pointer));
+    }
+
+    // Record or resize a resource. Tracking a handle again replaces its size and owner.
+    void trackResource(ResourceKind kind, uint64_t handle, size_t bytes, const char* owner, const std::string& source = "", int widgetID = -1) {
+        if (!handle) {
+            return;
+        }
+        ResourceTracker& tracker = currentResourceTracker();
+        std::lock_guard<std::mutex> lock(tracker.mutex);
+        ResourceEntry& entry = tracker.entries[resourceKey(kind, handle)];
+        entry.kind = kind;
+        entry.handle = handle;
+        entry.bytes = bytes;
+        entry.owner = owner;
+        if (!source.empty()) {
+            entry.source = source;
+        }
+        if (widgetID >= 0) {
+            entry.widgetID = widgetID;
+        }
+    }
+
+    void untrackResource(ResourceKind kind, uint64_t handle) {
+        if (!handle) {
+            return;
+        }
+        ResourceTracker& tracker = currentResourceTracker();
+        std::lock_guard<std::mutex> lock(tracker.mutex);
+        tracker.entries.erase(resourceKey(kind, handle));
+    }
+
+    // Hand a tracked resource to a new owner, e.g. a cached texture adopted by a widget
+    void assignResource(ResourceKind kind, uint64_t handle, const char* owner, int widgetID) {
+        ResourceTracker& tracker = currentResourceTracker();
+        std::lock_guard<std::mutex> lock(tracker.mutex);
+        auto it = tracker.entries.find(resourceKey(kind, handle));
+        if (it != tracker.entries.end()) {
+            it->second.owner = owner;
+            it->second.widgetID = widgetID;
+        }
+    }
+
+    // Called from constructors (+1) and destructors (-1) of widgets and components
+    void countObject(const char* type, int delta) {
+        ResourceTracker& tracker = currentResourceTracker();
+        std::lock_guard<std::mutex> lock(tracker.mutex);
+        tracker.liveObjects[type] += delta;
+    }
+
+    int64_t liveObjects(const std::string& type) {
+        ResourceTracker& tracker = currentResourceTracker();
+        std::lock_guard<std::mutex> lock(tracker.mutex);
+        auto it = tracker.liveObjects.find(type);
+        return it == tracker.liveObjects.end() ? 0 : it->second;
+    }
+
+    ResourceUsage resourceUsage() {
+        ResourceTracker& tracker = currentResourceTracker();
+        std::lock_guard<std::mutex> lock(tracker.mutex);
+        ResourceUsage usage;
+        for (const auto& item : tracker.entries) {
+            usage.add(item.second);
+        }
+        return usage;
+    }
+
+    // Everything tracked under one owner name ("Widget", "StreamingImage", "DrawList", ...)
+    ResourceUsage resourceUsage(const std::string& owner) {
+        ResourceTracker& tracker = currentResourceTracker();
+        std::lock_guard<std::mutex> lock(tracker.mutex);
+        ResourceUsage usage;
+        for (const auto& item : tracker.entries) {
+            if (owner == item.second.owner) {
+                usage.add(item.second);
+            }
+        }
+        return usage;
+    }
+
+    ResourceUsage widgetResourceUsage(int widgetID) {
+        ResourceTracker& tracker = currentResourceTracker();
+        std::lock_guard<std::mutex> lock(tracker.mutex);
+        ResourceUsage usage;
+        for (const auto& item : tracker.entries) {
+            if (item.second.widgetID == widgetID) {
+                usage.add(item.second);
+            }
+        }
+        return usage;
+    }
+
+    // Copy of every tracked entry, for tools that want their own breakdown
+    std::vector<ResourceEntry> trackedResources() {
+        ResourceTracker& tracker = currentResourceTracker();
+        std::lock_guard<std::mutex> lock(tracker.mutex);
+        std::vector<ResourceEntry> result;
+        result.reserve(tracker.entries.size());
+        for (const auto& item : tracker.entries) {
+            result.push_back(item.second);
+        }
+        return result;
+    }
+
+    const char* resourceKindName(ResourceKind kind) {
+        switch (kind) {
+        case ResourceKind::Texture: return "texture";
+        case ResourceKind::Buffer: return "buffer";
+        default: return "host";
+        }
+    }
+
+    // One line per owner with its GPU and CPU bytes, then the live object counts
+    void printResourceUsage(std::ostream& out) {
+        std::map<std::string, ResourceUsage> byOwner;
+        for (const ResourceEntry& entry : trackedResources()) {
+            byOwner[entry.owner].add(entry);
+        }
+        ResourceUsage total = resourceUsage();
+        out << "SV_UI resources: " << total.gpuBytes() << " GPU bytes (" << total.textureBytes << " texture, "
+            << total.bufferBytes << " buffer), " << total.hostBytes << " CPU bytes" << std::endl;
+        for (const auto& item : byOwner) {
+            out << "  " << item.first << ": " << item.second.resources << " resources, " << item.second.gpuBytes()
+                << " GPU bytes, " << item.second.hostBytes << " CPU bytes" << std::endl;
+        }
+        ResourceTracker& tracker = currentResourceTracker();
+        std::lock_guard<std::mutex> lock(tracker.mutex);
+        for (const auto& item : tracker.liveObjects) {
+            if (item.second != 0) {
+                out << "  live " << item.first << ": " << item.second << std::endl;
+            }
+        }
+    }
+
+    // Print everything still tracked or alive. Returns true if nothing leaked.
+    bool reportLeaks(std::ostream& out = std::cerr) {
+        std::vector<ResourceEntry> leaked = trackedResources();
+        ResourceTracker& tracker = currentResourceTracker();
+        std::lock_guard<std::mutex> lock(tracker.mutex);
+        bool clean = leaked.empty();
+        for (const ResourceEntry& entry : leaked) {
+            out << "SV_UI leak: " << resourceKindName(entry.kind) << " " << entry.handle << ", " << entry.bytes
+                << " bytes, owner " << entry.owner;
+            if (entry.widgetID >= 0) {
+                out << ", widget " << entry.widgetID;
+            }
+            if (!entry.source.empty()) {
+                out << ", source " << entry.source;
+            }
+            out << std::endl;
+        }
+        for (const auto& item : tracker.liveObjects) {
+            if (item.second != 0) {
+                out << "SV_UI leak: " << item.second << " live " << item.first << std::endl;
+                clean = false;
+            }
+        }
+        return clean;
+    }
+}
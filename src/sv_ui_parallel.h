@@ -0,0 +1,320 @@
+#pragma once
+
+//////////////////////////////////////////////////////////
+////////////SV UI PARALLEL HELPERS////////////////////////
+//////////////////////////////////////////////////////////
+// Small fork-join helpers for the data-heavy parts of SV_UI (list indexes,
+// sorting). Work is split into contiguous chunks so results can be
+// concatenated in order; small inputs run on the calling thread.
+
+#include <thread>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <functional>
+
+namespace SV_UI {
+
+    // Below this many elements per chunk, spawning a thread costs more than it saves
+    const size_t PARALLEL_MIN_CHUNK = 16384;
+
+    unsigned defaultThreadCount() {
+        unsigned count = std::thread::hardware_concurrency();
+        return count ? count : 1;
+    }
+
+    // Number of chunks to split count elements into for the given thread budget
+    unsigned chunkCountFor(size_t count, unsigned threads) {
+        size_t chunks = count / PARALLEL_MIN_CHUNK;
+        if (chunks > threads) chunks = threads;
+        return chunks > 1 ? static_cast<unsigned>(chunks) : 1;
+    }
+
+    // Calls fn(begin, end, chunk) for contiguous chunks of [0, count), one thread per chunk
+    void parallelFor(size_t count, unsigned threads, const std::function<void(size_t, size_t, unsigned)>& fn) {
+        unsigned chunks = chunkCountFor(count, threads);
+        if (chunks == 1) {
+            fn(0, count, 0);
+            return;
+        }
+        std::vector<std::thread> workers;
+        workers.reserve(chunks - 1);
+        size_t chunkSize = (count + chunks - 1) / chunks;
+        for (unsigned c = 1; c < chunks; ++c) {
+            size_t begin = c * chunkSize;
+            size_t end = std::min(count, begin + chunkSize);
+            workers.emplace_back([&fn, begin, end, c]() { fn(begin, end, c); });
+        }
+        fn(0, std::min(count, chunkSize), 0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    // Keep the elements of input for which keep(element) is true, preserving order
+    template <typename T, typename Predicate>
+    void parallelFilter(const std::vector<T>& input, std::vector<T>& output, unsigned threads, Predicate keep) {
+        unsigned chunks = chunkCountFor(input.size(), threads);
+        std::vector<std::vector<T>> partial(chunks);
+        parallelFor(input.size(), threads, [&](size_t begin, size_t end, unsigned chunk) {
+            std::vector<T>& out = partial[chunk];
+            for (size_t i = begin; i < end; ++i) {
+                if (keep(input[i])) {
+                    out.push_back(input[i]);
+                }
+            }
+        });
+        output.clear();
+        for (auto& part : partial) {
+            output.insert(output.end(), part.begin(), part.end());
+        }
+    }
+
+    // Sort chunks in parallel, then merge neighbouring runs pairwise in parallel rounds
+    template <typename T, typename Less>
+    void parallelSort(std::vector<T>& data, unsigned threads, Less less) {
+        unsigned chunks = chunkCountFor(data.size(), threads);
+        if (chunks == 1) {
+            std::sort(data.begin(), data.end(), less);
+            return;
+        }
+        size_t chunkSize = (data.size() + chunks - 1) / chunks;
+        std::vector<size_t> bounds;
+        for (size_t b = 0; b < data.size(); b += chunkSize) {
+            bounds.push_back(b);
+        }
+        bounds.push_back(data.size());
+
+        std::vector<std::thread> sorters;
+        for (size_t run = 1; run + 1 < bounds.size(); ++run) {
+            size_t lo = bounds[run], hi = bounds[run + 1];
+            sorters.emplace_back([&data, &less, lo, hi]() {
+                std::sort(data.begin() + lo, data.begin() + hi, less);
+            });
+        }
+        std::sort(data.begin(), data.begin() + bounds[1], less);
+        for (auto& sorter : sorters) {
+            sorter.join();
+        }
+
+        while (bounds.size() > 2) {
+            size_t pairs = (bounds.size() - 1) / 2;
+            std::vector<std::thread> workers;
+            for (size_t p = 0; p < pairs; ++p) {
+                size_t lo = bounds[2 * p], mid = bounds[2 * p + 1], hi = bounds[2 * p + 2];
+                workers.emplace_back([&data, &less, lo, mid, hi]() {
+                    std::inplace_merge(data.begin() + lo, data.begin() + mid, data.begin() + hi, less);
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            std::vector<size_t> merged;
+            for (size_t i = 0; i < bounds.size(); i += 2) {
+                merged.push_back(bounds[i]);
+            }
+            if (merged.back() != data.size()) {
+                merged.push_back(data.size());
+            }
+            bounds.swap(merged);
+        }
+    }
+
+    // Persistent pool for many small, uneven tasks (e.g. one per widget). Each participant
+    // owns a deque and pops from its back; when it runs dry it steals from the front of the
+    // others, so one expensive task does not leave the rest of the threads idle.
+    // run() may only be called from one thread at a time; the caller takes part in the work.
+    struct WorkStealingPool {
+        struct Queue {
+            std::mutex mutex;
+            std::deque<size_t> items;
+        };
+
+        std::vector<std::thread> threads;
+        std::vector<std::unique_ptr<Queue>> queues; // Slot 0 belongs to the thread calling run()
+        const std::function<void(size_t)>* job = nullptr;
+        std::atomic<size_t> remaining{ 0 };
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+        unsigned long long generation = 0;
+        bool stopping = false;
+
+        // threadCount includes the caller; 0 means one per hardware thread
+        explicit WorkStealingPool(unsigned threadCount) {
+            if (threadCount == 0) {
+                threadCount = defaultThreadCount();
+            }
+            for (unsigned q = 0; q < threadCount; ++q) {
+                queues.emplace_back(new Queue());
+            }
+            for (unsigned t = 1; t < threadCount; ++t) {
+                threads.emplace_back([this, t]() { workerLoop(t); });
+            }
+        }
+
+        ~WorkStealingPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        }
+
+        unsigned threadCount() const {
+            return static_cast<unsigned>(queues.size());
+        }
+
+        // Calls fn(i) for every i in [0, count) and returns when all calls finished
+        void run(size_t count, const std::function<void(size_t)>& fn) {
+            if (count == 0) {
+                return;
+            }
+            if (queues.size() == 1 || count == 1) {
+                for (size_t i = 0; i < count; ++i) {
+                    fn(i);
+                }
+                return;
+            }
+            job = &fn; // Published to the workers by the queue mutexes below
+            remaining.store(count);
+            size_t participants = queues.size();
+            for (size_t q = 0; q < participants; ++q) {
+                std::lock_guard<std::mutex> lock(queues[q]->mutex);
+                for (size_t i = q; i < count; i += participants) {
+                    queues[q]->items.push_back(i);
+                }
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++generation;
+            }
+            wake.notify_all();
+            participate(0);
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [this]() { return remaining.load() == 0; });
+        }
+
+        bool popOrSteal(size_t self, size_t& item) {
+            {
+                Queue& own = *queues[self];
+                std::lock_guard<std::mutex> lock(own.mutex);
+                if (!own.items.empty()) {
+                    item = own.items.back();
+                    own.items.pop_back();
+                    return true;
+                }
+            }
+            for (size_t offset = 1; offset < queues.size(); ++offset) {
+                Queue& victim = *queues[(self + offset) % queues.size()];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (!victim.items.empty()) {
+                    item = victim.items.front();
+                    victim.items.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void participate(size_t self) {
+            size_t item;
+            while (popOrSteal(self, item)) {
+                (*job)(item);
+                if (remaining.fetch_sub(1) == 1) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    done.notify_all();
+                }
+            }
+        }
+
+        void workerLoop(size_t self) {
+            unsigned long long seen = 0;
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    wake.wait(lock, [this, seen]() { return stopping || generation != seen; });
+                    if (stopping) {
+                        return;
+                    }
+                    seen = generation;
+                }
+                participate(self);
+            }
+        }
+    };
+
+    // Unbounded multi-producer single-consumer queue (Vyukov's intrusive MPSC list).
+    // push() is wait-free apart from the node allocation: one atomic exchange and one
+    // store, so producers never wait for each other or for the consumer. pop() must only
+    // be called from one thread. A push that is half done (exchanged but not yet linked)
+    // makes pop() return false early; the item is seen by the next pop().
+    template <typename T>
+    struct MpscQueue {
+        struct Node {
+            std::atomic<Node*> next{ nullptr };
+            T value;
+        };
+
+        std::atomic<Node*> head; // Last node pushed, swapped by producers
+        Node* tail;              // Next node to pop, consumer only
+        Node stub;               // Keeps the list non-empty so push never touches tail
+
+        MpscQueue() : head(&stub), tail(&stub) {}
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        ~MpscQueue() {
+            T discarded;
+            while (pop(discarded)) {
+            }
+        }
+
+        void push(T value) {
+            Node* node = new Node();
+            node->value = std::move(value);
+            link(node);
+        }
+
+        bool pop(T& out) {
+            Node* first = tail;
+            Node* next = first->next.load(std::memory_order_acquire);
+            if (first == &stub) {
+                if (!next) {
+                    return false; // Empty
+                }
+                tail = next;
+                first = next;
+                next = next->next.load(std::memory_order_acquire);
+            }
+            if (!next) {
+                if (first != head.load(std::memory_order_acquire)) {
+                    return false; // A producer is between its exchange and its link
+                }
+                link(&stub); // first is the last node; re-insert the stub behind it so it can be taken
+                next = first->next.load(std::memory_order_acquire);
+                if (!next) {
+                    return false;
+                }
+            }
+            tail = next;
+            out = std::move(first->value);
+            delete first;
+            return true;
+        }
+
+        void link(Node* node) {
+            node->next.store(nullptr, std::memory_order_relaxed);
+            Node* previous = head.exchange(node, std::memory_order_acq_rel);
+            previous->next.store(node, std::memory_order_release);
+        }
+    };
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+//////////////////////////////////////////////////////////
+////////////SV UI PIPELINED RENDERING/////////////////////
+//////////////////////////////////////////////////////////
+// Prepares and records the retained UI on a worker thread while the GL thread
+// renders the application and swaps. Replaces renderUI():
+//
+//     SV_UI::PipelinedRenderer pipeline;
+//     pipeline.start();
+//     while (running) {
+//         while (SDL_PollEvent(&event)) pipeline.queueEvent(event);
+//         ... render the application's scene ...
+//         pipeline.renderFrame(); // Submits frame N-1, then starts recording frame N
+//         SDL_GL_SwapWindow(window);
+//     }
+//     pipeline.stop();
+//
+// renderFrame() runs on the GL thread in this order:
+//   1. wait until the worker finished the previous frame
+//   2. syncComponentsGL(): glyph strings, glText objects and texture uploads that frame's
+//      update() queued with requestGLSync()
+//   3. submit that frame's list (a thin loop over commands)
+//   4. sync window: run post()ed tasks, dispatch queued events
+//   5. wake the worker and return. The worker runs prepareFrame() (queued commands,
+//      bindings, animations, layout, component update()) and records into the other list.
+//
+// Thread rules while the pipeline is started:
+//   - UI state (widgets, components, data sources, builder calls) may only be changed
+//     during the sync window, from a post()ed task or an event callback such as onClick.
+//     Anywhere else the worker may be changing or reading it.
+//   - prepareFrame() runs on the worker, so update(), binding apply functions and
+//     animation callbacks must not call GL. GL work goes in a component's syncGL().
+//   - Widgets are created and destroyed (which creates and deletes GL objects) from post()ed
+//     tasks or event callbacks, never from update() or bindings.
+//   - post() and queueEvent() may be called from any thread.
+//   - Do not call SV_UI::handleEvents() or renderUI() directly; use queueEvent()/renderFrame().
+//   - The pipeline drives the UI context that was current on the thread calling start();
+//     call renderFrame() with that context current.
+//   - record() implementations only read. Components that only implement Draw() are drawn
+//     at submit time from their state as of the frame's update().
+// The UI shown is one frame behind the input, as with any double-buffered pipeline. A text
+// ring that grows in update() gets its objects in the next syncComponentsGL(), so those rows
+// appear one frame later still.
+
+#include "sv_ui3.0.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace SV_UI {
+
+    struct PipelinedRenderer {
+        DrawList lists[2];
+        int recordIndex = 0; // List the worker writes; the other one is submitted
+
+        std::thread worker;
+        std::mutex mutex;
+        std::condition_variable wake;  // Signals the worker
+        std::condition_variable done;  // Signals the GL thread
+        bool recordRequested = false;
+        bool recording = false;
+        bool stopping = false;
+
+        std::mutex inboxMutex; // Guards tasks and events, which any thread may add to
+        std::vector<std::function<void()>> tasks;
+        std::vector<SDL_Event> events;
+        std::vector<std::function<void()>> runningTasks; // Swapped with the inbox to run outside the lock
+        std::vector<SDL_Event> runningEvents;
+
+        ~PipelinedRenderer() {
+            stop();
+            untrackResource(ResourceKind::Host, resourceHandle(lists));
+        }
+
+        void start() {
+            if (worker.joinable()) {
+                return;
+            }
+            stopping = false;
+            UIContext* context = &ui(); // The worker records the context that started it
+            worker = std::thread([this, context]() {
+                ContextScope scope(context);
+                workerLoop();
+            });
+        }
+
+        // Finish the frame being recorded and join the worker; the UI may be used serially again
+        void stop() {
+            if (!worker.joinable()) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_one();
+            worker.join();
+        }
+
+        // Run task on the GL thread during the next sync window
+        void post(std::function<void()> task) {
+            std::lock_guard<std::mutex> lock(inboxMutex);
+            tasks.push_back(std::move(task));
+        }
+
+        // Dispatch event to the widgets during the next sync window
+        void queueEvent(const SDL_Event& event) {
+            std::lock_guard<std::mutex> lock(inboxMutex);
+            events.push_back(event);
+        }
+
+        void renderFrame() {
+            if (!worker.joinable()) {
+                std::cerr << "PipelinedRenderer::renderFrame called before start" << std::endl;
+                return;
+            }
+            waitForWorker();
+            syncComponentsGL();
+            submitDrawList(lists[recordIndex]);
+            trackResource(ResourceKind::Host, resourceHandle(lists), lists[0].capacityBytes() + lists[1].capacityBytes(), "DrawList");
+            recordIndex ^= 1;
+
+            syncWindow();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                recordRequested = true;
+                recording = true;
+            }
+            wake.notify_one();
+        }
+
+        void waitForWorker() {
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [this]() { return !recording; });
+        }
+
+        // The only point where the GL thread changes UI state while the pipeline runs
+        void syncWindow() {
+            {
+                std::lock_guard<std::mutex> lock(inboxMutex);
+                runningTasks.swap(tasks);
+                runningEvents.swap(events);
+            }
+            for (auto& task : runningTasks) {
+                task();
+            }
+            runningTasks.clear();
+            for (auto& event : runningEvents) {
+                handleEvents(&event);
+            }
+            runningEvents.clear();
+        }
+
+        void workerLoop() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                wake.wait(lock, [this]() { return recordRequested || stopping; });
+                if (recordRequested) {
+                    recordRequested = false;
+                    DrawList& list = lists[recordIndex];
+                    lock.unlock();
+                    prepareFrame(); // Commands, bindings, animations, layout and component updates
+                    list.clear();
+                    recordUI(list);
+                    lock.lock();
+                    recording = false;
+                    done.notify_one();
+                }
+                else if (stopping) {
+                    return;
+                }
+            }
+        }
+    };
+}
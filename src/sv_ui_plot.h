@@ -0,0 +1,451 @@
+#pragma once
+
+//////////////////////////////////////////////////////////
+////////////SV UI PLOT////////////////////////////////////
+//////////////////////////////////////////////////////////
+// Live line charts for long telemetry series:
+//
+//     auto* plot = SV_UI::Plot(600, 200);
+//     SV_UI::PlotSeries* cpu = plot->addSeries("cpu", 10000000, SV_UI::packColor(0.3f, 0.8f, 0.4f));
+//     // Any thread:
+//     cpu->append(load);           // Or append(values, count) for a batch
+//
+// A series keeps its newest capacity samples in a ring; x is the sample number.
+// Next to the ring it keeps a min/max pyramid: level L holds the extremes of
+// blocks of 8^(L+1) samples and is extended as blocks complete, so appending
+// stays O(1) amortized. Drawing asks the pyramid for the extremes of each
+// pixel column, which takes a few dozen reads whatever the column spans, and
+// draws one rect per column from its min to its max. A 10M sample series thus
+// costs about what a 2,000 sample one does. Zoomed in past one sample per
+// pixel, the samples are joined by line segments instead.
+//
+// The wheel zooms around the mouse, dragging pans. While the view ends at the
+// newest sample (follow), it scrolls along with appends.
+
+#include "sv_ui3.0.h"
+#include <mutex>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SV_UI_PLOT_SSE 1
+#endif
+
+namespace SV_UI {
+
+    const size_t PLOT_FANOUT = 8; // Children per pyramid block; the SIMD reduction below assumes 8
+
+    // Min of lo[0..8) and max of hi[0..8)
+    inline void plotMinMax8(const float* lo, const float* hi, float& outLo, float& outHi) {
+#ifdef SV_UI_PLOT_SSE
+        __m128 low = _mm_min_ps(_mm_loadu_ps(lo), _mm_loadu_ps(lo + 4));
+        __m128 high = _mm_max_ps(_mm_loadu_ps(hi), _mm_loadu_ps(hi + 4));
+        low = _mm_min_ps(low, _mm_shuffle_ps(low, low, _MM_SHUFFLE(1, 0, 3, 2)));
+        high = _mm_max_ps(high, _mm_shuffle_ps(high, high, _MM_SHUFFLE(1, 0, 3, 2)));
+        low = _mm_min_ps(low, _mm_shuffle_ps(low, low, _MM_SHUFFLE(2, 3, 0, 1)));
+        high = _mm_max_ps(high, _mm_shuffle_ps(high, high, _MM_SHUFFLE(2, 3, 0, 1)));
+        _mm_store_ss(&outLo, low);
+        _mm_store_ss(&outHi, high);
+#else
+        outLo = lo[0];
+        outHi = hi[0];
+        for (size_t i = 1; i < PLOT_FANOUT; ++i) {
+            outLo = std::min(outLo, lo[i]);
+            outHi = std::max(outHi, hi[i]);
+        }
+#endif
+    }
+
+    inline size_t plotRoundUp(size_t value) {
+        return (value + PLOT_FANOUT - 1) / PLOT_FANOUT * PLOT_FANOUT;
+    }
+
+    struct PlotSeries {
+        std::string name;
+        uint32_t color = 0xffffffff;
+        float thickness = 1.5f;
+
+        // Sample i is at samples[i % samples.size()] while i >= first(). Every ring, this and the
+        // levels', has a multiple of 8 slots, so the 8 children of a block never wrap.
+        std::vector<float> samples;
+        uint64_t total = 0; // Samples ever appended
+
+        // Block j of level L covers samples [j * 8^(L+1), (j + 1) * 8^(L+1)) and is at slot j % lo.size().
+        // Only complete blocks are written; queries never read one that is not inside the ring.
+        struct Level {
+            std::vector<float> lo, hi;
+        };
+        std::vector<Level> levels;
+
+        mutable std::mutex mutex; // Held while appending, and by the UI thread while it reads
+        UIContext* owner; // Woken on append, so producers need no context current
+
+        PlotSeries(const std::string& name, size_t capacity, uint32_t color, UIContext* owner)
+            : name(name), color(color), owner(owner) {
+            samples.resize(plotRoundUp(std::max(capacity, PLOT_FANOUT)));
+            for (size_t block = PLOT_FANOUT; block < samples.size(); block *= PLOT_FANOUT) {
+                Level level;
+                level.lo.resize(plotRoundUp(samples.size() / block + 2)); // Every block inside the ring, plus the two it straddles
+                level.hi.resize(level.lo.size());
+                levels.push_back(std::move(level));
+            }
+        }
+
+        size_t capacity() const {
+            return samples.size();
+        }
+
+        size_t bytes() const {
+            size_t sum = samples.size() * sizeof(float);
+            for (const Level& level : levels) {
+                sum += 2 * level.lo.size() * sizeof(float);
+            }
+            return sum;
+        }
+
+        // Oldest sample still in the ring
+        uint64_t first() const {
+            return total - std::min<uint64_t>(total, samples.size());
+        }
+
+        void append(float value) {
+            append(&value, 1);
+        }
+
+        void append(const float* values, size_t count) {
+            if (count == 0) {
+                return; // values may be null
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                uint64_t previous = total;
+                if (count > samples.size()) { // Only the newest capacity samples would survive
+                    values += count - samples.size();
+                    total += count - samples.size();
+                    count = samples.size();
+                }
+                size_t slot = static_cast<size_t>(total % samples.size());
+                size_t head = std::min(count, samples.size() - slot);
+                std::memcpy(samples.data() + slot, values, head * sizeof(float));
+                std::memcpy(samples.data(), values + head, (count - head) * sizeof(float));
+                total += count;
+                extendLevels(previous, total);
+            }
+            requestRedrawAsync(*owner);
+        }
+
+        void clear() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                total = 0;
+            }
+            requestRedrawAsync(*owner);
+        }
+
+        // Reduce the blocks that became complete between two totals, level by level
+        void extendLevels(uint64_t from, uint64_t to) {
+            const float* childLo = samples.data();
+            const float* childHi = samples.data();
+            size_t childSlots = samples.size();
+            for (Level& level : levels) {
+                from /= PLOT_FANOUT;
+                to /= PLOT_FANOUT;
+                if (from == to) {
+                    break; // Nothing completed here, so nothing above either
+                }
+                size_t slots = level.lo.size();
+                from = std::max(from, to - std::min<uint64_t>(to, slots)); // Older blocks would be overwritten anyway
+                for (uint64_t block = from; block < to; ++block) {
+                    size_t child = static_cast<size_t>(block * PLOT_FANOUT % childSlots);
+                    size_t slot = static_cast<size_t>(block % slots);
+                    plotMinMax8(childLo + child, childHi + child, level.lo[slot], level.hi[slot]);
+                }
+                childLo = level.lo.data();
+                childHi = level.hi.data();
+                childSlots = slots;
+            }
+        }
+
+        // Extremes of samples [begin, end), which must lie in the ring; false if the range is empty.
+        // Unaligned ends are read at each level and the aligned middle one level up. Call with mutex held.
+        bool extremes(uint64_t begin, uint64_t end, float& lo, float& hi) const {
+            lo = std::numeric_limits<float>::infinity();
+            hi = -std::numeric_limits<float>::infinity();
+            if (begin >= end) {
+                return false;
+            }
+            const float* los = samples.data();
+            const float* his = samples.data();
+            size_t slots = samples.size();
+            auto take = [&](uint64_t index) {
+                size_t slot = static_cast<size_t>(index % slots);
+                lo = std::min(lo, los[slot]);
+                hi = std::max(hi, his[slot]);
+            };
+            for (size_t level = 0; ; ++level) {
+                if (level == levels.size() || end - begin < 2 * PLOT_FANOUT) {
+                    for (uint64_t index = begin; index < end; ++index) {
+                        take(index);
+                    }
+                    return true;
+                }
+                for (; begin % PLOT_FANOUT; ++begin) {
+                    take(begin);
+                }
+                for (; end % PLOT_FANOUT; --end) {
+                    take(end - 1);
+                }
+                begin /= PLOT_FANOUT;
+                end /= PLOT_FANOUT;
+                los = levels[level].lo.data();
+                his = levels[level].hi.data();
+                slots = levels[level].lo.size();
+            }
+        }
+    };
+
+    struct PlotComponent : public UIComponent {
+        std::vector<std::unique_ptr<PlotSeries>> series;
+        UIContext* owner;
+
+        // View: viewCount samples ending at viewEnd, or at the newest sample while follow is set
+        double viewCount = 0.0; // 0 shows everything in the rings
+        double viewEnd = 0.0;
+        bool follow = true;
+        bool autoScale = true; // Fit the y range to the visible samples, else use yMin and yMax
+        float yMin = 0.0f, yMax = 1.0f;
+        int gridLines = 4;
+
+        // What update() resolved for record()
+        struct Trace {
+            std::vector<float> columnLo, columnHi; // Per pixel column, NaN where there are no samples
+            std::vector<float> pointX, pointValue; // Samples, when there are fewer than columns
+            bool columns = true;
+        };
+        std::vector<Trace> traces;
+        double shownBegin = 0.0, shownEnd = 0.0;
+        float shownMin = 0.0f, shownMax = 1.0f;
+
+        bool isMouseOver = false;
+        bool isDragging = false;
+        int dragX = 0;
+        int mouseX = 0; // Last motion, the wheel's zoom anchor
+
+        PlotComponent(int width, int height) : owner(&ui()) {
+            this->width = width;
+            this->height = height;
+            styleType = StyleComponent::Plot;
+            countObject("PlotComponent", 1);
+        }
+
+        ~PlotComponent() {
+            untrackResource(ResourceKind::Host, resourceHandle(this));
+            countObject("PlotComponent", -1);
+        }
+
+        // The series belongs to the plot; producers must stop appending before the plot is deleted
+        PlotSeries* addSeries(const std::string& name, size_t capacity, uint32_t color) {
+            series.push_back(std::make_unique<PlotSeries>(name, capacity, color, owner));
+            traces.emplace_back();
+            size_t bytes = 0;
+            for (const auto& each : series) {
+                bytes += each->bytes();
+            }
+            trackResource(ResourceKind::Host, resourceHandle(this), bytes, "Plot", "", parent ? parent->ID : -1);
+            requestRedraw();
+            return series.back().get();
+        }
+
+        // Show count samples ending at end; follow keeps the end at the newest sample
+        void setView(double count, double end, bool followNewest = false) {
+            viewCount = std::max(0.0, count);
+            viewEnd = end;
+            follow = followNewest;
+            requestRedraw();
+        }
+
+        void setYRange(float minimum, float maximum) {
+            autoScale = false;
+            yMin = minimum;
+            yMax = maximum;
+            requestRedraw();
+        }
+
+        float valueToY(float value) const {
+            return y + height - (value - shownMin) / (shownMax - shownMin) * height;
+        }
+
+        // Resolve the view and fetch per column extremes; a few dozen reads per column and series
+        virtual void update(float dt) override {
+            uint64_t newest = 0, retained = 0;
+            for (const auto& each : series) {
+                std::lock_guard<std::mutex> lock(each->mutex);
+                newest = std::max(newest, each->total);
+                retained = std::max(retained, each->total - each->first());
+            }
+            shownEnd = follow ? static_cast<double>(newest) : viewEnd;
+            shownBegin = shownEnd - (viewCount > 0.0 ? viewCount : static_cast<double>(std::max<uint64_t>(retained, 1)));
+            size_t columns = static_cast<size_t>(std::max(width, 1));
+            double perColumn = (shownEnd - shownBegin) / columns;
+
+            float lowest = std::numeric_limits<float>::infinity(), highest = -lowest;
+            for (size_t s = 0; s < series.size(); ++s) {
+                const PlotSeries& source = *series[s];
+                Trace& trace = traces[s];
+                std::lock_guard<std::mutex> lock(source.mutex);
+                double first = static_cast<double>(source.first()), end = static_cast<double>(source.total);
+                trace.columns = perColumn >= 1.0;
+                trace.pointX.clear();
+                trace.pointValue.clear();
+                if (trace.columns) {
+                    trace.columnLo.resize(columns);
+                    trace.columnHi.resize(columns);
+                    for (size_t c = 0; c < columns; ++c) {
+                        double begin = std::max(first, std::floor(shownBegin + c * perColumn));
+                        double stop = std::min(end, std::floor(shownBegin + (c + 1) * perColumn));
+                        float lo, hi;
+                        if (begin < stop && source.extremes(static_cast<uint64_t>(begin), static_cast<uint64_t>(stop), lo, hi)) {
+                            trace.columnLo[c] = lo;
+                            trace.columnHi[c] = hi;
+                            lowest = std::min(lowest, lo);
+                            highest = std::max(highest, hi);
+                        }
+                        else {
+                            trace.columnLo[c] = trace.columnHi[c] = std::numeric_limits<float>::quiet_NaN();
+                        }
+                    }
+                }
+                else {
+                    // One sample past each edge, so the lines run to the border
+                    double begin = std::max(first, std::floor(shownBegin) - 1.0);
+                    double stop = std::min(end, std::ceil(shownEnd) + 1.0);
+                    for (double index = begin; index < stop; index += 1.0) {
+                        float value = source.samples[static_cast<size_t>(static_cast<uint64_t>(index) % source.capacity())];
+                        trace.pointX.push_back(static_cast<float>(x + (index - shownBegin) / perColumn));
+                        trace.pointValue.push_back(value);
+                        if (index >= shownBegin && index < shownEnd) {
+                            lowest = std::min(lowest, value);
+                            highest = std::max(highest, value);
+                        }
+                    }
+                }
+            }
+
+            shownMin = autoScale ? lowest : yMin;
+            shownMax = autoScale ? highest : yMax;
+            if (!(shownMin <= shownMax)) { // No samples in view (or NaN ranges)
+                shownMin = 0.0f;
+                shownMax = 1.0f;
+            }
+            if (shownMax - shownMin < 1e-6f * std::max(1.0f, std::fabs(shownMax))) {
+                shownMin -= 0.5f; // Flat data sits in the middle
+                shownMax += 0.5f;
+            }
+            else if (autoScale) {
+                float margin = 0.05f * (shownMax - shownMin);
+                shownMin -= margin;
+                shownMax += margin;
+            }
+        }
+
+        virtual void Draw() override {
+            drawRecorded(*this);
+        }
+
+        virtual void record(DrawList& list) override {
+            const ResolvedStyle& box = style();
+            float b = box.borderWidth;
+            list.addRoundedRect(x - b, y - b, width + 2.0f * b, height + 2.0f * b, box.background, box.cornerRadius, b, box.border);
+            for (int line = 1; line < gridLines; ++line) {
+                list.addRect(x, std::floor(y + height * line / static_cast<float>(gridLines)), static_cast<float>(width), 1.0f, box.accent);
+            }
+
+            list.pushClip(x, y, static_cast<float>(width), static_cast<float>(height));
+            for (size_t s = 0; s < series.size(); ++s) {
+                const Trace& trace = traces[s];
+                const PlotSeries& source = *series[s];
+                if (trace.columns) {
+                    // One rect per column from min to max, stretched to touch the previous column so the trace stays connected
+                    float previousTop = 0.0f, previousBottom = 0.0f;
+                    bool hasPrevious = false;
+                    for (size_t c = 0; c < trace.columnLo.size(); ++c) {
+                        if (std::isnan(trace.columnLo[c])) {
+                            hasPrevious = false;
+                            continue;
+                        }
+                        float top = valueToY(trace.columnHi[c]), bottom = valueToY(trace.columnLo[c]);
+                        float drawTop = top, drawBottom = bottom;
+                        if (hasPrevious) {
+                            drawTop = std::min(drawTop, previousBottom);
+                            drawBottom = std::max(drawBottom, previousTop);
+                        }
+                        if (drawBottom - drawTop < source.thickness) {
+                            float middle = 0.5f * (drawTop + drawBottom);
+                            drawTop = middle - 0.5f * source.thickness;
+                            drawBottom = middle + 0.5f * source.thickness;
+                        }
+                        list.addRect(x + static_cast<float>(c), drawTop, 1.0f, drawBottom - drawTop, source.color);
+                        previousTop = top;
+                        previousBottom = bottom;
+                        hasPrevious = true;
+                    }
+                }
+                else {
+                    for (size_t i = 1; i < trace.pointX.size(); ++i) {
+                        list.addLine(trace.pointX[i - 1], valueToY(trace.pointValue[i - 1]), trace.pointX[i], valueToY(trace.pointValue[i]), source.thickness, source.color);
+                    }
+                }
+            }
+            list.popClip();
+        }
+
+        virtual void handleEvents(SDL_Event* event) override {
+            if (event->type == SDL_MOUSEMOTION) {
+                mouseX = event->motion.x;
+                isMouseOver = event->motion.x > x && event->motion.x < x + width && event->motion.y > y && event->motion.y < y + height;
+                if (isDragging) {
+                    double perPixel = (shownEnd - shownBegin) / std::max(width, 1);
+                    setView(shownEnd - shownBegin, shownEnd - (event->motion.x - dragX) * perPixel);
+                    dragX = event->motion.x;
+                }
+            }
+            else if (event->type == SDL_MOUSEBUTTONDOWN && event->button.button == SDL_BUTTON_LEFT && isMouseOver) {
+                isDragging = true;
+                dragX = event->button.x;
+            }
+            else if (event->type == SDL_MOUSEBUTTONUP && event->button.button == SDL_BUTTON_LEFT && isDragging) {
+                isDragging = false;
+                uint64_t newest = 0;
+                for (const auto& each : series) {
+                    std::lock_guard<std::mutex> lock(each->mutex);
+                    newest = std::max(newest, each->total);
+                }
+                if (viewEnd >= static_cast<double>(newest)) { // Panned to the newest sample, so keep up with it again
+                    setView(viewCount, viewEnd, true);
+                }
+            }
+            else if (event->type == SDL_MOUSEWHEEL && isMouseOver && event->wheel.y != 0) {
+                double span = shownEnd - shownBegin;
+                double anchor = shownBegin + span * std::min(std::max((mouseX - x) / static_cast<double>(std::max(width, 1)), 0.0), 1.0);
+                double zoomed = std::max(2.0, span * std::pow(0.8, event->wheel.y)); // Wheel up zooms in
+                if (follow) {
+                    setView(zoomed, shownEnd, true); // Stay on the newest sample
+                }
+                else {
+                    setView(zoomed, anchor + (shownEnd - anchor) * (zoomed / span));
+                }
+            }
+        }
+    };
+
+    PlotComponent* Plot(int width, int height) {
+        if (!currentUIManager().currentWidget) {
+            std::cerr << "No widget selected" << std::endl;
+            return nullptr;
+        }
+        auto plot = new PlotComponent(width, height);
+        addComponent(plot);
+        assignResource(ResourceKind::Host, resourceHandle(plot), "Plot", currentUIManager().currentWidget->ID);
+        return plot;
+    }
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+//////////////////////////////////////////////////////////
+////////////SV UI SHADER PROGRAM CACHE////////////////////
+//////////////////////////////////////////////////////////
+// Keeps linked shader programs on disk (glGetProgramBinary) so later launches
+// skip compiling GLSL, which is slow on some drivers (Mesa in particular).
+// Entries are keyed by a hash of the shader sources and the driver's
+// vendor/renderer/version strings, so a driver update or an edited shader
+// simply misses. A binary the driver rejects is deleted and the program is
+// compiled from source as before; callers never see the difference.
+//
+// Set shaderCacheDirectory before initOpenGL() to move the cache, or clear it
+// to disable caching. Requires GL 4.1 or ARB_get_program_binary; without it
+// every program is compiled from source.
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <functional>
+#include "sv_ui_utilities.h"
+
+namespace SV_UI {
+
+    std::string shaderCacheDirectory = "shader_cache";
+
+    const uint32_t SHADER_CACHE_MAGIC = 0x42505653; // "SVPB"
+
+    struct ShaderCacheFileHeader {
+        uint32_t magic;
+        uint32_t format; // Driver binary format from glGetProgramBinary
+        uint64_t key;    // Repeated so a hash-named file from elsewhere is not trusted blindly
+        uint32_t length;
+        uint32_t reserved;
+    };
+
+    // FNV-1a over the length, then the bytes; the length keeps "ab"+"c" and "a"+"bc" apart
+    uint64_t hashShaderBytes(uint64_t hash, const char* data, size_t length) {
+        const uint64_t prime = 1099511628211ull;
+        uint64_t size = length;
+        for (int shift = 0; shift < 64; shift += 8) {
+            hash ^= (size >> shift) & 0xff;
+            hash *= prime;
+        }
+        for (size_t i = 0; i < length; ++i) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= prime;
+        }
+        return hash;
+    }
+
+    bool shaderCacheAvailable() {
+        if (shaderCacheDirectory.empty() || !glewIsSupported("GL_ARB_get_program_binary")) {
+            return false;
+        }
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        return formats > 0;
+    }
+
+    uint64_t shaderCacheKey(const std::vector<const char*>& sources) {
+        uint64_t hash = 14695981039346656037ull;
+        for (const char* source : sources) {
+            hash = hashShaderBytes(hash, source, std::strlen(source));
+        }
+        const GLenum driverStrings[] = { GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION };
+        for (GLenum name : driverStrings) {
+            const char* value = reinterpret_cast<const char*>(glGetString(name));
+            if (value) {
+                hash = hashShaderBytes(hash, value, std::strlen(value));
+            }
+        }
+        return hash;
+    }
+
+    std::string shaderCachePath(uint64_t key) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+        return (std::filesystem::path(shaderCacheDirectory) / name).string();
+    }
+
+    // Returns a linked program, or 0 if there is no usable cache entry for key
+    GLuint loadCachedProgram(uint64_t key) {
+        std::string path = shaderCachePath(key);
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            return 0;
+        }
+        std::error_code sizeError;
+        uintmax_t fileSize = std::filesystem::file_size(path, sizeError);
+        ShaderCacheFileHeader header;
+        std::vector<char> binary;
+        // The stored length must account for the rest of the file exactly before anything is allocated
+        bool valid = !sizeError && static_cast<bool>(in.read(reinterpret_cast<char*>(&header), sizeof(header))) &&
+            header.magic == SHADER_CACHE_MAGIC && header.key == key && header.length > 0 &&
+            header.length == fileSize - sizeof(header);
+        if (valid) {
+            binary.resize(header.length);
+            valid = static_cast<bool>(in.read(binary.data(), binary.size()));
+        }
+        in.close();
+
+        GLuint program = 0;
+        if (valid) {
+            program = glCreateProgram();
+            glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+            GLint linked = GL_FALSE;
+            glGetProgramiv(program, GL_LINK_STATUS, &linked);
+            if (!linked) {
+                glDeleteProgram(program);
+                program = 0;
+            }
+        }
+        if (!program) {
+            // Stale or corrupt; drop it so the fresh binary replaces it
+            std::error_code ignored;
+            std::filesystem::remove(path, ignored);
+        }
+        return program;
+    }
+
+    void storeCachedProgram(GLuint program, uint64_t key) {
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0) {
+            return;
+        }
+        // Header and binary in one buffer, filled in place
+        std::vector<char> file(sizeof(ShaderCacheFileHeader) + length);
+        GLenum format = 0;
+        glGetProgramBinary(program, length, nullptr, &format, file.data() + sizeof(ShaderCacheFileHeader));
+        ShaderCacheFileHeader header = { SHADER_CACHE_MAGIC, format, key, static_cast<uint32_t>(length), 0 };
+        std::memcpy(file.data(), &header, sizeof(header));
+
+        std::error_code error;
+        std::filesystem::create_directories(shaderCacheDirectory, error);
+        writeFileAtomically(shaderCachePath(key), file.data(), file.size());
+    }
+
+    // The one path from shader sources to a program for every createShaderProgram(): returns
+    // the cached binary for sources when the driver accepts it, otherwise creates a program and
+    // has link() attach the compiled shaders and link it, then stores the binary if link()
+    // reported success. The program is returned either way, like glLinkProgram's result.
+    GLuint linkCachedProgram(const std::vector<const char*>& sources, const std::function<bool(GLuint program)>& link) {
+        bool cached = shaderCacheAvailable();
+        uint64_t key = 0;
+        if (cached) {
+            key = shaderCacheKey(sources);
+            if (GLuint program = loadCachedProgram(key)) {
+                return program;
+            }
+        }
+        GLuint program = glCreateProgram();
+        if (cached) {
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE); // Must precede the link
+        }
+        if (link(program) && cached) {
+            storeCachedProgram(program, key);
+        }
+        return program;
+    }
+}
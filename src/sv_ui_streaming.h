@@ -0,0 +1,353 @@
+#pragma once
+
+//////////////////////////////////////////////////////////
+////////////SV UI STREAMING IMAGES////////////////////////
+//////////////////////////////////////////////////////////
+// An image component for pixels that change every frame (camera previews,
+// heatmaps). Producers write frames from any thread straight into a ring of
+// mapped pixel buffer objects; the GL thread only issues the glTexSubImage2D
+// from the buffer, so no frame is copied on the UI thread.
+//
+//     auto* preview = SV_UI::StreamingImage(1920, 1080, 480, 270);
+//     // Camera thread:
+//     if (uint8_t* pixels = preview->beginFrame()) { // width * height * 4 bytes
+//         ... fill pixels ...
+//         preview->endFrame();                      // Or submitFrame(data, stride)
+//     }
+//
+// Each buffer is a slot that is free, being written, pending or being
+// uploaded; an uploaded slot is fenced and only handed back to producers once
+// the GPU has finished reading it. The producer never waits: beginFrame()
+// takes a free slot, or else reclaims the pending frame the GL thread has not
+// taken yet, or else returns nullptr. Replaced and refused frames are counted
+// in framesDropped. Only the newest frame is ever shown.
+//
+// With GL_ARB_buffer_storage (core in GL 4.4) the buffers are persistently
+// mapped and fenced as above. Without it, as on a 3.3 core context, the GL
+// thread keeps every free buffer mapped for the producers instead: it unmaps
+// a buffer to upload from it, then orphans it with glBufferData(nullptr) and
+// maps the fresh storage with GL_MAP_INVALIDATE_BUFFER_BIT |
+// GL_MAP_UNSYNCHRONIZED_BIT, so the slot is free again at once and needs no
+// fence. Only if mapping fails are the slots host memory, uploaded with a
+// client-memory glTexSubImage2D. All of that GL work is in syncGL(), which
+// update() asks for every frame; beginFrame() returns nullptr until the first.
+
+#include "sv_ui3.0.h"
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+
+namespace SV_UI {
+
+    enum class StreamPixelFormat : uint8_t {
+        RGBA, // Bytes R, G, B, A
+        BGRA  // Bytes B, G, R, A, what many capture APIs produce and many drivers upload fastest
+    };
+
+    const int STREAM_PBO_COUNT = 3;
+
+    enum class StreamBufferMode : uint8_t {
+        Persistent, // Mapped once for good, fenced per upload (GL_ARB_buffer_storage)
+        Orphaned,   // Unmapped for each upload, then orphaned and mapped again
+        Host        // Host memory and client-memory uploads, when mapping failed
+    };
+
+    enum class StreamSlotState : uint8_t {
+        Free,      // Producers may take it
+        Writing,   // Between beginFrame() and endFrame()
+        Pending,   // Newest complete frame, waiting for the GL thread
+        Uploading  // Read by the GPU until its fence signals
+    };
+
+    struct StreamingImageComponent : public UIComponent {
+        int sourceWidth = 0, sourceHeight = 0; // Size of the frames in pixels, fixed
+        StreamPixelFormat format = StreamPixelFormat::RGBA;
+
+        // One slot per PBO. Producers own writeSlot, pendingSlot is in between, -1 when none
+        uint8_t* slotPixels[STREAM_PBO_COUNT] = {}; // Mapped PBO storage, or hostSlots when mapping failed
+        StreamSlotState slotStates[STREAM_PBO_COUNT] = {};
+        int writeSlot = -1, pendingSlot = -1;
+        bool slotsReady = false; // Set once the GL thread created the slots
+        std::mutex slotMutex; // Guards the slot fields above, never held while pixels are written
+        std::vector<uint8_t> hostSlots[STREAM_PBO_COUNT]; // Fallback storage, empty when the PBOs are mapped
+
+        // GL side, touched on the GL thread only
+        GLuint texture = 0;
+        GLuint pbos[STREAM_PBO_COUNT] = {};
+        GLsync fences[STREAM_PBO_COUNT] = {};
+        StreamBufferMode mode = StreamBufferMode::Host;
+        bool hasImage = false;
+
+        std::atomic<uint64_t> framesSubmitted{ 0 };
+        std::atomic<uint64_t> framesUploaded{ 0 };
+        std::atomic<uint64_t> framesDropped{ 0 };
+
+        UIContext* owner; // Woken by producers, which have no context current
+
+        StreamingImageComponent(int sourceWidth, int sourceHeight, int width, int height, StreamPixelFormat format = StreamPixelFormat::RGBA)
+            : sourceWidth(sourceWidth), sourceHeight(sourceHeight), format(format), owner(&ui()) {
+            this->width = width;
+            this->height = height;
+            styleType = StyleComponent::Image;
+            countObject("StreamingImageComponent", 1);
+        }
+
+        ~StreamingImageComponent() {
+            for (int i = 0; i < STREAM_PBO_COUNT; ++i) {
+                if (fences[i]) {
+                    glDeleteSync(fences[i]);
+                }
+                untrackResource(ResourceKind::Buffer, pbos[i]);
+            }
+            if (pbos[0]) {
+                glDeleteBuffers(STREAM_PBO_COUNT, pbos); // Also unmaps mapped storage
+            }
+            if (texture) {
+                untrackResource(ResourceKind::Texture, texture);
+                glDeleteTextures(1, &texture);
+            }
+            if (!hostSlots[0].empty()) {
+                untrackResource(ResourceKind::Host, resourceHandle(this));
+            }
+            countObject("StreamingImageComponent", -1);
+        }
+
+        size_t frameBytes() const {
+            return static_cast<size_t>(sourceWidth) * sourceHeight * 4;
+        }
+
+        // Producer side, any single thread at a time. Returns the buffer to fill with the next
+        // frame (tightly packed rows of sourceWidth * 4 bytes), valid until endFrame(), or
+        // nullptr when every slot is busy; skip the frame then.
+        uint8_t* beginFrame() {
+            std::lock_guard<std::mutex> lock(slotMutex);
+            if (!slotsReady) {
+                ++framesDropped; // No GL objects yet
+                return nullptr;
+            }
+            for (int i = 0; i < STREAM_PBO_COUNT; ++i) {
+                if (slotStates[i] == StreamSlotState::Free) {
+                    slotStates[i] = StreamSlotState::Writing;
+                    writeSlot = i;
+                    return slotPixels[i];
+                }
+            }
+            if (pendingSlot >= 0) {
+                ++framesDropped; // The GL thread never saw the frame we are about to overwrite
+                writeSlot = pendingSlot;
+                pendingSlot = -1;
+                slotStates[writeSlot] = StreamSlotState::Writing;
+                return slotPixels[writeSlot];
+            }
+            ++framesDropped;
+            return nullptr;
+        }
+
+        void endFrame() {
+            {
+                std::lock_guard<std::mutex> lock(slotMutex);
+                if (writeSlot < 0) {
+                    return;
+                }
+                if (pendingSlot >= 0) {
+                    ++framesDropped; // Replaced before the GL thread took it
+                    slotStates[pendingSlot] = StreamSlotState::Free;
+                }
+                slotStates[writeSlot] = StreamSlotState::Pending;
+                pendingSlot = writeSlot;
+                writeSlot = -1;
+            }
+            ++framesSubmitted;
+            requestRedrawAsync(*owner);
+        }
+
+        // Copy a frame in; stride is the distance between rows in bytes (0 for tightly packed).
+        // Returns false when the frame was dropped because every slot was busy.
+        bool submitFrame(const void* pixels, size_t stride = 0) {
+            uint8_t* dst = beginFrame();
+            if (!dst) {
+                return false;
+            }
+            size_t rowBytes = static_cast<size_t>(sourceWidth) * 4;
+            if (stride == 0 || stride == rowBytes) {
+                std::memcpy(dst, pixels, frameBytes());
+            }
+            else {
+                const uint8_t* src = static_cast<const uint8_t*>(pixels);
+                for (int row = 0; row < sourceHeight; ++row) {
+                    std::memcpy(dst + row * rowBytes, src + row * stride, rowBytes);
+                }
+            }
+            endFrame();
+            return true;
+        }
+
+        void createGLObjects() {
+            glGenTextures(1, &texture);
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, sourceWidth, sourceHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            int widgetID = parent ? parent->ID : -1;
+            trackResource(ResourceKind::Texture, texture, frameBytes(), "StreamingImage", "", widgetID);
+
+            uint8_t* pixels[STREAM_PBO_COUNT] = {};
+            mode = glewIsSupported("GL_ARB_buffer_storage") ? StreamBufferMode::Persistent : StreamBufferMode::Orphaned;
+            bool mapped = true;
+            glGenBuffers(STREAM_PBO_COUNT, pbos);
+            for (int i = 0; i < STREAM_PBO_COUNT && mapped; ++i) {
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos[i]);
+                if (mode == StreamBufferMode::Persistent) {
+                    // Coherent, so producer writes are visible to the upload without a flush
+                    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+                    glBufferStorage(GL_PIXEL_UNPACK_BUFFER, frameBytes(), nullptr, flags);
+                    pixels[i] = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, frameBytes(), flags));
+                }
+                else {
+                    pixels[i] = mapFreshStorage();
+                }
+                mapped = pixels[i] != nullptr;
+            }
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            if (mapped) {
+                for (GLuint pbo : pbos) {
+                    trackResource(ResourceKind::Buffer, pbo, frameBytes(), "StreamingImage", "", widgetID);
+                }
+            }
+            else {
+                std::cerr << "StreamingImageComponent: failed to map pixel buffer, using host memory" << std::endl;
+                glDeleteBuffers(STREAM_PBO_COUNT, pbos);
+                std::fill(std::begin(pbos), std::end(pbos), 0u);
+                mode = StreamBufferMode::Host;
+                for (int i = 0; i < STREAM_PBO_COUNT; ++i) {
+                    hostSlots[i].resize(frameBytes());
+                    pixels[i] = hostSlots[i].data();
+                }
+                trackResource(ResourceKind::Host, resourceHandle(this), STREAM_PBO_COUNT * frameBytes(), "StreamingImage", "", widgetID);
+            }
+
+            std::lock_guard<std::mutex> lock(slotMutex);
+            std::copy(std::begin(pixels), std::end(pixels), slotPixels);
+            slotsReady = true;
+        }
+
+        // Orphan the bound PBO's storage and map fresh storage for writing. The driver keeps
+        // the old storage alive for uploads still reading it, so neither call waits for the GPU.
+        uint8_t* mapFreshStorage() {
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, frameBytes(), nullptr, GL_STREAM_DRAW);
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+            return static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, frameBytes(), flags));
+        }
+
+        void releaseSlot(int slot) {
+            std::lock_guard<std::mutex> lock(slotMutex);
+            slotStates[slot] = StreamSlotState::Free;
+        }
+
+        // Polling the fences and uploading are GL calls, so they wait for syncGL()
+        virtual void update(float dt) override {
+            requestGLSync(*this);
+        }
+
+        // GL thread: hand signalled slots back to producers, then upload the pending frame
+        virtual void syncGL() override {
+            if (!texture) {
+                createGLObjects();
+            }
+            bool inFlight = false;
+            for (int i = 0; i < STREAM_PBO_COUNT; ++i) {
+                if (!fences[i]) {
+                    continue;
+                }
+                if (glClientWaitSync(fences[i], 0, 0) == GL_TIMEOUT_EXPIRED) {
+                    inFlight = true;
+                    continue;
+                }
+                glDeleteSync(fences[i]);
+                fences[i] = nullptr;
+                releaseSlot(i);
+            }
+
+            int slot;
+            {
+                std::lock_guard<std::mutex> lock(slotMutex);
+                slot = pendingSlot;
+                if (slot >= 0) {
+                    pendingSlot = -1;
+                    slotStates[slot] = StreamSlotState::Uploading;
+                }
+            }
+            if (slot < 0) {
+                if (inFlight) {
+                    requestRedraw(); // Come back to recycle the slots still read by the GPU
+                }
+                return;
+            }
+
+            GLenum pixelFormat = format == StreamPixelFormat::BGRA ? GL_BGRA : GL_RGBA;
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            if (mode == StreamBufferMode::Persistent) {
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos[slot]);
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, sourceWidth, sourceHeight, pixelFormat, GL_UNSIGNED_BYTE, nullptr); // From the bound PBO
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            }
+            else if (mode == StreamBufferMode::Orphaned) {
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos[slot]);
+                glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, sourceWidth, sourceHeight, pixelFormat, GL_UNSIGNED_BYTE, nullptr); // From the bound PBO
+                uint8_t* fresh = mapFreshStorage();
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                if (fresh) {
+                    std::lock_guard<std::mutex> lock(slotMutex);
+                    slotPixels[slot] = fresh;
+                    slotStates[slot] = StreamSlotState::Free;
+                }
+                else {
+                    std::cerr << "StreamingImageComponent: failed to map pixel buffer, the ring has one slot fewer" << std::endl;
+                    std::lock_guard<std::mutex> lock(slotMutex);
+                    slotPixels[slot] = nullptr; // Stays Uploading, so producers never get it
+                }
+            }
+            else {
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, sourceWidth, sourceHeight, pixelFormat, GL_UNSIGNED_BYTE, slotPixels[slot]);
+                releaseSlot(slot); // Client memory is consumed before the call returns
+            }
+            glBindTexture(GL_TEXTURE_2D, 0);
+            hasImage = true;
+            ++framesUploaded;
+            requestRedraw();
+        }
+
+        virtual void Draw() override {
+            drawRecorded(*this);
+        }
+
+        virtual void record(DrawList& list) override {
+            if (hasImage) {
+                list.addImage(texture, x, y, static_cast<float>(width), static_cast<float>(height));
+            }
+            else {
+                list.addRect(x, y, static_cast<float>(width), static_cast<float>(height), style().background); // Placeholder until the first frame
+            }
+        }
+
+        virtual void handleEvents(SDL_Event* event) override {
+        }
+    };
+
+    // Frames are sourceWidth x sourceHeight pixels, shown scaled to width x height
+    StreamingImageComponent* StreamingImage(int sourceWidth, int sourceHeight, int width, int height, StreamPixelFormat format = StreamPixelFormat::RGBA) {
+        if (!currentUIManager().currentWidget) {
+            std::cerr << "No widget selected" << std::endl;
+            return nullptr;
+        }
+        auto image = new StreamingImageComponent(sourceWidth, sourceHeight, width, height, format);
+        addComponent(image);
+        return image;
+    }
+}
@@ -0,0 +1,311 @@
+#pragma once
+
+//////////////////////////////////////////////////////////
+////////////SV UI STYLES//////////////////////////////////
+//////////////////////////////////////////////////////////
+// Themes are written as rules ("buttons, when hovered, have this background")
+// and compiled into a flat table indexed by [style class][component][state],
+// so drawing looks a style up with index arithmetic only. Components keep a
+// small style class index, interned once when the class is set, instead of
+// strings or pointers into a theme, so switching themes is a pointer swap:
+//
+//     SV_UI::Theme dark = SV_UI::defaultTheme();
+//     dark.set(SV_UI::StyleComponent::Button, SV_UI::StyleState::Hover,
+//              SV_UI::StyleProperty::Background, SV_UI::packColor(0.3f, 0.3f, 0.35f));
+//     static SV_UI::CompiledTheme darkCompiled = SV_UI::compileTheme(dark);
+//     SV_UI::setTheme(&darkCompiled); // Takes effect on the next frame
+//
+// Compiled themes are not copied; they must stay alive while they are active.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <mutex>
+
+namespace SV_UI {
+
+    void requestRedraw(); // sv_ui3.0.h
+
+    // Pack a color into the RGBA byte order used by DrawVertex::color
+    inline uint32_t packColor(float r, float g, float b, float a = 1.0f) {
+        auto toByte = [](float v) -> uint32_t {
+            v = v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+            return static_cast<uint32_t>(v * 255.0f + 0.5f);
+        };
+        return toByte(r) | (toByte(g) << 8) | (toByte(b) << 16) | (toByte(a) << 24);
+    }
+
+    enum class StyleComponent : uint8_t {
+        Widget,    // Widget background when it has no texture
+        Text,
+        Button,
+        ListBox,   // Box, border and row text
+        ListRow,   // Row highlight; Accent is the type-ahead match highlight
+        Scrollbar, // Background is the track, Accent the thumb
+        TextEdit,  // Box, border and text; Accent is the selection, Selected the focused state
+        GridHeader, // Data grid header; Border is also the column rule, Accent a column being resized
+        Plot,      // Plot area and border; Accent is the grid lines
+        Console,   // Log box, border and line text; the severity states color lines by severity
+        Image,     // Streaming image placeholder until the first frame arrives
+        Window,    // Immediate-mode window background (sv_ui_immediate.h)
+        Checkbox,  // Immediate-mode check box; Accent is the check mark
+        Count
+    };
+
+    enum class StyleState : uint8_t {
+        Normal,
+        Hover,
+        Pressed,
+        Selected,
+        Trace,   // Console line severities; Info lines use Normal
+        Debug,
+        Warning,
+        Error,
+        Count
+    };
+
+    enum class StyleProperty : uint8_t {
+        Background,
+        Border,
+        TextColor,
+        Accent,
+        BorderWidth,
+        CornerRadius,
+        Shadow,    // Drop shadow color, 0 for none
+        ShadowSize // Blur distance of the drop shadow in pixels
+    };
+
+    // One cell of the compiled table
+    struct ResolvedStyle {
+        uint32_t background = 0; // Packed RGBA, 0 is fully transparent
+        uint32_t border = 0;
+        uint32_t text = 0;
+        uint32_t accent = 0;
+        float borderWidth = 0.0f;
+        float cornerRadius = 0.0f;
+        uint32_t shadow = 0;
+        float shadowSize = 0.0f;
+    };
+
+    const StyleComponent ANY_COMPONENT = StyleComponent::Count;
+    const StyleState ANY_STATE = StyleState::Count;
+
+    struct StyleRule {
+        StyleComponent component = ANY_COMPONENT;
+        StyleState state = ANY_STATE;
+        uint16_t styleClass = 0; // 0 matches every class
+        StyleProperty property = StyleProperty::Background;
+        uint32_t color = 0;
+        float number = 0.0f;
+
+        // Class beats component beats state; equal specificity falls back to rule order
+        int specificity() const {
+            return (styleClass ? 4 : 0) + (component != ANY_COMPONENT ? 2 : 0) + (state != ANY_STATE ? 1 : 0);
+        }
+    };
+
+    // Style class names share one index space across themes and UI contexts. Index 0 is the unnamed default class.
+    std::vector<std::string> styleClassNames(1);
+    std::mutex styleClassMutex;
+
+    uint16_t internStyleClass(const std::string& name) {
+        if (name.empty()) {
+            return 0;
+        }
+        std::lock_guard<std::mutex> lock(styleClassMutex);
+        for (size_t i = 1; i < styleClassNames.size(); ++i) {
+            if (styleClassNames[i] == name) {
+                return static_cast<uint16_t>(i);
+            }
+        }
+        styleClassNames.push_back(name);
+        return static_cast<uint16_t>(styleClassNames.size() - 1);
+    }
+
+    // Source form of a theme
+    struct Theme {
+        std::vector<StyleRule> rules;
+
+        Theme& set(StyleComponent component, StyleState state, StyleProperty property, uint32_t color, const std::string& styleClass = "") {
+            StyleRule rule;
+            rule.component = component;
+            rule.state = state;
+            rule.styleClass = internStyleClass(styleClass);
+            rule.property = property;
+            rule.color = color;
+            rules.push_back(rule);
+            return *this;
+        }
+
+        // For numeric properties such as BorderWidth and CornerRadius
+        Theme& setNumber(StyleComponent component, StyleState state, StyleProperty property, float number, const std::string& styleClass = "") {
+            set(component, state, property, 0, styleClass);
+            rules.back().number = number;
+            return *this;
+        }
+    };
+
+    struct CompiledTheme {
+        std::vector<ResolvedStyle> table; // [class][component][state]
+        size_t classCount = 0;
+        Theme source; // The rules it was compiled from, so it can be extended and recompiled
+
+        // Classes interned after the theme was compiled have no rules in it and use the default class
+        const ResolvedStyle& lookup(uint16_t styleClass, StyleComponent component, StyleState state) const {
+            size_t row = (styleClass < classCount ? styleClass : 0) * static_cast<size_t>(StyleComponent::Count) + static_cast<size_t>(component);
+            return table[row * static_cast<size_t>(StyleState::Count) + static_cast<size_t>(state)];
+        }
+    };
+
+    void applyStyleRule(ResolvedStyle& style, const StyleRule& rule) {
+        switch (rule.property) {
+        case StyleProperty::Background: style.background = rule.color; break;
+        case StyleProperty::Border: style.border = rule.color; break;
+        case StyleProperty::TextColor: style.text = rule.color; break;
+        case StyleProperty::Accent: style.accent = rule.color; break;
+        case StyleProperty::BorderWidth: style.borderWidth = rule.number; break;
+        case StyleProperty::CornerRadius: style.cornerRadius = rule.number; break;
+        case StyleProperty::Shadow: style.shadow = rule.color; break;
+        case StyleProperty::ShadowSize: style.shadowSize = rule.number; break;
+        }
+    }
+
+    CompiledTheme compileTheme(const Theme& theme) {
+        std::vector<const StyleRule*> ordered;
+        for (const StyleRule& rule : theme.rules) {
+            ordered.push_back(&rule);
+        }
+        std::stable_sort(ordered.begin(), ordered.end(), [](const StyleRule* a, const StyleRule* b) {
+            return a->specificity() < b->specificity();
+        });
+
+        CompiledTheme compiled;
+        compiled.source = theme;
+        {
+            std::lock_guard<std::mutex> lock(styleClassMutex);
+            compiled.classCount = styleClassNames.size();
+        }
+        const size_t components = static_cast<size_t>(StyleComponent::Count);
+        const size_t states = static_cast<size_t>(StyleState::Count);
+        compiled.table.resize(compiled.classCount * components * states);
+        for (size_t cls = 0; cls < compiled.classCount; ++cls) {
+            for (size_t component = 0; component < components; ++component) {
+                for (size_t state = 0; state < states; ++state) {
+                    ResolvedStyle& style = compiled.table[(cls * components + component) * states + state];
+                    for (const StyleRule* rule : ordered) {
+                        if ((rule->styleClass == 0 || rule->styleClass == cls) &&
+                            (rule->component == ANY_COMPONENT || static_cast<size_t>(rule->component) == component) &&
+                            (rule->state == ANY_STATE || static_cast<size_t>(rule->state) == state)) {
+                            applyStyleRule(style, *rule);
+                        }
+                    }
+                }
+            }
+        }
+        return compiled;
+    }
+
+    // The built-in look; start custom themes from this and add rules
+    Theme defaultTheme() {
+        Theme theme;
+        theme.set(ANY_COMPONENT, ANY_STATE, StyleProperty::TextColor, packColor(1.0f, 1.0f, 1.0f));
+        theme.set(StyleComponent::Widget, ANY_STATE, StyleProperty::Background, packColor(1.0f, 0.0f, 0.0f)); // Red fallback
+        const float buttonGray = 0.5f; // The original untextured button; hover lightens it, pressing darkens it
+        theme.set(StyleComponent::Button, StyleState::Normal, StyleProperty::Background, packColor(buttonGray, buttonGray, buttonGray));
+        theme.set(StyleComponent::Button, StyleState::Hover, StyleProperty::Background, packColor(buttonGray + 0.1f, buttonGray + 0.1f, buttonGray + 0.1f));
+        theme.set(StyleComponent::Button, StyleState::Pressed, StyleProperty::Background, packColor(buttonGray - 0.1f, buttonGray - 0.1f, buttonGray - 0.1f));
+        theme.set(StyleComponent::ListBox, ANY_STATE, StyleProperty::Background, packColor(0.8f, 0.8f, 0.8f));
+        theme.set(StyleComponent::ListBox, ANY_STATE, StyleProperty::Border, packColor(0.0f, 0.0f, 0.0f));
+        theme.setNumber(StyleComponent::ListBox, ANY_STATE, StyleProperty::BorderWidth, 2.0f);
+        theme.set(StyleComponent::ListRow, StyleState::Hover, StyleProperty::Background, packColor(0.5f, 0.5f, 0.5f));
+        theme.set(StyleComponent::ListRow, StyleState::Selected, StyleProperty::Background, packColor(0.4f, 0.4f, 0.4f));
+        theme.set(StyleComponent::ListRow, ANY_STATE, StyleProperty::Accent, packColor(0.95f, 0.8f, 0.2f));
+        theme.set(StyleComponent::Scrollbar, ANY_STATE, StyleProperty::Background, packColor(0.6f, 0.6f, 0.6f));
+        theme.set(StyleComponent::Scrollbar, ANY_STATE, StyleProperty::Accent, packColor(0.35f, 0.35f, 0.35f));
+        theme.set(StyleComponent::Scrollbar, StyleState::Pressed, StyleProperty::Accent, packColor(0.2f, 0.2f, 0.2f));
+        theme.set(StyleComponent::TextEdit, ANY_STATE, StyleProperty::Background, packColor(0.15f, 0.15f, 0.15f));
+        theme.set(StyleComponent::TextEdit, ANY_STATE, StyleProperty::Border, packColor(0.0f, 0.0f, 0.0f));
+        theme.set(StyleComponent::TextEdit, StyleState::Selected, StyleProperty::Border, packColor(0.3f, 0.5f, 0.9f));
+        theme.set(StyleComponent::TextEdit, ANY_STATE, StyleProperty::Accent, packColor(0.25f, 0.4f, 0.7f));
+        theme.setNumber(StyleComponent::TextEdit, ANY_STATE, StyleProperty::BorderWidth, 2.0f);
+        theme.set(StyleComponent::GridHeader, ANY_STATE, StyleProperty::Background, packColor(0.65f, 0.65f, 0.65f));
+        theme.set(StyleComponent::GridHeader, ANY_STATE, StyleProperty::Border, packColor(0.55f, 0.55f, 0.55f));
+        theme.set(StyleComponent::GridHeader, ANY_STATE, StyleProperty::Accent, packColor(0.2f, 0.4f, 0.8f));
+        theme.set(StyleComponent::Plot, ANY_STATE, StyleProperty::Background, packColor(0.1f, 0.1f, 0.1f));
+        theme.set(StyleComponent::Plot, ANY_STATE, StyleProperty::Border, packColor(0.0f, 0.0f, 0.0f));
+        theme.set(StyleComponent::Plot, ANY_STATE, StyleProperty::Accent, packColor(0.25f, 0.25f, 0.25f));
+        theme.setNumber(StyleComponent::Plot, ANY_STATE, StyleProperty::BorderWidth, 1.0f);
+        theme.set(StyleComponent::Console, ANY_STATE, StyleProperty::Background, packColor(0.08f, 0.08f, 0.08f));
+        theme.set(StyleComponent::Console, ANY_STATE, StyleProperty::Border, packColor(0.0f, 0.0f, 0.0f));
+        theme.set(StyleComponent::Console, ANY_STATE, StyleProperty::TextColor, packColor(0.85f, 0.85f, 0.85f));
+        theme.set(StyleComponent::Console, StyleState::Trace, StyleProperty::TextColor, packColor(0.5f, 0.5f, 0.5f));
+        theme.set(StyleComponent::Console, StyleState::Debug, StyleProperty::TextColor, packColor(0.6f, 0.7f, 0.8f));
+        theme.set(StyleComponent::Console, StyleState::Warning, StyleProperty::TextColor, packColor(1.0f, 0.8f, 0.25f));
+        theme.set(StyleComponent::Console, StyleState::Error, StyleProperty::TextColor, packColor(1.0f, 0.35f, 0.3f));
+        theme.setNumber(StyleComponent::Console, ANY_STATE, StyleProperty::BorderWidth, 2.0f);
+        theme.set(StyleComponent::Image, ANY_STATE, StyleProperty::Background, packColor(0.0f, 0.0f, 0.0f));
+        theme.set(StyleComponent::Window, ANY_STATE, StyleProperty::Background, packColor(0.2f, 0.2f, 0.2f, 0.9f));
+        theme.set(StyleComponent::Checkbox, ANY_STATE, StyleProperty::Background, packColor(0.8f, 0.8f, 0.8f));
+        theme.set(StyleComponent::Checkbox, ANY_STATE, StyleProperty::Accent, packColor(0.1f, 0.1f, 0.1f));
+        return theme;
+    }
+
+    CompiledTheme builtinTheme = compileTheme(defaultTheme());
+    const CompiledTheme*& currentActiveTheme(); // Per UI context, defined in sv_ui3.0.h
+
+    // Switch every component to theme (nullptr restores the built-in one) on the next frame.
+    // In pipelined mode call it from the sync window, like any other UI change.
+    void setTheme(const CompiledTheme* theme) {
+        currentActiveTheme() = theme ? theme : &builtinTheme;
+        requestRedraw();
+    }
+
+    //////////////////////////////////////////////////////////
+    // Legacy 2.0 style API, kept so ported code builds. Changing
+    // the button style recompiles the active theme with it applied.
+
+    struct ButtonStyle {
+        float normalColor[3];
+        float hoverColor[3];
+        float pressedColor[3];
+    };
+
+    struct Styles {
+        ButtonStyle buttonStyle;
+        CompiledTheme compiled;
+        Theme base; // The theme the button colors were last applied on top of
+
+        // Define default styles in the constructor
+        Styles() {
+            // Default button colors
+            buttonStyle.normalColor[0] = 0.7f; buttonStyle.normalColor[1] = 0.7f; buttonStyle.normalColor[2] = 0.7f;
+            buttonStyle.hoverColor[0] = 0.8f; buttonStyle.hoverColor[1] = 0.8f; buttonStyle.hoverColor[2] = 0.8f;
+            buttonStyle.pressedColor[0] = 0.6f; buttonStyle.pressedColor[1] = 0.6f; buttonStyle.pressedColor[2] = 0.6f;
+        }
+
+        // The colors go on top of the active theme's rules, replacing its unclassed
+        // button backgrounds; rules for named style classes still win over them.
+        // Switching themes afterwards drops them until this is called again.
+        void setButtonStyle(const ButtonStyle& style) {
+            buttonStyle = style;
+            if (currentActiveTheme() != &compiled) {
+                base = currentActiveTheme()->source;
+            }
+            Theme theme = base;
+            theme.set(StyleComponent::Button, StyleState::Normal, StyleProperty::Background, packColor(style.normalColor[0], style.normalColor[1], style.normalColor[2]));
+            theme.set(StyleComponent::Button, StyleState::Hover, StyleProperty::Background, packColor(style.hoverColor[0], style.hoverColor[1], style.hoverColor[2]));
+            theme.set(StyleComponent::Button, StyleState::Pressed, StyleProperty::Background, packColor(style.pressedColor[0], style.pressedColor[1], style.pressedColor[2]));
+            // Compile aside first: the active table must stay valid until the swap
+            CompiledTheme next = compileTheme(theme);
+            if (currentActiveTheme() == &compiled) {
+                setTheme(&builtinTheme);
+            }
+            compiled = std::move(next);
+            setTheme(&compiled);
+        }
+    };
+
+    // Per UI context, defined in sv_ui3.0.h
+    Styles& currentStyles();
+}
@@ -0,0 +1,1044 @@
+#pragma once
+
+//////////////////////////////////////////////////////////
+////////////SV UI TEXT EDITING////////////////////////////
+//////////////////////////////////////////////////////////
+// An editable, optionally multi-line text box with caret, selection, clipboard
+// and IME input, meant to stay responsive on documents of several megabytes.
+//
+//     auto* notes = SV_UI::TextEdit("", 400, 300);
+//     notes->setText(contentsOfConfigFile);
+//     notes->onChange = [&] { dirty = true; };
+//     std::string saved = notes->getText();
+//
+// The text lives in a gap buffer: typing at one spot appends into the gap and
+// only moving the edit point elsewhere copies bytes. The newline positions are
+// split at the same point (see LineIndex), so a keystroke updates them in
+// constant time. Only lines on screen are turned into glyphs, one GLTtext per
+// visible row holding the part of the line near the view; an edit re-sets the
+// rows from the edited line down, or just that line when no newline was typed
+// or deleted. Widths come from per-byte glyph advances measured once, and the
+// caret's line keeps its prefix widths (see LineWidths), so placing the caret
+// or hit-testing a click on it is a lookup. Positions are byte offsets into
+// UTF-8 text and the caret moves by code point.
+
+#include "sv_ui3.0.h"
+#include <cstring>
+
+namespace SV_UI {
+
+    // Text with a hole at the last edit position
+    struct GapBuffer {
+        std::vector<char> data;
+        size_t gapStart = 0, gapEnd = 0;
+
+        size_t size() const {
+            return data.size() - (gapEnd - gapStart);
+        }
+
+        char at(size_t pos) const {
+            return pos < gapStart ? data[pos] : data[pos + (gapEnd - gapStart)];
+        }
+
+        void assign(const char* text, size_t length) {
+            data.assign(text, text + length);
+            data.resize(length + 64);
+            gapStart = length;
+            gapEnd = data.size();
+        }
+
+        // Costs a move of the bytes between the old and the new position
+        void moveGap(size_t pos) {
+            if (pos < gapStart) {
+                size_t count = gapStart - pos;
+                std::memmove(data.data() + gapEnd - count, data.data() + pos, count);
+                gapStart -= count;
+                gapEnd -= count;
+            }
+            else if (pos > gapStart) {
+                size_t count = pos - gapStart;
+                std::memmove(data.data() + gapStart, data.data() + gapEnd, count);
+                gapStart += count;
+                gapEnd += count;
+            }
+        }
+
+        // Grow by half the size at least, so typing is amortized O(1)
+        void reserveGap(size_t length) {
+            size_t gap = gapEnd - gapStart;
+            if (gap >= length) {
+                return;
+            }
+            size_t grow = std::max(length - gap, data.size() / 2 + 64);
+            size_t tail = data.size() - gapEnd;
+            data.resize(data.size() + grow);
+            std::memmove(data.data() + data.size() - tail, data.data() + gapEnd, tail);
+            gapEnd = data.size() - tail;
+        }
+
+        void insert(size_t pos, const char* text, size_t length) {
+            moveGap(pos);
+            reserveGap(length);
+            std::memcpy(data.data() + gapStart, text, length);
+            gapStart += length;
+        }
+
+        void erase(size_t pos, size_t length) {
+            moveGap(pos);
+            gapEnd += length;
+        }
+
+        void copy(size_t pos, size_t length, std::string& out) const {
+            out.clear();
+            out.reserve(length);
+            size_t end = pos + length;
+            if (pos < gapStart) {
+                size_t before = std::min(end, gapStart) - pos;
+                out.append(data.data() + pos, before);
+                pos += before;
+            }
+            if (pos < end) {
+                out.append(data.data() + pos + (gapEnd - gapStart), end - pos);
+            }
+        }
+    };
+
+    // Newline positions, split at the edit point like the text. Newlines before it are
+    // stored as positions, newlines after it as distances from the end of the text, which
+    // edits before them leave unchanged. An edit touches only the newlines it inserts or
+    // removes, plus those between the old and new edit point.
+    struct LineIndex {
+        std::vector<size_t> before; // Ascending positions
+        std::vector<size_t> after;  // Ascending distances from the end; back() is nearest the edit point
+        size_t textSize = 0;
+
+        void build(const GapBuffer& text) {
+            before.clear();
+            after.clear();
+            textSize = text.size();
+            for (size_t pos = 0; pos < textSize; ++pos) {
+                if (text.at(pos) == '\n') {
+                    before.push_back(pos);
+                }
+            }
+        }
+
+        size_t lineCount() const {
+            return before.size() + after.size() + 1;
+        }
+
+        // Position of the k-th newline
+        size_t newline(size_t k) const {
+            return k < before.size() ? before[k] : textSize - after[after.size() - 1 - (k - before.size())];
+        }
+
+        size_t lineStart(size_t line) const {
+            return line == 0 ? 0 : newline(line - 1) + 1;
+        }
+
+        // Position of the line's newline, or the end of the text for the last line
+        size_t lineEnd(size_t line) const {
+            return line + 1 < lineCount() ? newline(line) : textSize;
+        }
+
+        // Line containing pos: the number of newlines before it
+        size_t lineOf(size_t pos) const {
+            if (!before.empty() && pos <= before.back()) {
+                return std::lower_bound(before.begin(), before.end(), pos) - before.begin();
+            }
+            size_t distance = pos <= textSize ? textSize - pos : 0;
+            return before.size() + (after.end() - std::upper_bound(after.begin(), after.end(), distance));
+        }
+
+        void moveTo(size_t pos) {
+            while (!before.empty() && before.back() >= pos) {
+                after.push_back(textSize - before.back());
+                before.pop_back();
+            }
+            while (!after.empty() && textSize - after.back() < pos) {
+                before.push_back(textSize - after.back());
+                after.pop_back();
+            }
+        }
+
+        void insert(size_t pos, const char* text, size_t length) {
+            moveTo(pos);
+            for (size_t i = 0; i < length; ++i) {
+                if (text[i] == '\n') {
+                    before.push_back(pos + i);
+                }
+            }
+            textSize += length;
+        }
+
+        void erase(size_t pos, size_t length) {
+            moveTo(pos);
+            while (!after.empty() && textSize - after.back() < pos + length) {
+                after.pop_back();
+            }
+            textSize -= length;
+        }
+    };
+
+    const size_t NO_LINE = static_cast<size_t>(-1);
+
+    // Prefix widths of one line, in font units, split at the edit point like LineIndex.
+    // before[i] is the width of the line's first i bytes, for positions up to the split;
+    // after[d] is the width from the position d bytes before the line end to the end, for
+    // positions from the split on, which edits at the split leave unchanged. Typing into
+    // the line pushes and pops at the split; moving the split costs the distance moved.
+    // Widths are sums of per-byte advances (glText lays glyphs out side by side).
+    struct LineWidths {
+        size_t line = NO_LINE; // NO_LINE while nothing is cached
+        size_t start = 0, split = 0; // Positions in the text
+        std::vector<uint32_t> before; // split - start + 1 entries
+        std::vector<uint32_t> after;  // end() - split + 1 entries
+
+        size_t end() const {
+            return split + after.size() - 1;
+        }
+
+        uint32_t total() const {
+            return before.back() + after.back();
+        }
+
+        // Width of the line up to pos, which must lie in [start, end()]
+        uint32_t widthTo(size_t pos) const {
+            return pos <= split ? before[pos - start] : total() - after[end() - pos];
+        }
+
+        void build(size_t line, size_t lineStart, size_t lineEnd, const GapBuffer& text, const uint32_t* advances) {
+            this->line = line;
+            start = lineStart;
+            split = lineEnd;
+            before.assign(1, 0);
+            before.reserve(lineEnd - lineStart + 1);
+            for (size_t pos = lineStart; pos < lineEnd; ++pos) {
+                before.push_back(before.back() + advances[static_cast<unsigned char>(text.at(pos))]);
+            }
+            after.assign(1, 0);
+        }
+
+        // text must still hold the bytes between the old and the new split
+        void moveSplit(size_t pos, const GapBuffer& text, const uint32_t* advances) {
+            while (split > pos) {
+                after.push_back(after.back() + advances[static_cast<unsigned char>(text.at(split - 1))]);
+                before.pop_back();
+                --split;
+            }
+            while (split < pos) {
+                uint32_t advance = advances[static_cast<unsigned char>(text.at(split))];
+                after.pop_back();
+                before.push_back(before.back() + advance);
+                ++split;
+            }
+        }
+
+        // Edits inside the line, at pos; they must not add or remove a newline
+        void erase(size_t pos, size_t length, const GapBuffer& text, const uint32_t* advances) {
+            moveSplit(pos, text, advances);
+            after.resize(after.size() - length);
+        }
+
+        void insert(size_t pos, const char* bytes, size_t length, const GapBuffer& text, const uint32_t* advances) {
+            moveSplit(pos, text, advances);
+            for (size_t i = 0; i < length; ++i) {
+                before.push_back(before.back() + advances[static_cast<unsigned char>(bytes[i])]);
+            }
+            split += length;
+        }
+    };
+
+    struct TextEditComponent : public UIComponent {
+        GapBuffer buffer;
+        LineIndex lines;
+        bool multiline = true; // Single-line boxes turn newlines in typed and pasted text into spaces
+        float fontSize = 1.5f;
+        float padding = 4.0f;
+        std::function<void()> onChange; // After every edit, on the UI thread
+
+        size_t caret = 0, anchor = 0; // Byte positions; the selection lies between them
+        float preferredX = -1.0f; // Kept while moving up and down through shorter lines, -1 when unset
+        bool hasFocus = false;
+        bool textInputWasActive = false; // Restored when focus leaves
+        bool isSelecting = false; // Mouse button held after a press in the box
+        bool isMouseOver = false;
+        std::string composition; // IME text being composed; shown at the caret, not yet part of the text
+
+        float scrollX = 0.0f, scrollY = 0.0f;
+        float scrollStep = 60.0f; // Pixels per mouse wheel notch
+        float lineHeight = 0.0f; // From glText, set by update()
+
+        // Ring of text objects, line i uses slot i % size, as in ListBoxComponent. A slot holds
+        // glyphs for the part of its line around the view, and keeps them until its line is
+        // edited, another line takes the slot, or the view scrolls past that part. update() copies
+        // the spans; syncGL() creates the texts and turns the stale spans into glyphs.
+        std::vector<GLTtext*> lineTexts;
+        size_t lineSlots = 0;
+        std::vector<size_t> lineForSlot;
+        std::vector<float> lineWidthForSlot; // The whole line
+        std::vector<size_t> spanStartForSlot, spanEndForSlot; // Offsets in the line of the part with glyphs
+        std::vector<float> spanXForSlot, spanEndXForSlot; // Its x range, relative to the line start
+        std::vector<std::string> spanTextForSlot;
+        std::vector<size_t> staleSlots;
+        LineWidths caretLineWidths; // Of the caret's line; edits keep it current
+        GLTtext* compositionText = nullptr;
+        bool compositionStale = false; // composition changed since syncGL() last set its glyphs
+        size_t trackedBytes = 0;
+
+        // Derived by update() for record(), which may run on another thread
+        bool geometryDirty = true; // Caret, selection or scroll moved since the last update()
+        size_t firstLine = 0, lastLine = NO_LINE; // Visible lines
+        float caretX = 0.0f, caretY = 0.0f; // Relative to the text origin
+        float compositionWidth = 0.0f;
+        std::vector<float> selectionStartX, selectionEndX; // Per visible line, empty range when unselected
+
+        TextEditComponent(const std::string& text, int width = 200, int height = 100, bool multiline = true, float fontSize = 1.5f)
+            : multiline(multiline), fontSize(fontSize) {
+            this->width = width;
+            this->height = height;
+            styleType = StyleComponent::TextEdit;
+            setText(text);
+            countObject("TextEditComponent", 1);
+        }
+
+        ~TextEditComponent() {
+            setFocus(false);
+            for (auto text : lineTexts) {
+                gltDeleteText(text);
+            }
+            if (compositionText) {
+                gltDeleteText(compositionText);
+            }
+            untrackResource(ResourceKind::Host, resourceHandle(this));
+            countObject("TextEditComponent", -1);
+        }
+
+        //////// Text ////////
+
+        size_t textSize() const {
+            return buffer.size();
+        }
+
+        std::string getText() const {
+            std::string text;
+            buffer.copy(0, buffer.size(), text);
+            return text;
+        }
+
+        std::string getText(size_t pos, size_t length) const {
+            std::string text;
+            buffer.copy(pos, length, text);
+            return text;
+        }
+
+        // Replace everything; the caret goes to the start
+        void setText(const std::string& text) {
+            std::string clean = filterInput(text.data(), text.size());
+            buffer.assign(clean.data(), clean.size());
+            lines.build(buffer);
+            caretLineWidths.line = NO_LINE;
+            caret = anchor = 0;
+            scrollX = scrollY = 0.0f;
+            invalidateLines(0);
+            textChanged();
+        }
+
+        size_t lineCount() const {
+            return lines.lineCount();
+        }
+
+        void lineText(size_t line, std::string& out) const {
+            size_t start = lines.lineStart(line);
+            buffer.copy(start, lines.lineEnd(line) - start, out);
+        }
+
+        // Replace length bytes at pos and return the length inserted; every edit goes through here
+        size_t replace(size_t pos, size_t length, const char* text, size_t textLength) {
+            size_t size = buffer.size();
+            pos = std::min(pos, size);
+            length = std::min(length, size - pos);
+            std::string clean = filterInput(text, textLength);
+            if (length == 0 && clean.empty()) {
+                return 0;
+            }
+            size_t line = lines.lineOf(pos);
+            bool newlinesChanged = lines.lineOf(pos + length) != line || clean.find('\n') != std::string::npos;
+            // Before the buffer changes, since the cached widths read the bytes they move past
+            if (newlinesChanged) {
+                caretLineWidths.line = NO_LINE;
+            }
+            else if (caretLineWidths.line == line) {
+                caretLineWidths.erase(pos, length, buffer, glyphAdvances());
+                caretLineWidths.insert(pos, clean.data(), clean.size(), buffer, glyphAdvances());
+            }
+            else if (caretLineWidths.line != NO_LINE && caretLineWidths.line > line) {
+                caretLineWidths.start += clean.size() - length;
+                caretLineWidths.split += clean.size() - length;
+            }
+            if (length) {
+                buffer.erase(pos, length);
+                lines.erase(pos, length);
+            }
+            if (!clean.empty()) {
+                buffer.insert(pos, clean.data(), clean.size());
+                lines.insert(pos, clean.data(), clean.size());
+            }
+            // Lines below shift only when a newline came or went
+            invalidateLines(line, newlinesChanged ? NO_LINE : 1);
+            auto shift = [pos, length, &clean](size_t& position) {
+                if (position >= pos + length) position += clean.size() - length;
+                else if (position > pos) position = pos;
+            };
+            shift(caret);
+            shift(anchor);
+            textChanged();
+            return clean.size();
+        }
+
+        // Typing and pasting: replaces the selection and leaves the caret after the new text
+        void insertAtCaret(const char* text, size_t length) {
+            size_t start = selectionStart();
+            caret = anchor = start + replace(start, selectionEnd() - start, text, length);
+            preferredX = -1.0f;
+            caretMoved();
+        }
+
+        //////// Caret and selection ////////
+
+        size_t selectionStart() const {
+            return std::min(caret, anchor);
+        }
+
+        size_t selectionEnd() const {
+            return std::max(caret, anchor);
+        }
+
+        bool hasSelection() const {
+            return caret != anchor;
+        }
+
+        std::string selectedText() const {
+            return getText(selectionStart(), selectionEnd() - selectionStart());
+        }
+
+        void select(size_t start, size_t end) {
+            anchor = clampToCodePoint(start);
+            caret = clampToCodePoint(end);
+            preferredX = -1.0f;
+            caretMoved();
+        }
+
+        void selectAll() {
+            select(0, buffer.size());
+        }
+
+        // Move the caret; with extend the anchor stays and the selection grows or shrinks
+        void moveCaret(size_t pos, bool extend) {
+            caret = clampToCodePoint(pos);
+            if (!extend) {
+                anchor = caret;
+            }
+            caretMoved();
+        }
+
+        bool isContinuationByte(size_t pos) const {
+            return pos < buffer.size() && (static_cast<unsigned char>(buffer.at(pos)) & 0xC0) == 0x80;
+        }
+
+        size_t clampToCodePoint(size_t pos) const {
+            pos = std::min(pos, buffer.size());
+            while (pos > 0 && isContinuationByte(pos)) {
+                --pos;
+            }
+            return pos;
+        }
+
+        size_t nextCodePoint(size_t pos) const {
+            if (pos >= buffer.size()) {
+                return buffer.size();
+            }
+            ++pos;
+            while (isContinuationByte(pos)) {
+                ++pos;
+            }
+            return pos;
+        }
+
+        size_t previousCodePoint(size_t pos) const {
+            if (pos == 0) {
+                return 0;
+            }
+            --pos;
+            while (pos > 0 && isContinuationByte(pos)) {
+                --pos;
+            }
+            return pos;
+        }
+
+        //////// Focus ////////
+
+        // Focus turns on SDL text input, so typed characters and IME composition arrive
+        void setFocus(bool focus) {
+            if (focus == hasFocus) {
+                return;
+            }
+            hasFocus = focus;
+            if (focus) {
+                textInputWasActive = SDL_IsTextInputActive();
+                SDL_StartTextInput();
+            }
+            else {
+                composition.clear();
+                isSelecting = false;
+                if (!textInputWasActive) {
+                    SDL_StopTextInput();
+                }
+            }
+            caretMoved();
+        }
+
+        //////// Clipboard ////////
+
+        void copy() {
+            if (hasSelection()) {
+                SDL_SetClipboardText(selectedText().c_str());
+            }
+        }
+
+        void cut() {
+            if (hasSelection()) {
+                copy();
+                insertAtCaret("", 0);
+            }
+        }
+
+        void paste() {
+            char* text = SDL_GetClipboardText();
+            if (text) {
+                insertAtCaret(text, std::strlen(text));
+                SDL_free(text);
+            }
+        }
+
+        //////// Layout helpers ////////
+
+        float innerWidth() const {
+            return width - 2.0f * padding;
+        }
+
+        float innerHeight() const {
+            return height - 2.0f * padding;
+        }
+
+        // Width of the text between two positions on one line, in font units
+        uint32_t widthBetween(size_t from, size_t to) {
+            const uint32_t* advance = glyphAdvances();
+            uint32_t width = 0;
+            for (size_t pos = from; pos < to; ++pos) {
+                width += advance[static_cast<unsigned char>(buffer.at(pos))];
+            }
+            return width;
+        }
+
+        // Width of line up to pos in font units: a lookup on the caret's line, a sum elsewhere
+        uint32_t prefixWidth(size_t line, size_t pos) {
+            if (line == caretLineWidths.line) {
+                return caretLineWidths.widthTo(pos);
+            }
+            return widthBetween(lines.lineStart(line), pos);
+        }
+
+        // Cache the prefix widths of the caret's line, once per line the caret moves to
+        void trackCaretLine() {
+            size_t line = lines.lineOf(caret);
+            if (caretLineWidths.line != line) {
+                caretLineWidths.build(line, lines.lineStart(line), lines.lineEnd(line), buffer, glyphAdvances());
+            }
+        }
+
+        // x of a position inside its line, relative to the line start
+        float positionX(size_t pos) {
+            return prefixWidth(lines.lineOf(pos), pos) * fontSize;
+        }
+
+        // Last position in line whose x is at most targetX; width receives its prefix width.
+        // Bisects the cached widths on the caret's line, walks the line elsewhere.
+        size_t positionBeforeX(size_t line, float targetX, uint32_t& width) {
+            size_t start = lines.lineStart(line), end = lines.lineEnd(line);
+            float target = targetX / fontSize;
+            if (line == caretLineWidths.line) {
+                size_t low = start, high = end;
+                while (low < high) {
+                    size_t mid = low + (high - low + 1) / 2;
+                    if (caretLineWidths.widthTo(mid) <= target) {
+                        low = mid;
+                    }
+                    else {
+                        high = mid - 1;
+                    }
+                }
+                low = clampToCodePoint(low);
+                width = caretLineWidths.widthTo(low);
+                return low;
+            }
+            size_t pos = start;
+            width = 0;
+            while (pos < end) {
+                size_t next = nextCodePoint(pos);
+                uint32_t nextWidth = width + widthBetween(pos, next);
+                if (nextWidth > target) {
+                    break;
+                }
+                pos = next;
+                width = nextWidth;
+            }
+            return pos;
+        }
+
+        // Position in line nearest to x
+        size_t positionAtX(size_t line, float targetX) {
+            uint32_t width = 0;
+            size_t pos = positionBeforeX(line, targetX, width);
+            // Snap to whichever side of the character under targetX is closer
+            if (pos < lines.lineEnd(line)) {
+                size_t next = nextCodePoint(pos);
+                float left = width * fontSize, right = (width + widthBetween(pos, next)) * fontSize;
+                if (targetX - left > right - targetX) {
+                    pos = next;
+                }
+            }
+            return pos;
+        }
+
+        size_t lineAtY(float localY) const {
+            if (localY <= 0.0f || lineHeight <= 0.0f) {
+                return 0;
+            }
+            size_t line = static_cast<size_t>(localY / lineHeight);
+            return std::min(line, lines.lineCount() - 1);
+        }
+
+        // Text position under a point in screen space
+        size_t positionAt(int mouseX, int mouseY) {
+            size_t line = lineAtY(mouseY - (y + padding) + scrollY);
+            return positionAtX(line, mouseX - (x + padding) + scrollX);
+        }
+
+        size_t visibleLineCount() const {
+            return lineHeight > 0.0f ? std::max<size_t>(1, static_cast<size_t>(innerHeight() / lineHeight)) : 1;
+        }
+
+        // Vertical caret movement by count lines, keeping the column in pixels
+        void moveLines(long count, bool extend) {
+            size_t line = lines.lineOf(caret);
+            if (preferredX < 0.0f) {
+                preferredX = positionX(caret);
+            }
+            long target = static_cast<long>(line) + count;
+            float keepX = preferredX;
+            if (target < 0) {
+                moveCaret(0, extend);
+            }
+            else if (target >= static_cast<long>(lines.lineCount())) {
+                moveCaret(buffer.size(), extend);
+            }
+            else {
+                moveCaret(positionAtX(static_cast<size_t>(target), keepX), extend);
+            }
+            preferredX = keepX;
+        }
+
+        //////// Per frame ////////
+
+        virtual void Draw() override {
+            drawRecorded(*this);
+        }
+
+        virtual void update(float dt) override {
+            lineHeight = gltGetLineHeight(fontSize);
+            if (geometryDirty) {
+                updateCaretGeometry();
+            }
+            size_t count = lines.lineCount();
+            size_t previousFirst = firstLine, previousLast = lastLine;
+            firstLine = std::min(static_cast<size_t>(scrollY / lineHeight), count - 1);
+            lastLine = std::min(static_cast<size_t>((scrollY + innerHeight()) / lineHeight), count - 1);
+            prepareLines(firstLine, lastLine);
+            if (!staleSlots.empty() || compositionStale) {
+                requestGLSync(*this);
+            }
+            // Selection extents move only with the caret, the selection, an edit or the visible lines
+            if (geometryDirty || firstLine != previousFirst || lastLine != previousLast) {
+                updateSelectionGeometry();
+            }
+            geometryDirty = false;
+            if (buffer.data.size() != trackedBytes) {
+                trackedBytes = buffer.data.size();
+                trackResource(ResourceKind::Host, resourceHandle(this), trackedBytes, "TextEdit", "", parent ? parent->ID : -1);
+            }
+        }
+
+        virtual void record(DrawList& list) override {
+            const ResolvedStyle& box = style(hasFocus ? StyleState::Selected : StyleState::Normal);
+            float b = box.borderWidth;
+            list.addRoundedRect(x - b, y - b, width + 2.0f * b, height + 2.0f * b, box.background, box.cornerRadius, b, box.border);
+            list.pushClip(x, y, static_cast<float>(width), static_cast<float>(height));
+            float originX = x + padding - scrollX, originY = y + padding - scrollY;
+
+            if (lastLine != NO_LINE && lineTexts.size() == lineSlots && lineSlots >= lastLine - firstLine + 1) {
+                for (size_t line = firstLine; line <= lastLine; ++line) {
+                    size_t row = line - firstLine;
+                    if (row < selectionEndX.size() && selectionEndX[row] > selectionStartX[row]) {
+                        list.addRect(originX + selectionStartX[row], originY + line * lineHeight,
+                            selectionEndX[row] - selectionStartX[row], lineHeight, box.accent);
+                    }
+                }
+                // Texts after all quads, so the submit enters glText's state once
+                size_t slots = lineSlots;
+                for (size_t line = firstLine; line <= lastLine; ++line) {
+                    list.addText(lineTexts[line % slots], originX + spanXForSlot[line % slots], originY + line * lineHeight, fontSize, box.text);
+                }
+            }
+
+            if (hasFocus) {
+                float caretScreenX = originX + caretX;
+                if (!composition.empty() && compositionText) {
+                    list.addRect(caretScreenX, originY + caretY + lineHeight - 2.0f, compositionWidth, 1.0f, box.text); // Underline marks uncommitted text
+                    list.addText(compositionText, caretScreenX, originY + caretY, fontSize, box.text);
+                    caretScreenX += compositionWidth;
+                }
+                list.addRect(caretScreenX, originY + caretY, 1.5f, lineHeight, box.text);
+            }
+            list.popClip();
+        }
+
+        //////// Events ////////
+
+        virtual void handleEvents(SDL_Event* event) override {
+            switch (event->type) {
+            case SDL_MOUSEBUTTONDOWN:
+                if (event->button.button != SDL_BUTTON_LEFT) {
+                    break;
+                }
+                // Delivered wherever it lands while focused (see wantsEveryPress()), so a press
+                // anywhere else takes the focus away even when the box is clipped or hidden
+                isMouseOver = pointerOver(*this, event->button.x, event->button.y);
+                if (!isMouseOver) {
+                    setFocus(false);
+                    break;
+                }
+                setFocus(true);
+                {
+                    bool extend = (SDL_GetModState() & KMOD_SHIFT) != 0;
+                    moveCaret(positionAt(event->button.x, event->button.y), extend);
+                }
+                preferredX = -1.0f;
+                isSelecting = true;
+                break;
+            case SDL_MOUSEBUTTONUP:
+                if (event->button.button == SDL_BUTTON_LEFT) {
+                    isSelecting = false;
+                }
+                break;
+            case SDL_MOUSEMOTION:
+                isMouseOver = contains(event->motion.x, event->motion.y);
+                if (isSelecting) {
+                    moveCaret(positionAt(event->motion.x, event->motion.y), true);
+                    preferredX = -1.0f;
+                }
+                break;
+            case SDL_MOUSEWHEEL:
+                if (isMouseOver) {
+                    scrollBy(-event->wheel.y * scrollStep);
+                }
+                break;
+            case SDL_TEXTINPUT:
+                if (hasFocus) {
+                    composition.clear();
+                    insertAtCaret(event->text.text, std::strlen(event->text.text));
+                }
+                break;
+            case SDL_TEXTEDITING:
+                if (hasFocus) {
+                    composition = event->edit.text;
+                    geometryDirty = true;
+                    requestRedraw();
+                }
+                break;
+            case SDL_KEYDOWN:
+                if (hasFocus) {
+                    handleKey(event->key.keysym);
+                }
+                break;
+            }
+        }
+
+        void handleKey(const SDL_Keysym& key) {
+            bool shift = (key.mod & KMOD_SHIFT) != 0;
+            bool ctrl = (key.mod & (KMOD_CTRL | KMOD_GUI)) != 0; // GUI is Cmd on macOS
+            if (!composition.empty()) {
+                return; // The IME owns the keys while composing
+            }
+            switch (key.sym) {
+            case SDLK_LEFT:
+                if (hasSelection() && !shift) {
+                    moveCaret(selectionStart(), false);
+                }
+                else {
+                    moveCaret(previousCodePoint(caret), shift);
+                }
+                preferredX = -1.0f;
+                break;
+            case SDLK_RIGHT:
+                if (hasSelection() && !shift) {
+                    moveCaret(selectionEnd(), false);
+                }
+                else {
+                    moveCaret(nextCodePoint(caret), shift);
+                }
+                preferredX = -1.0f;
+                break;
+            case SDLK_UP:
+                moveLines(-1, shift);
+                break;
+            case SDLK_DOWN:
+                moveLines(1, shift);
+                break;
+            case SDLK_PAGEUP:
+                moveLines(-static_cast<long>(visibleLineCount()), shift);
+                break;
+            case SDLK_PAGEDOWN:
+                moveLines(static_cast<long>(visibleLineCount()), shift);
+                break;
+            case SDLK_HOME:
+                moveCaret(ctrl ? 0 : lines.lineStart(lines.lineOf(caret)), shift);
+                preferredX = -1.0f;
+                break;
+            case SDLK_END:
+                moveCaret(ctrl ? buffer.size() : lines.lineEnd(lines.lineOf(caret)), shift);
+                preferredX = -1.0f;
+                break;
+            case SDLK_BACKSPACE:
+                if (!hasSelection()) {
+                    anchor = previousCodePoint(caret);
+                }
+                insertAtCaret("", 0);
+                break;
+            case SDLK_DELETE:
+                if (!hasSelection()) {
+                    anchor = nextCodePoint(caret);
+                }
+                insertAtCaret("", 0);
+                break;
+            case SDLK_RETURN:
+                if (multiline) {
+                    insertAtCaret("\n", 1);
+                }
+                break;
+            case SDLK_a:
+                if (ctrl) selectAll();
+                break;
+            case SDLK_c:
+                if (ctrl) copy();
+                break;
+            case SDLK_x:
+                if (ctrl) cut();
+                break;
+            case SDLK_v:
+                if (ctrl) paste();
+                break;
+            }
+        }
+
+        virtual bool wantsEveryPress() const override {
+            return hasFocus;
+        }
+
+        bool contains(int mouseX, int mouseY) const {
+            return mouseX >= x && mouseX < x + width && mouseY >= y && mouseY < y + height;
+        }
+
+        void scrollBy(float delta) {
+            float limit = std::max(0.0f, lines.lineCount() * lineHeight - innerHeight());
+            float target = std::min(std::max(scrollY + delta, 0.0f), limit);
+            if (target != scrollY) {
+                scrollY = target;
+                requestRedraw();
+            }
+        }
+
+        //////// Internals ////////
+
+        // Single-line boxes take newlines as spaces; carriage returns are dropped everywhere
+        std::string filterInput(const char* text, size_t length) const {
+            std::string clean;
+            clean.reserve(length);
+            for (size_t i = 0; i < length; ++i) {
+                if (text[i] == '\r') {
+                    continue;
+                }
+                clean.push_back(text[i] == '\n' && !multiline ? ' ' : text[i]);
+            }
+            return clean;
+        }
+
+        // Drop cached glyphs of count lines from first (NO_LINE: to the end)
+        void invalidateLines(size_t first, size_t count = NO_LINE) {
+            for (size_t& line : lineForSlot) {
+                if (line != NO_LINE && line >= first && (count == NO_LINE || line < first + count)) {
+                    line = NO_LINE;
+                }
+            }
+        }
+
+        void textChanged() {
+            geometryDirty = true;
+            requestRedraw();
+            if (onChange) {
+                onChange();
+            }
+        }
+
+        void caretMoved() {
+            geometryDirty = true;
+            requestRedraw();
+        }
+
+        // Grow the ring to cover the visible lines, and set glyphs for lines new to their slot or
+        // scrolled past the part that has them. Glyphs cover the view and half a view on either
+        // side, so a long line costs only what is near the view, and small scrolls keep them.
+        void prepareLines(size_t first, size_t last) {
+            size_t visible = last - first + 1;
+            if (lineSlots < visible) {
+                lineSlots = visible;
+                size_t slots = lineSlots;
+                lineForSlot.assign(slots, NO_LINE); // The modulus changed, so every slot is stale
+                lineWidthForSlot.assign(slots, 0.0f);
+                spanStartForSlot.assign(slots, 0);
+                spanEndForSlot.assign(slots, 0);
+                spanXForSlot.assign(slots, 0.0f);
+                spanEndXForSlot.assign(slots, 0.0f);
+                spanTextForSlot.resize(slots);
+                staleSlots.clear();
+                requestRedraw(); // A pipelined frame is recorded before syncGL() adds the texts
+            }
+            float viewLeft = scrollX, viewRight = scrollX + innerWidth();
+            for (size_t line = first; line <= last; ++line) {
+                size_t slot = line % lineSlots;
+                bool current = lineForSlot[slot] == line &&
+                    (spanXForSlot[slot] <= viewLeft || spanStartForSlot[slot] == 0) &&
+                    (spanEndXForSlot[slot] >= viewRight || spanEndForSlot[slot] == lines.lineEnd(line) - lines.lineStart(line));
+                if (!current) {
+                    setLineSpan(slot, line, viewLeft - 0.5f * innerWidth(), viewRight + 0.5f * innerWidth());
+                }
+            }
+        }
+
+        void setLineSpan(size_t slot, size_t line, float left, float right) {
+            size_t end = lines.lineEnd(line);
+            uint32_t startWidth = 0, endWidth = 0;
+            size_t spanStart = positionBeforeX(line, left, startWidth);
+            size_t spanEnd = positionBeforeX(line, right, endWidth);
+            if (spanEnd < end) {
+                size_t next = nextCodePoint(spanEnd); // Include the glyph that crosses right
+                endWidth += widthBetween(spanEnd, next);
+                spanEnd = next;
+            }
+            lineForSlot[slot] = line;
+            lineWidthForSlot[slot] = prefixWidth(line, end) * fontSize;
+            spanStartForSlot[slot] = spanStart - lines.lineStart(line);
+            spanEndForSlot[slot] = spanEnd - lines.lineStart(line);
+            spanXForSlot[slot] = startWidth * fontSize;
+            spanEndXForSlot[slot] = endWidth * fontSize;
+            buffer.copy(spanStart, spanEnd - spanStart, spanTextForSlot[slot]);
+            staleSlots.push_back(slot);
+        }
+
+        virtual void syncGL() override {
+            while (lineTexts.size() < lineSlots) {
+                lineTexts.push_back(gltCreateText());
+            }
+            for (size_t slot : staleSlots) {
+                setGLText(lineTexts[slot], spanTextForSlot[slot].c_str());
+            }
+            staleSlots.clear();
+            if (compositionStale) {
+                if (!compositionText) {
+                    compositionText = gltCreateText();
+                }
+                setGLText(compositionText, composition.c_str());
+                compositionStale = false;
+            }
+        }
+
+        // Caret position, IME placement, and scrolling to keep the caret in view
+        void updateCaretGeometry() {
+            trackCaretLine();
+            size_t line = lines.lineOf(caret);
+            caretX = positionX(caret);
+            caretY = line * lineHeight;
+            compositionWidth = 0.0f;
+            if (!composition.empty()) {
+                compositionWidth = textWidth(composition, fontSize);
+                compositionStale = true;
+                if (!compositionText) {
+                    requestRedraw(); // A pipelined frame is recorded before syncGL() creates it
+                }
+            }
+            if (caretY < scrollY) {
+                scrollY = caretY;
+            }
+            else if (caretY + lineHeight > scrollY + innerHeight()) {
+                scrollY = caretY + lineHeight - innerHeight();
+            }
+            float caretRight = caretX + compositionWidth;
+            if (caretX < scrollX) {
+                scrollX = caretX;
+            }
+            else if (caretRight + 2.0f > scrollX + innerWidth()) {
+                scrollX = caretRight + 2.0f - innerWidth();
+            }
+            if (hasFocus) {
+                SDL_Rect rect;
+                rect.x = static_cast<int>(x + padding + caretX - scrollX);
+                rect.y = static_cast<int>(y + padding + caretY - scrollY);
+                rect.w = 1;
+                rect.h = static_cast<int>(lineHeight);
+                SDL_SetTextInputRect(&rect); // The IME candidate window opens next to the caret
+            }
+        }
+
+        // Selection extent on each visible line; whole lines reuse their cached width
+        void updateSelectionGeometry() {
+            size_t visible = lastLine - firstLine + 1;
+            selectionStartX.assign(visible, 0.0f);
+            selectionEndX.assign(visible, 0.0f);
+            if (!hasSelection()) {
+                return;
+            }
+            size_t start = selectionStart(), end = selectionEnd();
+            size_t startLine = lines.lineOf(start), endLine = lines.lineOf(end);
+            if (endLine < firstLine || startLine > lastLine) {
+                return;
+            }
+            float newlineWidth = glyphAdvances()[' '] * fontSize; // Selected line breaks show as a space
+            for (size_t line = std::max(startLine, firstLine); line <= std::min(endLine, lastLine); ++line) {
+                size_t row = line - firstLine;
+                float lineWidth = lineWidthForSlot[line % lineSlots];
+                selectionStartX[row] = line == startLine ? positionX(start) : 0.0f;
+                selectionEndX[row] = line == endLine ? positionX(end) : lineWidth + newlineWidth;
+            }
+        }
+    };
+
+    TextEditComponent* TextEdit(const std::string& text, int width = 200, int height = 100, bool multiline = true, float fontSize = 1.5f) {
+        if (!currentUIManager().currentWidget) {
+            std::cerr << "No widget selected" << std::endl;
+            return nullptr;
+        }
+        auto edit = new TextEditComponent(text, width, height, multiline, fontSize);
+        addComponent(edit);
+        return edit;
+    }
+}
@@ -0,0 +1,304 @@
+#pragma once
+
+//////////////////////////////////////////////////////////
+////////////SV UI COOKED TEXTURES/////////////////////////
+//////////////////////////////////////////////////////////
+// UI images are decoded once and "cooked" into a raw file: RGBA8 in GL's byte
+// order, with the whole mip chain, behind a small header. Later loads map the
+// cooked file and hand each level straight to glTexImage2D, with no PNG decode
+// and no SDL_Surface copies. Converting through SDL_PIXELFORMAT_RGBA32 while
+// cooking also fixes images whose channel order is not RGB(A) (BGR, palettes).
+//
+// Cooked files live in textureCacheDirectory and remember the source's size,
+// modification time and content hash. A changed timestamp with identical
+// content only refreshes the stamps; changed content re-cooks. Shipping the
+// cache without the sources also works: a cooked file whose source is missing
+// is used as is.
+//
+//     SV_UI::TextureInfo panel = SV_UI::loadUITexture("metalPanel_green.png");
+//     if (panel.texture) { ... panel.width, panel.height, panel.opaque ... }
+//     SV_UI::releaseUITexture(panel.texture); // Not glDeleteTextures, so the accounting sees it
+//
+// Clear textureCacheDirectory to cook in memory only (nothing is written).
+
+#include <GL/glew.h>
+#include <SDL.h>
+#include <SDL_image.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include "sv_ui_memory.h"
+#include "sv_ui_utilities.h"
+
+namespace SV_UI {
+
+    std::string textureCacheDirectory = "texture_cache";
+
+    const uint32_t COOKED_TEXTURE_MAGIC = 0x58545653; // "SVTX"
+    const uint32_t COOKED_TEXTURE_VERSION = 1;
+    const uint32_t MAX_TEXTURE_LEVELS = 16;
+    const uint32_t COOKED_TEXTURE_OPAQUE = 1; // Every pixel has alpha 255
+
+    struct CookedTextureHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t width, height;
+        uint32_t levels;
+        uint32_t flags;
+        uint64_t sourceSize;
+        int64_t sourceTime;  // last_write_time of the source, in the file clock's ticks
+        uint64_t sourceHash; // FNV-1a of the source file's bytes
+        uint32_t levelOffset[MAX_TEXTURE_LEVELS]; // From the start of the file; levels are tightly packed RGBA8
+    };
+
+    struct TextureInfo {
+        GLuint texture = 0; // 0 when loading failed; the caller owns it otherwise
+        int width = 0, height = 0;
+        bool opaque = false;
+    };
+
+    struct TextureSourceStamp {
+        bool exists = false;
+        uint64_t size = 0;
+        int64_t time = 0;
+    };
+
+    TextureSourceStamp stampTextureSource(const std::string& path) {
+        TextureSourceStamp stamp;
+        std::error_code error;
+        uint64_t size = std::filesystem::file_size(path, error);
+        if (error) {
+            return stamp;
+        }
+        auto time = std::filesystem::last_write_time(path, error);
+        if (error) {
+            return stamp;
+        }
+        stamp.exists = true;
+        stamp.size = size;
+        stamp.time = static_cast<int64_t>(time.time_since_epoch().count());
+        return stamp;
+    }
+
+    uint64_t hashTextureSource(const std::string& path) {
+        uint64_t hash = 14695981039346656037ull;
+        std::ifstream in(path, std::ios::binary);
+        char chunk[1 << 16];
+        while (in.read(chunk, sizeof(chunk)) || in.gcount() > 0) {
+            for (std::streamsize i = 0; i < in.gcount(); ++i) {
+                hash ^= static_cast<unsigned char>(chunk[i]);
+                hash *= 1099511628211ull;
+            }
+        }
+        return hash;
+    }
+
+    std::string cookedTexturePath(const std::string& sourcePath) {
+        uint64_t hash = 14695981039346656037ull;
+        for (char c : sourcePath) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ull;
+        }
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.svtx", static_cast<unsigned long long>(hash));
+        return (std::filesystem::path(textureCacheDirectory) / name).string();
+    }
+
+    // Header checks plus bounds of every level, so uploads can read without further checks
+    bool validCookedTexture(const char* data, size_t size) {
+        if (size < sizeof(CookedTextureHeader)) {
+            return false;
+        }
+        CookedTextureHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        if (header.magic != COOKED_TEXTURE_MAGIC || header.version != COOKED_TEXTURE_VERSION ||
+            header.width == 0 || header.height == 0 || header.levels == 0 || header.levels > MAX_TEXTURE_LEVELS) {
+            return false;
+        }
+        uint64_t width = header.width, height = header.height;
+        for (uint32_t level = 0; level < header.levels; ++level) {
+            if (header.levelOffset[level] % 4 != 0 || header.levelOffset[level] + width * height * 4 > size) {
+                return false;
+            }
+            width = width > 1 ? width / 2 : 1;
+            height = height > 1 ? height / 2 : 1;
+        }
+        return true;
+    }
+
+    // Decode sourcePath and build the cooked file image in out
+    bool cookTexture(const std::string& sourcePath, const TextureSourceStamp& stamp, std::vector<char>& out) {
+        SDL_Surface* loaded = IMG_Load(sourcePath.c_str());
+        if (!loaded) {
+            std::cerr << "Failed to load texture " << sourcePath << ": " << IMG_GetError() << std::endl;
+            return false;
+        }
+        // Whatever the decoder produced (RGB, BGR, BGRA, paletted), bytes become R, G, B, A
+        SDL_Surface* surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+        SDL_FreeSurface(loaded);
+        if (!surface) {
+            std::cerr << "Failed to convert texture " << sourcePath << ": " << SDL_GetError() << std::endl;
+            return false;
+        }
+
+        CookedTextureHeader header;
+        std::memset(&header, 0, sizeof(header));
+        header.magic = COOKED_TEXTURE_MAGIC;
+        header.version = COOKED_TEXTURE_VERSION;
+        header.width = static_cast<uint32_t>(surface->w);
+        header.height = static_cast<uint32_t>(surface->h);
+        header.sourceSize = stamp.size;
+        header.sourceTime = stamp.time;
+        header.sourceHash = hashTextureSource(sourcePath);
+
+        size_t total = sizeof(header);
+        uint32_t width = header.width, height = header.height;
+        while (header.levels < MAX_TEXTURE_LEVELS) {
+            header.levelOffset[header.levels++] = static_cast<uint32_t>(total);
+            total += static_cast<size_t>(width) * height * 4;
+            if (width == 1 && height == 1) {
+                break;
+            }
+            width = width > 1 ? width / 2 : 1;
+            height = height > 1 ? height / 2 : 1;
+        }
+        out.assign(total, 0);
+
+        // Level 0 without the surface's row padding
+        uint8_t* base = reinterpret_cast<uint8_t*>(out.data());
+        uint8_t* level0 = base + header.levelOffset[0];
+        for (uint32_t row = 0; row < header.height; ++row) {
+            std::memcpy(level0 + row * header.width * 4, static_cast<const uint8_t*>(surface->pixels) + row * surface->pitch, header.width * 4);
+        }
+        SDL_FreeSurface(surface);
+
+        bool opaque = true;
+        for (size_t i = 3; i < static_cast<size_t>(header.width) * header.height * 4 && opaque; i += 4) {
+            opaque = level0[i] == 0xff;
+        }
+        header.flags = opaque ? COOKED_TEXTURE_OPAQUE : 0;
+
+        // Each level is a 2x2 box filter of the previous one; odd edges repeat the last texel
+        width = header.width;
+        height = header.height;
+        for (uint32_t level = 1; level < header.levels; ++level) {
+            const uint8_t* src = base + header.levelOffset[level - 1];
+            uint8_t* dst = base + header.levelOffset[level];
+            uint32_t nextWidth = width > 1 ? width / 2 : 1, nextHeight = height > 1 ? height / 2 : 1;
+            for (uint32_t y = 0; y < nextHeight; ++y) {
+                uint32_t y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+                for (uint32_t x = 0; x < nextWidth; ++x) {
+                    uint32_t x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+                    for (uint32_t c = 0; c < 4; ++c) {
+                        uint32_t sum = src[(y0 * width + x0) * 4 + c] + src[(y0 * width + x1) * 4 + c] +
+                            src[(y1 * width + x0) * 4 + c] + src[(y1 * width + x1) * 4 + c];
+                        dst[(y * nextWidth + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+                    }
+                }
+            }
+            width = nextWidth;
+            height = nextHeight;
+        }
+        std::memcpy(base, &header, sizeof(header));
+        return true;
+    }
+
+    void writeCookedTexture(const std::string& path, const std::vector<char>& cooked) {
+        std::error_code error;
+        std::filesystem::create_directories(textureCacheDirectory, error);
+        writeFileAtomically(path, cooked.data(), cooked.size());
+    }
+
+    // Tracked under "TextureCache" with its source path until a widget or button adopts it
+    TextureInfo uploadCookedTexture(const char* data, const std::string& source) {
+        CookedTextureHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        TextureInfo info;
+        info.width = static_cast<int>(header.width);
+        info.height = static_cast<int>(header.height);
+        info.opaque = (header.flags & COOKED_TEXTURE_OPAQUE) != 0;
+
+        glGenTextures(1, &info.texture);
+        glBindTexture(GL_TEXTURE_2D, info.texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        GLsizei width = info.width, height = info.height;
+        size_t bytes = 0;
+        for (uint32_t level = 0; level < header.levels; ++level) {
+            glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data + header.levelOffset[level]);
+            bytes += static_cast<size_t>(width) * height * 4;
+            width = width > 1 ? width / 2 : 1;
+            height = height > 1 ? height / 2 : 1;
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(header.levels - 1));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, header.levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        trackResource(ResourceKind::Texture, info.texture, bytes, "TextureCache", source);
+        return info;
+    }
+
+    // Delete a texture returned by loadUITexture() and drop it from the accounting
+    void releaseUITexture(GLuint texture) {
+        if (texture) {
+            untrackResource(ResourceKind::Texture, texture);
+            glDeleteTextures(1, &texture);
+        }
+    }
+
+    // Load a UI image as a GL texture through the cooked cache, cooking it first if needed
+    TextureInfo loadUITexture(const std::string& path) {
+        if (path.empty()) {
+            return TextureInfo();
+        }
+        TextureSourceStamp stamp = stampTextureSource(path);
+        std::vector<char> cooked;
+        if (textureCacheDirectory.empty()) {
+            if (!cookTexture(path, stamp, cooked)) {
+                return TextureInfo();
+            }
+            return uploadCookedTexture(cooked.data(), path);
+        }
+
+        std::string cachePath = cookedTexturePath(path);
+        {
+            MappedFile file;
+            if (file.open(cachePath) && validCookedTexture(file.data, file.size)) {
+                CookedTextureHeader header;
+                std::memcpy(&header, file.data, sizeof(header));
+                if (!stamp.exists || (header.sourceSize == stamp.size && header.sourceTime == stamp.time)) {
+                    return uploadCookedTexture(file.data, path);
+                }
+                // Touched but maybe not changed: compare contents before paying for a decode
+                if (header.sourceSize == stamp.size && header.sourceHash == hashTextureSource(path)) {
+                    TextureInfo info = uploadCookedTexture(file.data, path);
+                    // New stamps go through a full rewrite and rename like a fresh cook, so
+                    // another process mapping the entry never sees it change under it
+                    header.sourceTime = stamp.time;
+                    std::vector<char> restamped(file.data, file.data + file.size);
+                    std::memcpy(restamped.data(), &header, sizeof(header));
+                    file.close();
+                    writeCookedTexture(cachePath, restamped);
+                    return info;
+                }
+            }
+        }
+        if (!stamp.exists) {
+            std::cerr << "Failed to load texture " << path << ": no such file" << std::endl;
+            return TextureInfo();
+        }
+        if (!cookTexture(path, stamp, cooked)) {
+            return TextureInfo();
+        }
+        writeCookedTexture(cachePath, cooked);
+        return uploadCookedTexture(cooked.data(), path);
+    }
+}
@@ -6,6 +6,22 @@
 #define APIENTRY GLAPIENTRY
 #include <GL/glew.h>
 #include <iostream>
+#include <vector>
+#include <cstddef>
+#include <string>
+#include <fstream>
+#include <iterator>
+#include <atomic>
+#include <random>
+#include <filesystem>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 
 namespace SV_UI {
@@ -75,6 +91,115 @@ namespace SV_UI {
         BottomRight
     };
 
+    // How a widget or stack places its children
+    enum class LayoutDirection {
+        Overlay,    // Every child gets the whole content rect and is placed by its own alignment
+        Vertical,   // Children are stacked top to bottom
+        Horizontal  // Children are stacked left to right
+    };
+
+    struct LayoutParams {
+        LayoutDirection direction = LayoutDirection::Overlay;
+        float padding = 0.0f; // Space between the container's edge and its children
+        float spacing = 0.0f; // Space between consecutive children in a stack
+    };
+
+    // Row offsets for lists with per-row heights. A Fenwick tree over the heights gives
+    // the offset of a row, the row at an offset, and single-row height changes in O(log n).
+    // Sums are kept in double so offsets stay exact with millions of rows.
+    struct RowHeightIndex {
+        std::vector<double> tree; // 1-based Fenwick tree
+        std::vector<float> heights;
+
+        size_t size() const {
+            return heights.size();
+        }
+
+        void build(const std::vector<float>& rowHeights) {
+            heights = rowHeights;
+            stale = false;
+            tree.assign(heights.size() + 1, 0.0);
+            for (size_t i = 1; i <= heights.size(); ++i) {
+                tree[i] += heights[i - 1];
+                size_t parentIndex = i + (i & (~i + 1));
+                if (parentIndex <= heights.size()) {
+                    tree[parentIndex] += tree[i];
+                }
+            }
+        }
+
+        // Structural edits only touch the heights; the tree is rebuilt once by rebuildIfStale(),
+        // so a burst of inserts and removes between frames costs a single O(n) pass.
+        bool stale = false;
+
+        void insertRows(size_t first, size_t count, float height) {
+            heights.insert(heights.begin() + first, count, height);
+            stale = true;
+        }
+
+        void eraseRows(size_t first, size_t count) {
+            heights.erase(heights.begin() + first, heights.begin() + first + count);
+            stale = true;
+        }
+
+        void moveRow(size_t from, size_t to) {
+            float height = heights[from];
+            heights.erase(heights.begin() + from);
+            heights.insert(heights.begin() + to, height);
+            stale = true;
+        }
+
+        void rebuildIfStale() {
+            if (stale) {
+                std::vector<float> current;
+                current.swap(heights);
+                build(current);
+            }
+        }
+
+        void setHeight(size_t row, float height) {
+            rebuildIfStale();
+            double delta = static_cast<double>(height) - heights[row];
+            heights[row] = height;
+            for (size_t i = row + 1; i < tree.size(); i += i & (~i + 1)) {
+                tree[i] += delta;
+            }
+        }
+
+        // Distance from the top of the list to the top of row
+        double offsetOf(size_t row) const {
+            double sum = 0.0;
+            for (size_t i = row; i > 0; i -= i & (~i + 1)) {
+                sum += tree[i];
+            }
+            return sum;
+        }
+
+        double totalHeight() const {
+            return offsetOf(heights.size());
+        }
+
+        // Row containing the given offset, clamped to the last row
+        size_t rowAt(double offset) const {
+            size_t n = heights.size();
+            if (n == 0) {
+                return 0;
+            }
+            size_t step = 1;
+            while (step * 2 <= n) {
+                step *= 2;
+            }
+            size_t pos = 0;
+            for (; step > 0; step /= 2) {
+                if (pos + step <= n && tree[pos + step] <= offset) {
+                    pos += step;
+                    offset -= tree[pos];
+                }
+            }
+            return pos < n ? pos : n - 1;
+        }
+    };
+
     void calculatePositionForAlignment(float& x, float& y, int compWidth, int compHeight, int parentWidth, int parentHeight, Alignment alignment) {
         switch (alignment) {
         case Alignment::TopLeft:
@@ -110,4 +235,109 @@ namespace SV_UI {
             break;
         }
     }
+    //////////////////////////////////////////////////
+    ////////////READ-ONLY FILE MAPPING////////////////
+    //////////////////////////////////////////////////
+    // Baked assets (layouts, textures) are used in place from a private read-only
+    // mapping; where mmap is unavailable the file is read into a buffer instead.
+
+    struct MappedFile {
+        const char* data = nullptr;
+        size_t size = 0;
+        bool mapped = false;
+        std::vector<char> buffer;
+
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        ~MappedFile() {
+            close();
+        }
+
+        bool open(const std::string& path) {
+            close();
+#ifdef _WIN32
+            std::ifstream in(path, std::ios::binary);
+            if (!in) {
+                return false;
+            }
+            buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            data = buffer.data();
+            size = buffer.size();
+            return size > 0;
+#else
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                return false;
+            }
+            struct stat info;
+            if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+                ::close(fd);
+                return false;
+            }
+            void* memory = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (memory == MAP_FAILED) {
+                return false;
+            }
+            data = static_cast<const char*>(memory);
+            size = static_cast<size_t>(info.st_size);
+            mapped = true;
+            return true;
+#endif
+        }
+
+        void close() {
+#ifndef _WIN32
+            if (mapped) {
+                munmap(const_cast<char*>(data), size);
+            }
+#endif
+            data = nullptr;
+            size = 0;
+            mapped = false;
+            buffer.clear();
+        }
+    };
+
+    //////////////////////////////////////////////////
+    ////////////ATOMIC FILE WRITES////////////////////
+    //////////////////////////////////////////////////
+    // Cache entries are written to a temporary file next to the target and renamed
+    // over it, so readers (this process or a concurrent launch) never see a partial
+    // file. The temporary name is unique per process and per call.
+
+    std::string uniqueTemporaryPath(const std::string& path) {
+#ifdef _WIN32
+        static const uint64_t processTag = (static_cast<uint64_t>(_getpid()) << 32) ^ std::random_device()();
+#else
+        static const uint64_t processTag = (static_cast<uint64_t>(getpid()) << 32) ^ std::random_device()();
+#endif
+        static std::atomic<uint64_t> counter{ 0 };
+        return path + ".tmp" + std::to_string(processTag) + "." + std::to_string(counter++);
+    }
+
+    // Replace path with size bytes of data; on failure the old file is left as it was
+    bool writeFileAtomically(const std::string& path, const void* data, size_t size) {
+        std::string temporary = uniqueTemporaryPath(path);
+        std::error_code error;
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            out.write(static_cast<const char*>(data), size);
+            if (!out) {
+                std::cerr << "Failed to write " << temporary << std::endl;
+                out.close();
+                std::filesystem::remove(temporary, error);
+                return false;
+            }
+        }
+        std::filesystem::rename(temporary, path, error);
+        if (error) {
+            std::cerr << "Failed to replace " << path << ": " << error.message() << std::endl;
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+        return true;
+    }
 }
@@ -0,0 +1,46 @@
+// Cost of one animation frame with 10k running tracks: the SoA pass alone, and
+// updateAnimations() including writing the values back.
+
+#include "sv_ui3.0.h"
+#include "sv_ui_bench.h"
+
+using namespace SV_UI;
+using namespace SV_UI_Bench;
+
+const int trackCount = 10000;
+
+// Long enough that no track finishes while timing
+const float duration = 1e6f;
+
+struct Owner : public StackComponent {
+    float values[4] = {};
+    Owner() : StackComponent(LayoutParams()) {}
+};
+
+int main() {
+    TrackPool pools[static_cast<size_t>(Easing::Count)];
+    for (int i = 0; i < trackCount; ++i) {
+        pools[i % static_cast<int>(Easing::Count)].add(i, 0.0f, 100.0f, duration, 0.0f);
+    }
+    std::vector<uint32_t> finished;
+    report("TrackPool::advance, 10k tracks, all easings", microsecondsPerRun(2000, [&]() {
+        for (size_t e = 0; e < static_cast<size_t>(Easing::Count); ++e) {
+            finished.clear();
+            pools[e].advance(1.0f / 60.0f, static_cast<Easing>(e), finished);
+        }
+    }));
+
+    std::vector<Owner> owners(trackCount / 4);
+    for (int i = 0; i < trackCount; ++i) {
+        Owner& owner = owners[i / 4];
+        animateFloat(&owner, owner.values[i % 4], 1.0f, duration, static_cast<Easing>(i % static_cast<int>(Easing::Count)));
+    }
+    report("updateAnimations, 10k float tracks", microsecondsPerRun(2000, []() {
+        updateAnimations(1.0f / 60.0f);
+    }));
+
+    report("destroy an owner of 4 tracks among 10k", microsecondsPerRun(1000, [&]() {
+        owners.pop_back();
+    }));
+    return 0;
+}
@@ -0,0 +1,62 @@
+// A console with 8 MB of log: appending one line, and frames (update() and record())
+// while another thread appends 200k lines per second.
+
+#include "sv_ui3.0.h"
+#include "sv_ui_console.h"
+#include "sv_ui_bench.h"
+#include <thread>
+
+using namespace SV_UI;
+using namespace SV_UI_Bench;
+
+const int frameCount = 2000;
+const int linesPerSecond = 200000;
+const int linesPerBurst = 200; // A burst every millisecond
+
+int main() {
+    HiddenGLWindow gl;
+    if (!gl.ready()) {
+        return 1;
+    }
+    ConsoleComponent console(8 << 20, 780, 580);
+    const std::string line = "[worker 3] request 1234567 served in 0.42 ms from cache";
+    reportPerItem("append one line", microsecondsPerRun(1000000, [&]() {
+        console.append(line);
+    }), 1);
+
+    std::atomic<bool> running{ true };
+    std::atomic<uint64_t> produced{ 0 };
+    std::thread producer([&]() {
+        auto next = std::chrono::steady_clock::now();
+        while (running) {
+            for (int i = 0; i < linesPerBurst; ++i) {
+                console.append(line, ConsoleSeverity::Debug);
+            }
+            produced += linesPerBurst;
+            next += std::chrono::microseconds(1000000LL * linesPerBurst / linesPerSecond);
+            std::this_thread::sleep_until(next);
+        }
+    });
+    DrawList list;
+    double worst = 0.0, sum = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frameCount; ++frame) {
+        auto frameStart = std::chrono::steady_clock::now();
+        console.update(0.0f);
+        syncComponentsGL();
+        list.clear();
+        console.record(list);
+        double frameTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - frameStart).count();
+        sum += frameTime;
+        worst = std::max(worst, frameTime);
+        std::this_thread::sleep_for(std::chrono::microseconds(500)); // Between frames, as vsync would
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    running = false;
+    producer.join();
+
+    report("frame while a producer appends, mean", sum / frameCount);
+    report("frame while a producer appends, worst", worst);
+    std::printf("%-48s %10.0f lines/s\n", "producer rate meanwhile", produced / seconds);
+    return 0;
+}
@@ -0,0 +1,65 @@
+// A data grid over a million rows: one frame (update() and record()) while scrolling
+// one row at a time, and sorting by a double and a string column.
+
+#include "sv_ui3.0.h"
+#include "sv_ui_datagrid.h"
+#include "sv_ui_bench.h"
+#include <random>
+
+using namespace SV_UI;
+using namespace SV_UI_Bench;
+
+const size_t rowCount = 1000000;
+
+int main() {
+    HiddenGLWindow gl;
+    if (!gl.ready()) {
+        return 1;
+    }
+    std::mt19937 random(1);
+    std::vector<int64_t> ids(rowCount);
+    std::vector<double> loads(rowCount);
+    std::vector<std::string> names(rowCount);
+    std::vector<std::string_view> nameViews(rowCount);
+    for (size_t i = 0; i < rowCount; ++i) {
+        ids[i] = static_cast<int64_t>(i);
+        loads[i] = (random() % 1000000) / 1000.0;
+        names[i] = "host-" + std::to_string(random() % 100000);
+        nameViews[i] = names[i];
+    }
+    GridDataSource table;
+    table.addColumn("Id", ids.data(), rowCount);
+    table.addColumn("Load", loads.data(), rowCount, 3);
+    table.addColumn("Host", nameViews.data(), rowCount);
+
+    DataGridComponent grid(&table, 800, 600);
+    DrawList list;
+    grid.update(0.0f);
+    syncComponentsGL();
+    report("frame, scrolling one row, 1M rows", microsecondsPerRun(2000, [&]() {
+        grid.scrollTo(grid.scrollY + grid.rowHeight, 0.0f);
+        grid.update(0.0f);
+        syncComponentsGL();
+        list.clear();
+        grid.record(list);
+    }));
+
+    std::vector<uint32_t> order;
+    report("sort 1M rows by a double column", microsecondsPerRun(10, [&]() {
+        sortGridRows(table, 1, SortOrder::Ascending, order, grid.threadCount);
+    }));
+    report("sort 1M rows by a string column", microsecondsPerRun(10, [&]() {
+        sortGridRows(table, 2, SortOrder::Ascending, order, grid.threadCount);
+    }));
+    report("frame while a sort runs, 1M rows", microsecondsPerRun(2000, [&]() {
+        if (!grid.sorting()) {
+            grid.toggleSort(1);
+        }
+        grid.scrollTo(grid.scrollY + grid.rowHeight, 0.0f);
+        grid.update(0.0f);
+        syncComponentsGL();
+        list.clear();
+        grid.record(list);
+    }));
+    return 0;
+}
@@ -0,0 +1,44 @@
+// A plot over a 10M sample series: one frame (update() and record()) with the whole
+// series in view, and appending in bulk.
+
+#include "sv_ui3.0.h"
+#include "sv_ui_plot.h"
+#include "sv_ui_bench.h"
+#include <cmath>
+
+using namespace SV_UI;
+using namespace SV_UI_Bench;
+
+const size_t sampleCount = 10000000;
+const size_t batchSize = 4096;
+
+int main() {
+    std::vector<float> batch(batchSize);
+    for (size_t i = 0; i < batchSize; ++i) {
+        batch[i] = std::sin(i * 0.01f) + 0.1f * static_cast<float>(i % 7);
+    }
+
+    PlotComponent plot(2000, 300);
+    PlotSeries* series = plot.addSeries("signal", sampleCount, 0xff40c060);
+    reportPerItem("append in 4096-sample batches", microsecondsPerRun(static_cast<int>(sampleCount / batchSize), [&]() {
+        series->append(batch.data(), batch.size());
+    }), batchSize);
+
+    DrawList list;
+    report("frame, 10M samples over 2000 columns", microsecondsPerRun(500, [&]() {
+        plot.update(0.0f);
+        list.clear();
+        plot.record(list);
+    }));
+    report("update() alone, 10M samples over 2000 columns", microsecondsPerRun(500, [&]() {
+        plot.update(0.0f);
+    }));
+
+    PlotComponent small(2000, 300);
+    PlotSeries* shortSeries = small.addSeries("signal", 2000, 0xff40c060);
+    shortSeries->append(batch.data(), 2000);
+    report("update() alone, 2000 samples over 2000 columns", microsecondsPerRun(500, [&]() {
+        small.update(0.0f);
+    }));
+    return 0;
+}
@@ -0,0 +1,48 @@
+// Cost of editing a 5 MB, 100k-line document: a keystroke including update(), and
+// the first keystroke after jumping the caret across the document.
+
+#include "sv_ui3.0.h"
+#include "sv_ui_textedit.h"
+#include "sv_ui_bench.h"
+
+using namespace SV_UI;
+using namespace SV_UI_Bench;
+
+const int lineCount = 100000;
+const int lineLength = 50; // Bytes including the newline
+
+int main() {
+    HiddenGLWindow gl;
+    if (!gl.ready()) {
+        return 1;
+    }
+    std::string text;
+    text.reserve(static_cast<size_t>(lineCount) * lineLength);
+    for (int i = 0; i < lineCount; ++i) {
+        text.append("The quick brown fox jumps over the lazy dog 0123\n");
+    }
+    TextEditComponent edit(text, 780, 580);
+    edit.update(0.0f);
+    syncComponentsGL();
+
+    size_t middle = text.size() / 2 + 10;
+    edit.moveCaret(middle, false);
+    edit.update(0.0f);
+    syncComponentsGL();
+    report("keystroke and update(), 5 MB", microsecondsPerRun(20000, [&]() {
+        edit.insertAtCaret("x", 1);
+        edit.update(0.0f);
+        syncComponentsGL();
+    }));
+
+    // Alternate between the two ends so every edit moves the gap across the document
+    bool atEnd = false;
+    report("keystroke after a caret jump across 5 MB", microsecondsPerRun(200, [&]() {
+        atEnd = !atEnd;
+        edit.moveCaret(atEnd ? edit.textSize() - 20 : 20, false);
+        edit.insertAtCaret("x", 1);
+        edit.update(0.0f);
+        syncComponentsGL();
+    }));
+    return 0;
+}
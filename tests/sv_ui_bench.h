@@ -0,0 +1,74 @@
+#pragma once
+
+// Timing for the benchmarks. They are built with the tests but not run by ctest;
+// run them by hand from an optimized build:
+//
+//     cmake -S tests -B build/tests -DCMAKE_BUILD_TYPE=Release && cmake --build build/tests
+//     ./build/tests/bench_animation
+
+#include "sv_ui3.0.h"
+#include <chrono>
+#include <cstdio>
+
+namespace SV_UI_Bench {
+    // Mean microseconds per call of run(), after one untimed warm-up call
+    template <typename Run>
+    double microsecondsPerRun(int runs, Run run) {
+        run();
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < runs; ++i) {
+            run();
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::micro>(end - start).count() / runs;
+    }
+
+    inline void report(const char* name, double microseconds) {
+        std::printf("%-48s %10.2f us\n", name, microseconds);
+    }
+
+    // For runs that each process items things, e.g. a batch of samples
+    inline void reportPerItem(const char* name, double microseconds, size_t items) {
+        std::printf("%-48s %10.2f ns per item\n", name, microseconds * 1000.0 / items);
+    }
+
+    // A hidden window with a current GL context and glText, for benchmarks of components
+    // that lay out glyphs
+    struct HiddenGLWindow {
+        SDL_Window* window = nullptr;
+        SDL_GLContext context = nullptr;
+
+        HiddenGLWindow() {
+            if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+                std::cerr << "Failed to initialize SDL: " << SDL_GetError() << std::endl;
+                return;
+            }
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+            window = SDL_CreateWindow("SV_UI benchmark", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 800, 600, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+            context = window ? SDL_GL_CreateContext(window) : nullptr;
+            if (!context) {
+                std::cerr << "Failed to create OpenGL context: " << SDL_GetError() << std::endl;
+                return;
+            }
+            glewInit();
+            gltInit();
+        }
+
+        ~HiddenGLWindow() {
+            if (context) {
+                gltTerminate();
+                SDL_GL_DeleteContext(context);
+            }
+            if (window) {
+                SDL_DestroyWindow(window);
+            }
+            SDL_Quit();
+        }
+
+        bool ready() const {
+            return context != nullptr;
+        }
+    };
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+// Minimal checking for the unit tests: CHECK reports a failed condition and
+// carries on, and main() returns TEST_RESULT() so ctest sees the outcome.
+
+#include <cstdio>
+
+namespace SV_UI_Test {
+    inline int& failures() {
+        static int count = 0;
+        return count;
+    }
+}
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            ++SV_UI_Test::failures(); \
+        } \
+    } while (0)
+
+#define TEST_RESULT() (SV_UI_Test::failures() == 0 ? 0 : 1)
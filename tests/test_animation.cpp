@@ -0,0 +1,72 @@
+// Animation tracks end with their owner, float tracks included, and size
+// animations drive the size measure() actually reports.
+
+#include "sv_ui3.0.h"
+#include "sv_ui_test.h"
+
+using namespace SV_UI;
+
+// Holds an animatable float, like a component with a fade
+struct FadingStack : public StackComponent {
+    float alpha = 1.0f;
+    FadingStack() : StackComponent(LayoutParams()) {}
+};
+
+// Sized by its content, like a TextComponent
+struct ContentSized : public StackComponent {
+    ContentSized() : StackComponent(LayoutParams()) {}
+    virtual int* sizeField(bool horizontal) override { return nullptr; }
+};
+
+static void testOwnerCancelsFloatTracks() {
+    FadingStack* stack = new FadingStack();
+    AnimationHandle fade = animateFloat(stack, stack->alpha, 0.0f, 1.0f);
+    AnimationHandle grow = animateSizeTo(*stack, 100.0f, 50.0f, 1.0f);
+    CHECK(isAnimating(fade));
+    CHECK(isAnimating(grow));
+    size_t before = currentAnimator().activeCount;
+    delete stack;
+    CHECK(!isAnimating(fade));
+    CHECK(!isAnimating(grow));
+    CHECK(currentAnimator().activeCount == before - 3);
+    updateAnimations(0.5f); // Would write through the dead pointers if any track survived
+}
+
+static void testFloatNeedsOwner() {
+    float value = 0.0f;
+    AnimationHandle handle = animate(&value, AnimProperty::Float, 0.0f, 1.0f, 1.0f);
+    CHECK(!isAnimating(handle));
+}
+
+static void testReplaceKeepsOneTrack() {
+    FadingStack stack;
+    size_t before = currentAnimator().activeCount;
+    animateFloat(&stack, stack.alpha, 0.0f, 1.0f);
+    AnimationHandle second = animateFloat(&stack, stack.alpha, 0.5f, 1.0f);
+    CHECK(currentAnimator().activeCount == before + 1);
+    updateAnimations(1.0f);
+    CHECK(!isAnimating(second));
+    CHECK(stack.alpha == 0.5f);
+}
+
+static void testSizeDrivesMeasure() {
+    FadingStack stack;
+    animateSizeTo(stack, 120.0f, 40.0f, 1.0f, Easing::Linear);
+    updateAnimations(1.0f);
+    CHECK(stack.fixedWidth == 120 && stack.fixedHeight == 40);
+    float width = 0.0f, height = 0.0f;
+    stack.measure(width, height);
+    CHECK(width == 120.0f && height == 40.0f);
+
+    ContentSized text;
+    CHECK(!isAnimating(animateSizeTo(text, 10.0f, 10.0f, 1.0f)));
+    CHECK(!isAnimating(animate(&text, AnimProperty::ComponentWidth, 0.0f, 10.0f, 1.0f)));
+}
+
+int main() {
+    testOwnerCancelsFloatTracks();
+    testFloatNeedsOwner();
+    testReplaceKeepsOneTrack();
+    testSizeDrivesMeasure();
+    return TEST_RESULT();
+}
@@ -0,0 +1,69 @@
+// Queued commands coalesce per target and kind, last write wins, and commands for
+// a dead handle never displace the live target's commands.
+
+#include "sv_ui3.0.h"
+#include "sv_ui_test.h"
+
+using namespace SV_UI;
+
+static UICommandQueue& queue() {
+    return commandQueue(ui());
+}
+
+static void testLastWriteWins() {
+    Widget first, second;
+    UIHandle a = handleOf(&first);
+    UIHandle b = handleOf(&second);
+    uint64_t applied = queue().applied, coalesced = queue().coalesced;
+
+    moveWidgetAsync(a, 10, 10);
+    moveWidgetAsync(b, 5, 6);
+    moveWidgetAsync(a, 20, 30);
+    setVisibleAsync(a, false); // Another kind: not coalesced with the moves
+    applyQueuedCommands();
+
+    CHECK(first.x == 20 && first.y == 30);
+    CHECK(second.x == 5 && second.y == 6);
+    CHECK(!first.visible);
+    CHECK(queue().applied - applied == 3);
+    CHECK(queue().coalesced - coalesced == 1);
+}
+
+// Slots and generations chosen so the old (slot << 32) ^ (generation << 8) key collided
+static void testNoKeyCollision() {
+    Widget first, second;
+    UIHandle a = handleOf(&first);
+    UIHandle b = handleOf(&second);
+    handleTable().entries[a.slot].generation = ((a.slot ^ b.slot) << 24) ^ b.generation;
+    a = handleOf(&first);
+
+    moveWidgetAsync(a, 1, 2);
+    moveWidgetAsync(b, 3, 4);
+    applyQueuedCommands();
+    CHECK(first.x == 1 && first.y == 2);
+    CHECK(second.x == 3 && second.y == 4);
+}
+
+// A command for the slot's previous owner, posted after one for its new owner
+static void testStaleDoesNotWin() {
+    Widget* old = new Widget();
+    UIHandle stale = handleOf(old);
+    delete old; // Releases the slot
+    Widget current;
+    UIHandle live = handleOf(&current);
+    CHECK(live.slot == stale.slot && live.generation != stale.generation);
+    uint64_t staleCount = queue().stale;
+
+    moveWidgetAsync(live, 7, 8);
+    moveWidgetAsync(stale, 100, 100);
+    applyQueuedCommands();
+    CHECK(current.x == 7 && current.y == 8);
+    CHECK(queue().stale - staleCount == 1);
+}
+
+int main() {
+    testLastWriteWins();
+    testNoKeyCollision();
+    testStaleDoesNotWin();
+    return TEST_RESULT();
+}
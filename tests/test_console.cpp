@@ -0,0 +1,150 @@
+// The console arena keeps exactly the newest lines that fit, each intact, while
+// producers on several threads append; severities map to the Console style states.
+// update() picks lines without GL, and their texts exist only once the GL sync ran.
+
+#include "sv_ui_console.h"
+#include "sv_ui_test.h"
+#include <random>
+#include <thread>
+
+using namespace SV_UI;
+
+// Retained lines are the newest pushed ones, unchanged, and no two overlap in the text ring
+static bool matchesHistory(const ConsoleBuffer& buffer, const std::vector<std::string>& history) {
+    if (buffer.endLine != history.size() || buffer.dropped != buffer.firstLine) {
+        return false;
+    }
+    for (uint64_t line = buffer.firstLine; line < buffer.endLine; ++line) {
+        std::string expected = history[line].substr(0, buffer.maxLineBytes);
+        if (buffer.line(line) != expected) {
+            return false;
+        }
+        const ConsoleLine& record = buffer.lines[line % buffer.lines.size()];
+        if (record.offset % buffer.text.size() + record.length > buffer.text.size()) {
+            return false; // Wrapped
+        }
+        if (line > buffer.firstLine && record.offset < buffer.lines[(line - 1) % buffer.lines.size()].offset) {
+            return false;
+        }
+    }
+    // The oldest retained line's bytes have not been overwritten by the newest
+    return buffer.firstLine == buffer.endLine ||
+        buffer.textEnd - buffer.lines[buffer.firstLine % buffer.lines.size()].offset <= buffer.text.size();
+}
+
+static void testRing(size_t memoryLimit, unsigned seed) {
+    std::mt19937 random(seed);
+    ConsoleBuffer buffer(memoryLimit);
+    std::vector<std::string> history;
+    uint64_t truncated = 0;
+    for (int step = 0; step < 20000; ++step) {
+        size_t length = random() % 8 == 0 ? random() % (buffer.maxLineBytes + 50) : random() % 40;
+        std::string line(length, static_cast<char>('a' + step % 26));
+        if (length > buffer.maxLineBytes) {
+            ++truncated;
+        }
+        buffer.push(line.data(), line.size(), ConsoleSeverity::Info);
+        history.push_back(line);
+        if (step % 97 == 0 && !matchesHistory(buffer, history)) {
+            CHECK(false);
+            std::fprintf(stderr, "  memory %zu, seed %u, step %d\n", memoryLimit, seed, step);
+            return;
+        }
+    }
+    CHECK(matchesHistory(buffer, history));
+    CHECK(buffer.truncated == truncated);
+    CHECK(buffer.dropped > 0); // The runs above overflow every limit tested
+}
+
+static void testAppendSplits() {
+    ConsoleComponent console(1 << 16, 200, 100);
+    console.append("one\r\ntwo\n\nthree\n", ConsoleSeverity::Warning);
+    console.append("");
+    ConsoleBuffer& buffer = console.buffer;
+    CHECK(buffer.endLine == 5);
+    CHECK(buffer.line(0) == "one" && buffer.line(1) == "two" && buffer.line(2).empty() && buffer.line(3) == "three");
+    CHECK(buffer.line(4).empty());
+    CHECK(buffer.lines[1].severity == ConsoleSeverity::Warning && buffer.lines[4].severity == ConsoleSeverity::Info);
+    console.clear();
+    CHECK(buffer.firstLine == buffer.endLine);
+}
+
+// Each producer's lines stay in its order and intact while the UI side reads
+static void testProducers() {
+    ConsoleComponent console(64 << 10, 200, 100);
+    const int producers = 4, perProducer = 20000;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&console, p]() {
+            for (int n = 0; n < perProducer; ++n) {
+                console.append("producer " + std::to_string(p) + " line " + std::to_string(n));
+            }
+        });
+    }
+    bool intact = true;
+    for (int read = 0; read < 200; ++read) {
+        std::lock_guard<std::mutex> lock(console.buffer.mutex);
+        int last[producers] = { -1, -1, -1, -1 };
+        for (uint64_t line = console.buffer.firstLine; line < console.buffer.endLine; ++line) {
+            int p = -1, n = -1;
+            std::string text(console.buffer.line(line));
+            intact = intact && std::sscanf(text.c_str(), "producer %d line %d", &p, &n) == 2 && p >= 0 && p < producers && n > last[p];
+            if (p >= 0 && p < producers) last[p] = n;
+        }
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    CHECK(intact);
+    CHECK(console.buffer.endLine == static_cast<uint64_t>(producers) * perProducer);
+}
+
+static void testSeverityStyles() {
+    const CompiledTheme& theme = builtinTheme;
+    uint32_t info = theme.lookup(0, StyleComponent::Console, severityState(ConsoleSeverity::Info)).text;
+    CHECK(info == packColor(0.85f, 0.85f, 0.85f));
+    CHECK(theme.lookup(0, StyleComponent::Console, severityState(ConsoleSeverity::Error)).text == packColor(1.0f, 0.35f, 0.3f));
+    CHECK(theme.lookup(0, StyleComponent::Console, severityState(ConsoleSeverity::Trace)).text != info);
+
+    Theme custom = defaultTheme();
+    custom.set(StyleComponent::Console, StyleState::Warning, StyleProperty::TextColor, packColor(0.0f, 1.0f, 0.0f), "quiet");
+    CompiledTheme compiled = compileTheme(custom);
+    uint16_t quiet = internStyleClass("quiet");
+    CHECK(compiled.lookup(quiet, StyleComponent::Console, StyleState::Warning).text == packColor(0.0f, 1.0f, 0.0f));
+    CHECK(compiled.lookup(0, StyleComponent::Console, StyleState::Warning).text == packColor(1.0f, 0.8f, 0.25f));
+}
+
+static size_t textCommands(const DrawList& list) {
+    return std::count_if(list.commands.begin(), list.commands.end(),
+        [](const DrawCmd& command) { return command.type == DrawCmdType::Text; });
+}
+
+static void testGLSync() {
+    ConsoleComponent console(4096, 300, 100);
+    console.append("first\nsecond\nthird");
+    console.update(0.0f);
+    CHECK(console.lineTexts.empty());
+    CHECK(console.staleSlots.size() == 3);
+    DrawList list;
+    console.record(list);
+    CHECK(textCommands(list) == 0); // A pipelined frame recorded before the sync
+    syncComponentsGL();
+    CHECK(console.lineTexts.size() == console.lineSlots);
+    CHECK(console.staleSlots.empty() && !console.glSyncQueued);
+    list.clear();
+    console.record(list);
+    CHECK(textCommands(list) == 3);
+}
+
+int main() {
+    testSeverityStyles();
+    testGLSync();
+    testAppendSplits();
+    const size_t limits[] = { 1024, 4096, 100000 };
+    unsigned seed = 1;
+    for (size_t limit : limits) {
+        testRing(limit, seed++);
+    }
+    testProducers();
+    return TEST_RESULT();
+}
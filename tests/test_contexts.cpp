@@ -0,0 +1,147 @@
+// The former global names refer to the default context whatever is current,
+// routeEvent() hands each window's events to the context bound to that window,
+// and two threads building and recording their own contexts at once never see
+// each other's widgets, frame stats or tracked resources.
+
+#include "sv_ui3.0.h"
+#include "sv_ui_test.h"
+#include <thread>
+
+using namespace SV_UI;
+
+static SDL_Event mouseDown(Uint32 windowID) {
+    SDL_Event event{};
+    event.type = SDL_MOUSEBUTTONDOWN;
+    event.button.windowID = windowID;
+    return event;
+}
+
+static void testAliases() {
+    UIContext* other = createContext();
+    CHECK(&uiManager == &currentUIManager());
+    {
+        ContextScope scope(other);
+        CHECK(&currentUIManager() == &other->uiManager);
+        CHECK(&uiManager == &defaultUIContext().uiManager);
+        CHECK(&frameStats == &defaultUIContext().frameStats);
+        CHECK(&currentFrameStats() != &frameStats);
+    }
+    CHECK(&currentFrameStats() == &frameStats);
+    CHECK(destroyContext(other));
+}
+
+static void testRouting() {
+    defaultUIContext().windowID = 1;
+    UIContext* second = createContext();
+    UIContext* third = createContext();
+    second->windowID = 2;
+    third->windowID = 3;
+    second->routedEvents = true;
+    third->routedEvents = true;
+
+    CHECK(!routeEvent(mouseDown(1))); // The caller's own window
+    CHECK(routeEvent(mouseDown(2)));
+    CHECK(routeEvent(mouseDown(3)));
+    CHECK(routeEvent(mouseDown(3)));
+    CHECK(second->inbox.size() == 1 && third->inbox.size() == 2);
+    CHECK(second->inbox[0].button.windowID == 2);
+
+    third->routedEvents = false; // Not running runRoutedUI(): the caller handles it
+    CHECK(!routeEvent(mouseDown(3)));
+    CHECK(!routeEvent(mouseDown(9)));
+
+    SDL_Event noWindow{};
+    noWindow.type = SDL_USEREVENT + 100;
+    CHECK(!routeEvent(noWindow));
+
+    SDL_Event quit{};
+    quit.type = SDL_QUIT;
+    CHECK(!routeEvent(quit)); // Seen by the caller and by every routed context
+    CHECK(second->inbox.size() == 2 && second->inbox.back().type == SDL_QUIT);
+    CHECK(third->inbox.size() == 2);
+    defaultUIContext().windowID = 0;
+    CHECK(destroyContext(second));
+    CHECK(destroyContext(third));
+}
+
+// What one thread saw of its own context; checked on the main thread after the join
+struct ThreadRun {
+    UIContext* context = nullptr;
+    int firstID = 0;
+    int widgetCount = 0;
+    unsigned recordThreads = 1;
+    bool ownWidgetsOnly = true;
+    bool statsMatch = true;
+    bool trackedOwnOnly = true;
+};
+
+// Untextured widgets with a layout: no GL context is needed to lay them out and record them
+static void buildAndRecord(ThreadRun& run, int frames) {
+    ContextScope scope(run.context);
+    setRecordThreads(run.recordThreads);
+    for (int i = 0; i < run.widgetCount; ++i) {
+        int id = run.firstID + i;
+        createWidget(id, 10 * i, 10 * i, 200, 100, WIDGET_NONE, "");
+        setLayout(LayoutDirection::Vertical, 4.0f, 2.0f);
+        endWidget();
+    }
+    trackResource(ResourceKind::Host, resourceHandle(&run), sizeof(run), "ThreadRun", "", run.firstID);
+    DrawList list;
+    for (int frame = 0; frame < frames; ++frame) {
+        prepareFrame();
+        list.clear();
+        recordUI(list);
+        const FrameStats& stats = currentFrameStats();
+        run.statsMatch = run.statsMatch && stats.widgets == static_cast<size_t>(run.widgetCount) &&
+            stats.drawCommands == list.commands.size() && stats.vertices == list.vertices.size() + list.shapeVertices.size();
+        for (Widget* widget : currentUIManager().widgets) {
+            run.ownWidgetsOnly = run.ownWidgetsOnly && widget->ID >= run.firstID && widget->ID < run.firstID + run.widgetCount;
+        }
+        run.ownWidgetsOnly = run.ownWidgetsOnly && currentUIManager().widgets.size() == static_cast<size_t>(run.widgetCount);
+    }
+    {
+        ResourceTracker& tracker = currentResourceTracker();
+        std::lock_guard<std::mutex> lock(tracker.mutex);
+        for (const auto& entry : tracker.entries) {
+            run.trackedOwnOnly = run.trackedOwnOnly && (entry.second.widgetID == -1 || entry.second.widgetID == run.firstID);
+        }
+        run.trackedOwnOnly = run.trackedOwnOnly && tracker.entries.count(resourceKey(ResourceKind::Host, resourceHandle(&run))) == 1;
+    }
+    untrackResource(ResourceKind::Host, resourceHandle(&run));
+}
+
+static void testConcurrentContexts() {
+    ThreadRun runs[2];
+    runs[0].firstID = 100;
+    runs[0].widgetCount = 3;
+    runs[1].firstID = 200;
+    runs[1].widgetCount = 6;
+    runs[1].recordThreads = 2; // Records on its own pool
+    for (ThreadRun& run : runs) {
+        run.context = createContext();
+    }
+    std::thread first(buildAndRecord, std::ref(runs[0]), 200);
+    std::thread second(buildAndRecord, std::ref(runs[1]), 200);
+    first.join();
+    second.join();
+
+    for (const ThreadRun& run : runs) {
+        CHECK(run.ownWidgetsOnly);
+        CHECK(run.statsMatch);
+        CHECK(run.trackedOwnOnly);
+        CHECK(run.context->uiManager.widgets.size() == static_cast<size_t>(run.widgetCount));
+        CHECK(run.context->frameStats.widgets == static_cast<size_t>(run.widgetCount));
+    }
+    CHECK(currentUIManager().widgets.empty()); // The main thread's context saw none of it
+    CHECK(frameStats.widgets == 0);
+    for (ThreadRun& run : runs) {
+        CHECK(destroyContext(run.context));
+    }
+}
+
+int main() {
+    testAliases();
+    testRouting();
+    testConcurrentContexts();
+    return TEST_RESULT();
+}
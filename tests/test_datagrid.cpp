@@ -0,0 +1,106 @@
+// Grid sorts match a stable sort by the same rules (NaN last in either direction,
+// ties in row order in both), and a grid swaps in its background sort with the
+// inverse permutation to match.
+
+#include "sv_ui_datagrid.h"
+#include "sv_ui_test.h"
+#include <cmath>
+#include <random>
+
+using namespace SV_UI;
+
+const size_t rows = 100000; // Enough for several sort chunks
+
+// Row order by the grid's rules, through a plain stable sort
+template <typename T>
+static std::vector<uint32_t> expectedOrder(const std::vector<T>& values, bool descending) {
+    std::vector<uint32_t> order(values.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        bool aMissing = values[a] != values[a], bMissing = values[b] != values[b];
+        if (aMissing || bMissing) return !aMissing && bMissing;
+        return descending ? values[b] < values[a] : values[a] < values[b];
+    });
+    return order;
+}
+
+static bool isInverse(const DataGridComponent& grid) {
+    for (size_t row = 0; row < grid.rowCount(); ++row) {
+        if (grid.displayRowOf(grid.order[row]) != row) return false;
+    }
+    return true;
+}
+
+struct Table {
+    std::vector<double> doubles;
+    std::vector<int64_t> ints;
+    std::vector<std::string> texts;
+    std::vector<std::string_view> views;
+    GridDataSource source;
+
+    explicit Table(size_t count) {
+        std::mt19937 random(3);
+        for (size_t i = 0; i < count; ++i) {
+            // Few distinct values, so ties are common, and some NaN
+            doubles.push_back(random() % 50 == 0 ? std::nan("") : static_cast<double>(random() % 1000) / 4.0);
+            ints.push_back(static_cast<int64_t>(random() % 2000) - 1000);
+            texts.push_back(std::string(1, static_cast<char>('a' + random() % 26)) + std::to_string(random() % 100));
+        }
+        views.assign(texts.begin(), texts.end());
+        source.addColumn("Double", doubles.data(), count);
+        source.addColumn("Int", ints.data(), count);
+        source.addColumn("Text", views.data(), count);
+    }
+};
+
+static void testSortRules() {
+    Table table(rows);
+    std::vector<uint32_t> order;
+    for (bool descending : { false, true }) {
+        SortOrder direction = descending ? SortOrder::Descending : SortOrder::Ascending;
+        sortGridRows(table.source, 0, direction, order, 4);
+        CHECK(order == expectedOrder(table.doubles, descending));
+        CHECK(std::isnan(table.doubles[order.back()]));
+        sortGridRows(table.source, 1, direction, order, 4);
+        CHECK(order == expectedOrder(table.ints, descending));
+        sortGridRows(table.source, 2, direction, order, 4);
+        CHECK(order == expectedOrder(table.views, descending));
+    }
+    sortGridRows(table.source, 0, SortOrder::None, order, 4);
+    CHECK(order == expectedOrder(std::vector<int>(rows, 0), false));
+}
+
+static void testBackgroundSort() {
+    Table table(rows);
+    DataGridComponent grid(&table.source);
+    grid.threadCount = 4;
+    CHECK(isInverse(grid));
+
+    grid.sortBy(1, SortOrder::Ascending);
+    grid.sortBy(0, SortOrder::Descending); // Supersedes the first while it runs
+    CHECK(grid.rowCount() == rows);
+    grid.pollSort(true);
+    CHECK(!grid.sorting());
+    CHECK(grid.order == expectedOrder(table.doubles, true));
+    CHECK(isInverse(grid));
+
+    // Fewer rows: the old order without the missing rows stands in until the sort lands
+    table.source.rowCount = rows / 2;
+    table.doubles.resize(rows / 2);
+    grid.dataChanged();
+    CHECK(grid.rowCount() == rows / 2);
+    CHECK(isInverse(grid));
+    grid.pollSort(true);
+    CHECK(grid.order == expectedOrder(table.doubles, true));
+    CHECK(isInverse(grid));
+
+    grid.sortBy(0, SortOrder::None);
+    grid.pollSort(true);
+    CHECK(grid.order == expectedOrder(std::vector<int>(rows / 2, 0), false));
+}
+
+int main() {
+    testSortRules();
+    testBackgroundSort();
+    return TEST_RESULT();
+}
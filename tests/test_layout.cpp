@@ -0,0 +1,144 @@
+// loadLayout() validates a compiled layout before building anything from it:
+// damaged files are refused instead of read out of bounds.
+
+#include "sv_ui_layout.h"
+#include "sv_ui_test.h"
+#include <cstdio>
+
+using namespace SV_UI;
+
+const char* layoutPath = "test_layout.tmp.svl";
+
+// Widgets and list boxes only, so loading needs no GL context
+const char* source =
+    "widget id=7 x=10 y=20 w=300 h=200 name=panel\n"
+    "    layout vertical padding=4 spacing=2\n"
+    "    stack horizontal\n"
+    "        listbox w=100 h=80 name=options\n"
+    "            item \"One\"\n"
+    "            item \"Two\"\n"
+    "        end\n"
+    "    end\n"
+    "end\n";
+
+static std::unique_ptr<LoadedLayout> loadBytes(const std::vector<char>& bytes) {
+    std::FILE* file = std::fopen(layoutPath, "wb");
+    std::fwrite(bytes.data(), 1, bytes.size(), file);
+    std::fclose(file);
+    return loadLayout(layoutPath);
+}
+
+// Offsets of the sections in a compiled file
+struct Sections {
+    size_t records, refs, pool;
+};
+
+static Sections sectionsOf(const std::vector<char>& bytes) {
+    LayoutFileHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    Sections sections;
+    sections.records = sizeof(header);
+    sections.refs = sections.records + header.recordCount * sizeof(LayoutRecord);
+    sections.pool = sections.refs + header.stringCount * sizeof(LayoutStringRef);
+    return sections;
+}
+
+template <typename T>
+static void poke(std::vector<char>& bytes, size_t offset, T value) {
+    std::memcpy(bytes.data() + offset, &value, sizeof(value));
+}
+
+static void testValidFileLoads(const std::vector<char>& valid) {
+    std::unique_ptr<LoadedLayout> layout = loadBytes(valid);
+    CHECK(layout != nullptr);
+    if (!layout) {
+        return;
+    }
+    Widget* panel = layout->widget("panel");
+    CHECK(panel != nullptr);
+    ListBoxComponent* options = layout->listBox("options");
+    CHECK(options != nullptr && options->source->rowCount() == 2);
+    CHECK(options && options->source->rowText(1) == "Two");
+    if (panel) {
+        destroyWidget(panel->ID);
+    }
+}
+
+static void testDamagedFilesAreRefused(const std::vector<char>& valid) {
+    Sections at = sectionsOf(valid);
+    size_t listBoxRecord = at.records + 3 * sizeof(LayoutRecord); // widget, layout, stack, listbox
+    std::vector<std::vector<char>> damaged;
+
+    damaged.push_back(std::vector<char>(valid.begin(), valid.begin() + 10)); // Shorter than the header
+    damaged.push_back(std::vector<char>(valid.begin(), valid.end() - 1));    // Pool cut short
+    std::vector<char> bytes = valid;
+    bytes.push_back('x'); // Trailing garbage
+    damaged.push_back(bytes);
+
+    bytes = valid;
+    poke<uint32_t>(bytes, offsetof(LayoutFileHeader, magic), 0x12345678);
+    damaged.push_back(bytes);
+    bytes = valid;
+    poke<uint32_t>(bytes, offsetof(LayoutFileHeader, version), LAYOUT_VERSION + 1);
+    damaged.push_back(bytes);
+    bytes = valid;
+    poke<uint32_t>(bytes, offsetof(LayoutFileHeader, recordCount), 0x40000000); // Sections past the end
+    damaged.push_back(bytes);
+    bytes = valid;
+    poke<uint32_t>(bytes, offsetof(LayoutFileHeader, stringCount), 0xffffffffu);
+    damaged.push_back(bytes);
+
+    bytes = valid;
+    poke<uint32_t>(bytes, at.refs + offsetof(LayoutStringRef, offset), 0x7fffffff); // String outside the pool
+    damaged.push_back(bytes);
+    bytes = valid;
+    poke<uint32_t>(bytes, at.refs + offsetof(LayoutStringRef, length), 2); // Not followed by its terminator
+    damaged.push_back(bytes);
+
+    bytes = valid;
+    poke<uint8_t>(bytes, at.records + offsetof(LayoutRecord, op), 200); // Unknown op
+    damaged.push_back(bytes);
+    bytes = valid;
+    poke<uint8_t>(bytes, at.records + offsetof(LayoutRecord, alignment), 9);
+    damaged.push_back(bytes);
+    bytes = valid;
+    poke<uint32_t>(bytes, at.records + offsetof(LayoutRecord, name), 1000); // String index out of range
+    damaged.push_back(bytes);
+    bytes = valid;
+    poke<uint32_t>(bytes, listBoxRecord + offsetof(LayoutRecord, itemCount), 0xfffffff0u); // Items past the table
+    damaged.push_back(bytes);
+    bytes = valid;
+    poke<uint8_t>(bytes, at.records + 2 * sizeof(LayoutRecord) + offsetof(LayoutRecord, op), static_cast<uint8_t>(LayoutOp::Text)); // Unbalanced end
+    damaged.push_back(bytes);
+    bytes = valid;
+    poke<uint8_t>(bytes, at.records + offsetof(LayoutRecord, op), static_cast<uint8_t>(LayoutOp::Text)); // Outside a widget
+    damaged.push_back(bytes);
+
+    size_t widgetsBefore = currentUIManager().widgets.size();
+    for (size_t i = 0; i < damaged.size(); ++i) {
+        bool refused = loadBytes(damaged[i]) == nullptr;
+        CHECK(refused);
+        if (!refused) std::fprintf(stderr, "  damaged file %zu was loaded\n", i);
+    }
+    CHECK(currentUIManager().widgets.size() == widgetsBefore);
+}
+
+static void testCompilerErrors() {
+    std::vector<char> out;
+    CHECK(!compileLayout("text \"outside\"\n", out));
+    CHECK(!compileLayout("widget\n    listbox\n        text \"no\"\n    end\nend\n", out));
+    CHECK(!compileLayout("widget\n    stack diagonal\nend\n", out));
+    CHECK(!compileLayout("widget\n", out));
+}
+
+int main() {
+    std::vector<char> valid;
+    CHECK(compileLayout(source, valid));
+    if (!valid.empty()) {
+        testValidFileLoads(valid);
+        testDamagedFilesAreRefused(valid);
+    }
+    testCompilerErrors();
+    std::remove(layoutPath);
+    return TEST_RESULT();
+}
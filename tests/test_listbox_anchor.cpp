@@ -0,0 +1,133 @@
+// ListBox keeps the rows on screen still when rows above them are inserted, removed
+// or moved.
+
+#include "sv_ui3.0.h"
+#include "sv_ui_test.h"
+
+using namespace SV_UI;
+
+static std::vector<std::string> numbered(int count) {
+    std::vector<std::string> items;
+    for (int i = 0; i < count; ++i) {
+        items.push_back("row " + std::to_string(i));
+    }
+    return items;
+}
+
+// Put row at the top of the view, as update() would have recorded it
+static void showAt(ListBoxComponent& list, int row) {
+    list.scrollOffset = list.scrollTarget = static_cast<float>(list.rowOffset(row));
+    list.firstVisibleRow = row;
+}
+
+static void testShiftHelpers() {
+    int index = 10;
+    ListBoxComponent::shiftForInsert(index, 3, 4);
+    CHECK(index == 14);
+    index = 2;
+    ListBoxComponent::shiftForInsert(index, 3, 4);
+    CHECK(index == 2);
+
+    index = 10;
+    ListBoxComponent::shiftAnchorForRemove(index, 2, 3);
+    CHECK(index == 7);
+    index = 3;
+    ListBoxComponent::shiftAnchorForRemove(index, 2, 3);
+    CHECK(index == 2); // Inside the removed range: the first survivor after it
+    index = 1;
+    ListBoxComponent::shiftAnchorForRemove(index, 2, 3);
+    CHECK(index == 1);
+
+    index = 3;
+    ListBoxComponent::shiftForRemove(index, 2, 3);
+    CHECK(index == -1); // Selections are dropped instead
+}
+
+static void testUniformRows() {
+    VectorListSource source(numbered(100));
+    ListBoxComponent list(&source, nullptr, 100, 100); // 20 px rows
+    showAt(list, 20);
+
+    source.remove(5, 5); // Above the view
+    CHECK(list.firstVisibleRow == 15);
+    CHECK(list.scrollOffset == 300.0f && list.scrollTarget == 300.0f);
+    CHECK(list.itemText(list.firstVisibleRow) == "row 20");
+
+    source.remove(13, 5); // Covers the top row: rows 13..17 go, "row 23" was the next survivor
+    CHECK(list.firstVisibleRow == 13);
+    CHECK(list.scrollOffset == 260.0f);
+    CHECK(list.itemText(list.firstVisibleRow) == "row 23");
+
+    float before = list.scrollOffset;
+    source.remove(20, 10); // Below the top row
+    CHECK(list.firstVisibleRow == 13 && list.scrollOffset == before);
+
+    source.insert(0, "new");
+    CHECK(list.firstVisibleRow == 14 && list.scrollOffset == before + 20.0f);
+    CHECK(list.itemText(list.firstVisibleRow) == "row 23");
+
+    source.remove(10, list.itemCount() - 10); // Everything from above the top to the end
+    CHECK(list.firstVisibleRow == list.itemCount() - 1);
+}
+
+static void testVariableRows() {
+    VectorListSource source(numbered(50));
+    ListBoxComponent list(&source, nullptr, 100, 100);
+    std::vector<float> heights;
+    for (int i = 0; i < 50; ++i) {
+        heights.push_back(10.0f + (i % 3) * 10.0f); // 10, 20, 30, ...
+    }
+    list.setRowHeights(heights);
+    showAt(list, 12);
+    float removed = heights[2] + heights[3] + heights[4];
+    float before = list.scrollOffset;
+    source.remove(2, 3);
+    CHECK(list.firstVisibleRow == 9);
+    CHECK(list.scrollOffset == before - removed);
+    CHECK(list.itemText(list.firstVisibleRow) == "row 12");
+}
+
+// The top row keeps its text and its offset stays the scroll position
+static bool stillAt(ListBoxComponent& list, const std::string& text) {
+    list.rowIndex.rebuildIfStale(); // As update() does before using offsets
+    return list.itemText(list.firstVisibleRow) == text && list.scrollOffset == static_cast<float>(list.rowOffset(list.firstVisibleRow)) &&
+        list.scrollTarget == list.scrollOffset;
+}
+
+static void testMovedRows() {
+    VectorListSource source(numbered(50));
+    ListBoxComponent list(&source, nullptr, 100, 100);
+    std::vector<float> heights;
+    for (int i = 0; i < 50; ++i) {
+        heights.push_back(10.0f + (i % 3) * 10.0f);
+    }
+    list.setRowHeights(heights);
+    showAt(list, 12);
+
+    source.move(2, 30); // From above the view to below its top
+    CHECK(list.firstVisibleRow == 11);
+    CHECK(stillAt(list, "row 12"));
+
+    source.move(40, 0); // From below to above
+    CHECK(list.firstVisibleRow == 12);
+    CHECK(stillAt(list, "row 12"));
+
+    source.move(0, 5); // Both above: nothing on screen moves
+    CHECK(stillAt(list, "row 12"));
+    source.move(20, 35); // Both below
+    CHECK(stillAt(list, "row 12"));
+
+    source.move(14, 12); // Onto the top row's index: it lands above the top row
+    CHECK(stillAt(list, "row 12"));
+
+    source.move(list.firstVisibleRow, 45); // The top row itself: the next row takes its place
+    CHECK(stillAt(list, "row 13"));
+}
+
+int main() {
+    testShiftHelpers();
+    testUniformRows();
+    testVariableRows();
+    testMovedRows();
+    return TEST_RESULT();
+}
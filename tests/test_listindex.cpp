@@ -0,0 +1,230 @@
+// ListIndexView applied edit by edit matches a view rebuilt from scratch, and the
+// notifications it sends are enough for a list to follow along.
+
+#include "sv_ui_listindex.h"
+#include "sv_ui_test.h"
+#include <random>
+
+using namespace SV_UI;
+
+// Replays a view's notifications onto a copy of its rows, the way a ListBox would
+struct Mirror : public ListDataObserver {
+    ListDataSource* view;
+    std::vector<std::string> rows;
+
+    explicit Mirror(ListDataSource* view) : view(view) {
+        view->addObserver(this);
+        onRowsReset();
+    }
+
+    ~Mirror() {
+        view->removeObserver(this);
+    }
+
+    virtual void onRowsInserted(int first, int count) override {
+        for (int i = 0; i < count; ++i) {
+            rows.insert(rows.begin() + first + i, std::string(view->rowText(first + i)));
+        }
+    }
+
+    virtual void onRowsRemoved(int first, int count) override {
+        rows.erase(rows.begin() + first, rows.begin() + first + count);
+    }
+
+    virtual void onRowsUpdated(int first, int count) override {
+        for (int i = first; i < first + count; ++i) {
+            rows[i] = std::string(view->rowText(i));
+        }
+    }
+
+    virtual void onRowMoved(int from, int to) override {
+        std::string text = std::move(rows[from]);
+        rows.erase(rows.begin() + from);
+        rows.insert(rows.begin() + to, std::move(text));
+    }
+
+    virtual void onRowsReset() override {
+        rows.clear();
+        for (int i = 0; i < view->rowCount(); ++i) {
+            rows.push_back(std::string(view->rowText(i)));
+        }
+    }
+};
+
+static std::vector<std::string> rowsOf(const ListDataSource& source) {
+    std::vector<std::string> rows;
+    for (int i = 0; i < source.rowCount(); ++i) {
+        rows.push_back(std::string(source.rowText(i)));
+    }
+    return rows;
+}
+
+// Short words over a small alphabet, so there are plenty of ties and shared prefixes
+static std::string randomWord(std::mt19937& random) {
+    static const char letters[] = "abAB";
+    std::string word;
+    int length = 1 + static_cast<int>(random() % 4);
+    for (int i = 0; i < length; ++i) {
+        word += letters[random() % 4];
+    }
+    return word;
+}
+
+struct Setup {
+    SortOrder sort;
+    bool byLength; // compareRows instead of the text order
+    FilterMode mode;
+    const char* query;
+    bool prebuildKeys; // Build keyIndex up front so edits must maintain it
+};
+
+static void configure(ListIndexView& view, const Setup& setup, const VectorListSource& source) {
+    if (setup.prebuildKeys) {
+        view.ensureKeyIndex();
+    }
+    std::function<bool(int, int)> compare;
+    if (setup.byLength) {
+        compare = [&source](int a, int b) { return source.items[a].size() < source.items[b].size(); };
+    }
+    view.setSort(setup.sort, compare);
+    view.setFilterMode(setup.mode);
+    view.setQuery(setup.query);
+}
+
+static void testAgainstRebuild(const Setup& setup, unsigned seed) {
+    std::mt19937 random(seed);
+    VectorListSource source;
+    for (int i = 0; i < 40; ++i) {
+        source.items.push_back(randomWord(random));
+    }
+    ListIndexView view(&source);
+    view.bulkEditThreshold = 3;
+    configure(view, setup, source);
+    if (setup.prebuildKeys && setup.mode == FilterMode::Substring) {
+        view.ensureKeyIndex();
+    }
+    Mirror mirror(&view);
+
+    for (int step = 0; step < 400; ++step) {
+        int size = source.rowCount();
+        int action = static_cast<int>(random() % 6);
+        if (action == 0 || size < 5) {
+            source.insert(static_cast<int>(random() % (size + 1)), randomWord(random));
+        }
+        else if (action == 1) {
+            // Several rows at once, sometimes past the bulk threshold
+            int count = 1 + static_cast<int>(random() % 5);
+            int first = static_cast<int>(random() % (size + 1));
+            for (int i = 0; i < count; ++i) {
+                source.items.insert(source.items.begin() + first + i, randomWord(random));
+            }
+            source.notifyInserted(first, count);
+        }
+        else if (action == 2) {
+            int count = 1 + static_cast<int>(random() % std::min(5, size));
+            source.remove(static_cast<int>(random() % (size - count + 1)), count);
+        }
+        else if (action == 3) {
+            source.set(static_cast<int>(random() % size), randomWord(random));
+        }
+        else if (action == 4) {
+            int count = 1 + static_cast<int>(random() % std::min(2, size));
+            int first = static_cast<int>(random() % (size - count + 1));
+            for (int i = first; i < first + count; ++i) {
+                source.items[i] = randomWord(random);
+            }
+            source.notifyUpdated(first, count);
+        }
+        else {
+            source.move(static_cast<int>(random() % size), static_cast<int>(random() % size));
+        }
+
+        ListIndexView fresh(&source);
+        configure(fresh, setup, source);
+        std::vector<std::string> expected = rowsOf(fresh);
+        std::vector<std::string> actual = rowsOf(view);
+        CHECK(actual == expected);
+        CHECK(mirror.rows == expected);
+        if (actual != expected || mirror.rows != expected) {
+            std::fprintf(stderr, "  sort %d, mode %d, query \"%s\", seed %u, step %d\n",
+                static_cast<int>(setup.sort), static_cast<int>(setup.mode), setup.query, seed, step);
+            return;
+        }
+        for (int row = 0; row < view.rowCount(); ++row) {
+            CHECK(view.rowForKey(view.rowKey(row)) == row);
+        }
+    }
+}
+
+// A row's key keeps finding it while other rows come and go
+static void testKeysFollowRows() {
+    VectorListSource source(std::vector<std::string>{ "delta", "alpha", "charlie", "bravo" });
+    ListIndexView view(&source);
+    view.setSort(SortOrder::Ascending);
+    int key = view.rowKey(2); // charlie
+    CHECK(view.rowText(2) == "charlie");
+
+    source.insert(0, "echo");
+    source.insert(0, "aardvark");
+    source.remove(2);
+    source.move(0, 3);
+    int row = view.rowForKey(key);
+    CHECK(row >= 0 && view.rowText(row) == "charlie");
+
+    view.setFilterMode(FilterMode::Substring);
+    view.setQuery("ar");
+    row = view.rowForKey(key);
+    CHECK(row >= 0 && view.rowText(row) == "charlie");
+    view.setQuery("zz");
+    CHECK(view.rowForKey(key) == -1);
+}
+
+static void testRowSequence() {
+    RowSequence sequence;
+    sequence.reserveHandles(200);
+    std::vector<int> expected;
+    std::mt19937 random(7);
+    for (int handle = 0; handle < 200; ++handle) {
+        int position = static_cast<int>(random() % (expected.size() + 1));
+        sequence.insert(position, handle);
+        expected.insert(expected.begin() + position, handle);
+    }
+    for (int i = 0; i < 100; ++i) {
+        int position = static_cast<int>(random() % expected.size());
+        sequence.erase(expected[position]);
+        expected.erase(expected.begin() + position);
+    }
+    CHECK(sequence.toVector() == expected);
+    bool positionsMatch = true;
+    for (int i = 0; i < static_cast<int>(expected.size()); ++i) {
+        positionsMatch = positionsMatch && sequence.at(i) == expected[i] && sequence.positionOf(expected[i]) == i;
+    }
+    CHECK(positionsMatch);
+
+    sequence.assign(expected);
+    CHECK(sequence.toVector() == expected);
+    CHECK(sequence.positionOf(expected.back()) == static_cast<int>(expected.size()) - 1);
+}
+
+int main() {
+    testRowSequence();
+    testKeysFollowRows();
+
+    const Setup setups[] = {
+        { SortOrder::None, false, FilterMode::Substring, "", false },
+        { SortOrder::Ascending, false, FilterMode::Substring, "", false },
+        { SortOrder::Descending, false, FilterMode::Substring, "", true },
+        { SortOrder::Ascending, true, FilterMode::Substring, "", false },
+        { SortOrder::None, false, FilterMode::Substring, "a", false },
+        { SortOrder::Ascending, false, FilterMode::Substring, "ab", true },
+        { SortOrder::Descending, false, FilterMode::Prefix, "a", false },
+        { SortOrder::Ascending, false, FilterMode::Prefix, "b", false },
+        { SortOrder::None, false, FilterMode::Prefix, "ab", false },
+        { SortOrder::Descending, true, FilterMode::Prefix, "a", false },
+    };
+    unsigned seed = 1;
+    for (const Setup& setup : setups) {
+        testAgainstRebuild(setup, seed++);
+    }
+    return TEST_RESULT();
+}
@@ -0,0 +1,96 @@
+// The min/max pyramid answers every range in the ring like a scan of the samples,
+// across ring wraps, oversized batches and clear().
+
+#include "sv_ui_plot.h"
+#include "sv_ui_test.h"
+#include <random>
+
+using namespace SV_UI;
+
+// Everything ever appended; the series keeps the tail
+static std::vector<float> history;
+
+static bool matchesScan(const PlotSeries& series, uint64_t begin, uint64_t end) {
+    float lo, hi;
+    bool found = series.extremes(begin, end, lo, hi);
+    if (begin >= end) {
+        return !found;
+    }
+    float scanLo = history[begin], scanHi = history[begin];
+    for (uint64_t i = begin; i < end; ++i) {
+        scanLo = std::min(scanLo, history[i]);
+        scanHi = std::max(scanHi, history[i]);
+    }
+    return found && lo == scanLo && hi == scanHi;
+}
+
+static void append(PlotSeries& series, std::mt19937& random, size_t count) {
+    std::vector<float> batch(count);
+    for (float& value : batch) {
+        value = static_cast<float>(static_cast<int>(random() % 20001) - 10000);
+    }
+    history.insert(history.end(), batch.begin(), batch.end());
+    series.append(batch.data(), batch.size());
+}
+
+static void testAgainstScan(size_t capacity, unsigned seed) {
+    std::mt19937 random(seed);
+    PlotSeries series("test", capacity, 0xffffffff, &ui());
+    history.clear();
+    for (int step = 0; step < 300; ++step) {
+        int action = static_cast<int>(random() % 10);
+        if (action == 0) {
+            append(series, random, series.capacity() + random() % 100); // More than fits
+        }
+        else if (action < 4) {
+            append(series, random, 1);
+        }
+        else {
+            append(series, random, random() % 700);
+        }
+        CHECK(series.total == history.size());
+        uint64_t first = series.first(), total = series.total;
+        CHECK(matchesScan(series, first, total));
+        for (int query = 0; query < 20; ++query) {
+            uint64_t a = first + random() % (total - first + 1), b = first + random() % (total - first + 1);
+            if (!matchesScan(series, std::min(a, b), std::max(a, b))) {
+                CHECK(false);
+                std::fprintf(stderr, "  capacity %zu, seed %u, step %d, range [%llu, %llu)\n", capacity, seed, step,
+                    static_cast<unsigned long long>(std::min(a, b)), static_cast<unsigned long long>(std::max(a, b)));
+                return;
+            }
+        }
+    }
+}
+
+static void testClear() {
+    std::mt19937 random(9);
+    PlotSeries series("test", 1000, 0xffffffff, &ui());
+    history.clear();
+    append(series, random, 5000);
+    series.clear();
+    CHECK(series.total == 0 && series.first() == 0);
+    history.clear();
+    append(series, random, 3000);
+    CHECK(matchesScan(series, series.first(), series.total));
+    CHECK(matchesScan(series, series.first() + 5, series.total - 70));
+}
+
+static void testMinMax8() {
+    float lo[8] = { 3, -1, 4, 1, -5, 9, 2, 6 };
+    float hi[8] = { 3, 1, 4, 1, 5, 9, 2, -6 };
+    float outLo, outHi;
+    plotMinMax8(lo, hi, outLo, outHi);
+    CHECK(outLo == -5.0f && outHi == 9.0f);
+}
+
+int main() {
+    testMinMax8();
+    testClear();
+    const size_t capacities[] = { 8, 64, 100, 512, 4097 };
+    unsigned seed = 1;
+    for (size_t capacity : capacities) {
+        testAgainstScan(capacity, seed++);
+    }
+    return TEST_RESULT();
+}
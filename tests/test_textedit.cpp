@@ -0,0 +1,142 @@
+// LineWidths kept up to date edit by edit gives the same prefix widths as summing
+// the line's advances from scratch, wherever the edits land relative to its line.
+
+#include "sv_ui_textedit.h"
+#include "sv_ui_test.h"
+#include <random>
+
+using namespace SV_UI;
+
+// Synthetic advances, no glyphs measured: distinct enough that a misplaced byte shows
+static uint32_t advances[256];
+
+static uint32_t bruteWidth(const GapBuffer& buffer, size_t start, size_t pos) {
+    uint32_t width = 0;
+    for (size_t i = start; i < pos; ++i) {
+        width += advances[static_cast<unsigned char>(buffer.at(i))];
+    }
+    return width;
+}
+
+static bool matchesBrute(const LineWidths& widths, const GapBuffer& buffer, const LineIndex& lines) {
+    size_t start = lines.lineStart(widths.line), end = lines.lineEnd(widths.line);
+    if (widths.start != start || widths.end() != end) {
+        return false;
+    }
+    for (size_t pos = start; pos <= end; ++pos) {
+        if (widths.widthTo(pos) != bruteWidth(buffer, start, pos)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The same steps as TextEditComponent::replace(): the cache first, then the buffer
+static void replace(LineWidths& widths, GapBuffer& buffer, LineIndex& lines, size_t pos, size_t length, const std::string& text) {
+    size_t line = lines.lineOf(pos);
+    bool newlinesChanged = lines.lineOf(pos + length) != line || text.find('\n') != std::string::npos;
+    if (newlinesChanged) {
+        widths.line = NO_LINE;
+    }
+    else if (widths.line == line) {
+        widths.erase(pos, length, buffer, advances);
+        widths.insert(pos, text.data(), text.size(), buffer, advances);
+    }
+    else if (widths.line != NO_LINE && widths.line > line) {
+        widths.start += text.size() - length;
+        widths.split += text.size() - length;
+    }
+    if (length) {
+        buffer.erase(pos, length);
+        lines.erase(pos, length);
+    }
+    if (!text.empty()) {
+        buffer.insert(pos, text.data(), text.size());
+        lines.insert(pos, text.data(), text.size());
+    }
+}
+
+static std::string randomText(std::mt19937& random, bool newlines) {
+    static const char letters[] = "aiMW. \xc3\xa9\n";
+    std::string text;
+    int length = static_cast<int>(random() % 5);
+    for (int i = 0; i < length; ++i) {
+        text += letters[random() % (newlines ? 9 : 8)];
+    }
+    return text;
+}
+
+static void testAgainstBrute(unsigned seed) {
+    std::mt19937 random(seed);
+    for (int c = 0; c < 256; ++c) {
+        advances[c] = 3 + c % 11;
+    }
+    std::string initial;
+    for (int i = 0; i < 200; ++i) {
+        initial += randomText(random, true);
+    }
+    GapBuffer buffer;
+    buffer.assign(initial.data(), initial.size());
+    LineIndex lines;
+    lines.build(buffer);
+    LineWidths widths;
+
+    for (int step = 0; step < 2000; ++step) {
+        if (widths.line == NO_LINE || random() % 20 == 0) {
+            // The caret moved to another line
+            size_t line = random() % lines.lineCount();
+            widths.build(line, lines.lineStart(line), lines.lineEnd(line), buffer, advances);
+        }
+        size_t pos, length;
+        if (random() % 2) {
+            // On the cached line, where typing happens
+            size_t start = lines.lineStart(widths.line), end = lines.lineEnd(widths.line);
+            pos = start + random() % (end - start + 1);
+            length = std::min<size_t>(random() % 3, end - pos);
+        }
+        else {
+            pos = random() % (buffer.size() + 1);
+            length = std::min<size_t>(random() % 3, buffer.size() - pos);
+        }
+        replace(widths, buffer, lines, pos, length, randomText(random, random() % 10 == 0));
+        if (widths.line != NO_LINE && !matchesBrute(widths, buffer, lines)) {
+            CHECK(false);
+            std::fprintf(stderr, "  seed %u, step %d\n", seed, step);
+            return;
+        }
+    }
+}
+
+// Typing, then moving the edit point back and forth along the line
+static void testMoveSplit() {
+    for (int c = 0; c < 256; ++c) {
+        advances[c] = 1 + c % 7;
+    }
+    GapBuffer buffer;
+    std::string text = "first\nsecond line\nthird";
+    buffer.assign(text.data(), text.size());
+    LineIndex lines;
+    lines.build(buffer);
+    LineWidths widths;
+    widths.build(1, lines.lineStart(1), lines.lineEnd(1), buffer, advances);
+    CHECK(widths.total() == bruteWidth(buffer, lines.lineStart(1), lines.lineEnd(1)));
+
+    replace(widths, buffer, lines, 9, 0, "xyz");
+    replace(widths, buffer, lines, 16, 1, "");
+    replace(widths, buffer, lines, 6, 0, "<");
+    replace(widths, buffer, lines, 0, 2, "F"); // Line 0 shrinks: the cache shifts
+    CHECK(widths.line == 1);
+    CHECK(matchesBrute(widths, buffer, lines));
+    replace(widths, buffer, lines, buffer.size(), 0, "!"); // Below the cached line
+    CHECK(matchesBrute(widths, buffer, lines));
+    replace(widths, buffer, lines, 8, 0, "\n");
+    CHECK(widths.line == NO_LINE);
+}
+
+int main() {
+    testMoveSplit();
+    for (unsigned seed = 1; seed <= 4; ++seed) {
+        testAgainstBrute(seed);
+    }
+    return TEST_RESULT();
+}